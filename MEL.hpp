@@ -35,6 +35,15 @@ SOFTWARE.
 #include <iostream>
 #include <chrono>
 #include <thread>
+#include <type_traits>
+#include <algorithm>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#if defined(MEL_PROFILE) || defined(MEL_TRACE)
+#include <map>
+#endif
 
 /**
 * \file MEL.hpp
@@ -108,6 +117,10 @@ namespace MEL {
      * \defgroup Mutex Mutex
      * An implementation of Mutex Semantics between MPI processes. Based loosely off of Andreas Prell's mpi_mutex.c (https://gist.github.com/aprell/1486197) and R. Thakur, R. Ross, and R. Latham, "Implementing Byte-Range Locks Using MPI One-Sided Communication," in Proc. of the 12th European PVM/MPI Users' Group Meeting (Euro PVM/MPI 2005), Recent Advances in Parallel Virtual Machine and Message Passing Interface, Lecture Notes in Computer Science, LNCS 3666, Springer, September 2005, pp. 119-128.
      *
+     * \defgroup Profile Profiling
+     * Opt-in (compile with MEL_PROFILE defined) per-operation, per-communicator call counts, bytes and wall time, reported at Finalize.
+     * Opt-in (compile with MEL_TRACE defined) per-call timeline of every rank, written as a Chrome trace JSON file at Finalize
+     *
      * \defgroup Shared Shared Arrays
      * A simple shared array implementation using Mutex locks and RMA one-sided communication
      */
@@ -123,11 +136,373 @@ namespace MEL {
     typedef MPI_Count  Count;
 #endif
 
+#if defined(MEL_PROFILE) || defined(MEL_TRACE)
+    namespace Profile {
+
+        /// \cond HIDE
+        struct Pending {
+            std::string comm;
+            unsigned long long bytes;
+            int tag;
+            bool set;
+
+            Pending() : bytes(0), tag(-1), set(false) {};
+        };
+
+        inline std::mutex& TableMutex() {
+            static std::mutex mutex;
+            return mutex;
+        };
+
+        inline Pending& PendingNote() {
+            static thread_local Pending pending;
+            return pending;
+        };
+
+        inline std::string CommLabel(const MPI_Comm &comm) {
+            if (comm == MPI_COMM_NULL) return "-";
+
+            static std::map<MPI_Comm, std::string> labels;
+            std::lock_guard<std::mutex> lock(TableMutex());
+            auto it = labels.find(comm);
+            if (it != labels.end()) return it->second;
+
+            char name[MPI_MAX_OBJECT_NAME];
+            int len = 0, size = 0;
+            MPI_Comm_get_name(comm, name, &len);
+            MPI_Comm_size(comm, &size);
+            std::string label = (len > 0) ? std::string(name, len) : std::string("comm");
+            label += "(" + std::to_string(size) + ")";
+            labels[comm] = label;
+            return label;
+        };
+        /// \endcond
+
+        /**
+         * \ingroup Profile
+         * Attributes a communicator and payload size to the next profiled MEL call on this thread
+         *
+         * \param[in] comm			The communicator the call operates on, or MPI_COMM_NULL for files and windows
+         * \param[in] num			The number of elements moved by the call
+         * \param[in] datatype		The datatype of the elements
+         * \param[in] tag			The message tag for point-2-point calls, or -1
+         */
+        inline void Note(const MPI_Comm &comm, const long long num, const MPI_Datatype &datatype, const int tag = -1) {
+            int size = 0;
+            if (datatype != MPI_DATATYPE_NULL) MPI_Type_size(datatype, &size);
+
+            Pending &pending = PendingNote();
+            pending.comm  = CommLabel(comm);
+            pending.bytes = (num > 0) ? (unsigned long long) num * (unsigned long long) size : 0;
+            pending.tag   = tag;
+            pending.set   = true;
+        };
+
+#ifdef MEL_PROFILE
+        /**
+         * \ingroup Profile
+         * Accumulated statistics for a single operation on a single communicator on the local rank
+         */
+        struct Entry {
+            unsigned long long count, bytes;
+            double time;
+
+            Entry() : count(0), bytes(0), time(0.0) {};
+        };
+
+        /// \cond HIDE
+        inline std::map<std::string, Entry>& Table() {
+            static std::map<std::string, Entry> table;
+            return table;
+        };
+        /// \endcond
+
+        /**
+         * \ingroup Profile
+         * Discards all statistics recorded so far on the local rank
+         */
+        inline void Reset() {
+            std::lock_guard<std::mutex> lock(TableMutex());
+            Table().clear();
+        };
+
+        /**
+         * \ingroup Profile
+         * Collective over MPI_COMM_WORLD. Gathers every rank's statistics to rank 0 and prints the min / mean / max 
+         * across ranks of the bytes moved and time spent in each operation. Called automatically by MEL::Finalize
+         *
+         * \param[in] out			The stream rank 0 writes the report to
+         */
+        inline void Report(FILE *out = stdout) {
+            int rank, size;
+            MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+            MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+            /// Serialize the local table as tab separated lines
+            std::string local;
+            {
+                std::lock_guard<std::mutex> lock(TableMutex());
+                for (const auto &it : Table()) {
+                    local += it.first + "\t" + std::to_string(it.second.count) + "\t" 
+                           + std::to_string(it.second.bytes) + "\t" + std::to_string(it.second.time) + "\n";
+                }
+            }
+
+            int len = (int) local.size();
+            std::vector<int> lens(size), displs(size);
+            MPI_Gather(&len, 1, MPI_INT, &lens[0], 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+            int total = 0;
+            for (int i = 0; i < size; ++i) {
+                displs[i] = total;
+                total += lens[i];
+            }
+            std::vector<char> all(total + 1, 0);
+            MPI_Gatherv(&local[0], len, MPI_CHAR, &all[0], &lens[0], &displs[0], MPI_CHAR, 0, MPI_COMM_WORLD);
+
+            if (rank != 0) return;
+
+            /// Per key, the statistics of every rank (ranks that never made the call stay at zero)
+            std::map<std::string, std::vector<Entry>> merged;
+            for (int r = 0; r < size; ++r) {
+                const std::string block(&all[displs[r]], lens[r]);
+                size_t pos = 0;
+                while (pos < block.size()) {
+                    size_t end = block.find('\n', pos);
+                    if (end == std::string::npos) end = block.size();
+                    const std::string line = block.substr(pos, end - pos);
+                    pos = end + 1;
+
+                    const size_t t0 = line.find('\t'), t1 = line.find('\t', t0 + 1), t2 = line.find('\t', t1 + 1);
+                    if (t2 == std::string::npos) continue;
+
+                    std::vector<Entry> &entries = merged[line.substr(0, t0)];
+                    if (entries.empty()) entries.resize(size);
+                    Entry &entry = entries[r];
+                    entry.count = std::stoull(line.substr(t0 + 1, t1 - t0 - 1));
+                    entry.bytes = std::stoull(line.substr(t1 + 1, t2 - t1 - 1));
+                    entry.time  = std::stod(line.substr(t2 + 1));
+                }
+            }
+
+            struct Row {
+                std::string key;
+                int ranks;
+                unsigned long long count, minBytes, maxBytes;
+                double meanBytes, minTime, meanTime, maxTime;
+            };
+            std::vector<Row> rows;
+            for (const auto &it : merged) {
+                Row row = { it.first, 0, 0, ~0ULL, 0, 0.0, 1e300, 0.0, 0.0 };
+                for (const Entry &e : it.second) {
+                    if (e.count > 0) ++row.ranks;
+                    row.count     += e.count;
+                    row.minBytes   = std::min(row.minBytes, e.bytes);
+                    row.maxBytes   = std::max(row.maxBytes, e.bytes);
+                    row.meanBytes += (double) e.bytes;
+                    row.minTime    = std::min(row.minTime, e.time);
+                    row.maxTime    = std::max(row.maxTime, e.time);
+                    row.meanTime  += e.time;
+                }
+                row.meanBytes /= (double) size;
+                row.meanTime  /= (double) size;
+                rows.push_back(row);
+            }
+            std::sort(rows.begin(), rows.end(), [](const Row &a, const Row &b) { return a.maxTime > b.maxTime; });
+
+            fprintf(out, "\n*** MEL::PROFILE *** %d ranks (min / mean / max across ranks)\n", size);
+            fprintf(out, "%12s %6s %14s %14s %14s %12s %12s %12s  %s\n", 
+                    "calls", "ranks", "bytes min", "bytes mean", "bytes max", "time min", "time mean", "time max", "operation @ comm");
+            for (const Row &row : rows) {
+                fprintf(out, "%12llu %6d %14llu %14.0f %14llu %12.6f %12.6f %12.6f  %s\n", 
+                        row.count, row.ranks, row.minBytes, row.meanBytes, row.maxBytes, 
+                        row.minTime, row.meanTime, row.maxTime, row.key.c_str());
+            }
+            fflush(out);
+        };
+#endif
+
+#ifdef MEL_TRACE
+        /**
+         * \ingroup Profile
+         * A single traced MEL call, timestamped with MPI_Wtime
+         */
+        struct Event {
+            const char *name;
+            double begin, end;
+            std::string comm;
+            unsigned long long bytes;
+            int tag;
+        };
+
+        /// \cond HIDE
+        inline std::vector<Event>& Events() {
+            static std::vector<Event> events;
+            return events;
+        };
+
+        /// Events are only recorded between MPI_Init and the trace being written at Finalize
+        enum class TraceState { WAITING, ACTIVE, WRITTEN };
+
+        inline TraceState& TraceStatus() {
+            static TraceState state = TraceState::WAITING;
+            return state;
+        };
+
+        inline bool TraceEnabled() {
+            TraceState &state = TraceStatus();
+            if (state == TraceState::WAITING) {
+                int init = 0;
+                MPI_Initialized(&init);
+                if (init != 0) state = TraceState::ACTIVE;
+            }
+            return state == TraceState::ACTIVE;
+        };
+
+        inline std::string JSONEscape(const std::string &str) {
+            std::string out;
+            for (const char c : str) {
+                if (c == '"' || c == '\\') out += '\\';
+                out += c;
+            }
+            return out;
+        };
+        /// \endcond
+
+        /**
+         * \ingroup Profile
+         * Collective over MPI_COMM_WORLD. Writes every rank's recorded events into a single Chrome trace 
+         * (chrome://tracing, https://ui.perfetto.dev) JSON file, one process lane per rank. Each rank
+         * serializes its own events and writes them at an offset found by an exclusive scan, so the trace 
+         * is never gathered onto a single rank. Timestamps are relative to the earliest event of any rank.
+         * Called automatically by MEL::Finalize, after which tracing stops
+         *
+         * \see MPI_File_write_at_all, MPI_Exscan
+         *
+         * \param[in] path			The path of the trace file to write
+         */
+        inline void WriteTrace(const std::string &path) {
+            int rank, size;
+            MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+            MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+            std::vector<Event> events;
+            {
+                std::lock_guard<std::mutex> lock(TableMutex());
+                events.swap(Events());
+                TraceStatus() = TraceState::WRITTEN;
+            }
+
+            double origin = events.empty() ? 1e300 : events.front().begin, globalOrigin;
+            for (const Event &e : events) origin = std::min(origin, e.begin);
+            MPI_Allreduce(&origin, &globalOrigin, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+
+            std::string local = (rank == 0) ? "{\"traceEvents\":[\n" : ",\n";
+            local += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" + std::to_string(rank) 
+                   + ",\"tid\":0,\"args\":{\"name\":\"Rank " + std::to_string(rank) + "\"}}";
+
+            char line[64];
+            for (const Event &e : events) {
+                snprintf(line, sizeof(line), "%.3f,\"dur\":%.3f", (e.begin - globalOrigin) * 1e6, (e.end - e.begin) * 1e6);
+                local += ",\n{\"name\":\"" + JSONEscape(e.name) + "\",\"ph\":\"X\",\"pid\":" + std::to_string(rank) 
+                       + ",\"tid\":0,\"ts\":" + line + ",\"args\":{\"rank\":" + std::to_string(rank) 
+                       + ",\"comm\":\"" + JSONEscape(e.comm) + "\",\"bytes\":" + std::to_string(e.bytes)
+                       + ",\"tag\":" + std::to_string(e.tag) + "}}";
+            }
+            if (rank == size - 1) local += "\n]}\n";
+
+            long long len = (long long) local.size(), offset = 0;
+            MPI_Exscan(&len, &offset, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+            if (rank == 0) offset = 0;
+
+            MPI_File file;
+            if (rank == 0) MPI_File_delete(path.c_str(), MPI_INFO_NULL);
+            MPI_Barrier(MPI_COMM_WORLD);
+            if (MPI_File_open(MPI_COMM_WORLD, path.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &file) != MPI_SUCCESS) {
+                if (rank == 0) fprintf(stderr, "MEL::Profile::WriteTrace : Could not open %s\n", path.c_str());
+                return;
+            }
+            MPI_Status status;
+            MPI_File_write_at_all(file, (MPI_Offset) offset, &local[0], (int) len, MPI_CHAR, &status);
+            MPI_File_close(&file);
+        };
+#endif
+
+        /**
+         * \ingroup Profile
+         * Times a single MEL call and records it against its operation name when it leaves scope
+         */
+        class Scope {
+        private:
+            const char *name;
+#ifdef MEL_PROFILE
+            std::chrono::steady_clock::time_point start;
+#endif
+#ifdef MEL_TRACE
+            double begin;
+            bool traced;
+#endif
+
+        public:
+            explicit Scope(const char *_name) : name(_name) {
+#ifdef MEL_TRACE
+                traced = TraceEnabled();
+                begin  = traced ? MPI_Wtime() : 0.0;
+#endif
+#ifdef MEL_PROFILE
+                start  = std::chrono::steady_clock::now();
+#endif
+            };
+
+            ~Scope() {
+#ifdef MEL_PROFILE
+                const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+#endif
+#ifdef MEL_TRACE
+                const double end = traced ? MPI_Wtime() : 0.0;
+#endif
+                Pending &pending = PendingNote();
+                const std::string comm = pending.set ? pending.comm : std::string("-");
+
+                {
+                    std::lock_guard<std::mutex> lock(TableMutex());
+#ifdef MEL_PROFILE
+                    Entry &entry = Table()[std::string(name) + " @ " + comm];
+                    ++entry.count;
+                    entry.bytes += pending.bytes;
+                    entry.time  += elapsed;
+#endif
+#ifdef MEL_TRACE
+                    if (traced && TraceStatus() == TraceState::ACTIVE) Events().push_back({ name, begin, end, comm, pending.bytes, pending.tag });
+#endif
+                }
+
+                pending.bytes = 0;
+                pending.tag   = -1;
+                pending.set   = false;
+            };
+        };
+    };
+
+    /// Macros to attach the profiler / tracer to MEL calls
+#define MEL_PROFILE_SCOPE(message) MEL::Profile::Scope _mel_profile_scope(message);
+#define MEL_PROFILE_NOTE(comm, num, datatype) MEL::Profile::Note((comm), (num), (datatype))
+#define MEL_PROFILE_NOTE_TAG(comm, num, datatype, tag) MEL::Profile::Note((comm), (num), (datatype), (tag))
+#else
+#define MEL_PROFILE_SCOPE(message)
+#define MEL_PROFILE_NOTE(comm, num, datatype)
+#define MEL_PROFILE_NOTE_TAG(comm, num, datatype, tag)
+#endif
+
+#ifndef MEL_TRACE_FILE
+#define MEL_TRACE_FILE "MEL-trace.json"
+#endif
+
     /// Macro to help with return error codes
 #ifndef MEL_NO_CHECK_ERROR_CODES
-#define MEL_THROW(v, message) { int ierr = (v); if ((ierr) != MPI_SUCCESS) MEL::Abort((ierr), std::string(message)); }
+#define MEL_THROW(v, message) { MEL_PROFILE_SCOPE(message) int ierr = (v); if ((ierr) != MPI_SUCCESS) MEL::Abort((ierr), std::string(message)); }
 #else
-#define MEL_THROW(v, message) { (v); }
+#define MEL_THROW(v, message) { MEL_PROFILE_SCOPE(message) (v); }
 #endif
 
     /**
@@ -212,6 +587,12 @@ namespace MEL {
      */
     inline void Finalize() {
         if (!IsFinalized()) {
+#ifdef MEL_PROFILE
+            MEL::Profile::Report();
+#endif
+#ifdef MEL_TRACE
+            MEL::Profile::WriteTrace(MEL_TRACE_FILE);
+#endif
             MEL_THROW( MPI_Finalize(), "Finalize");
         }
     };
@@ -763,6 +1144,21 @@ namespace MEL {
         Comm out_comm = CommIduplicate(comm, rq);
         return std::make_pair(out_comm, rq);
     };
+
+    /**
+     * \ingroup Comm
+     * Split a comm world into seperate comms, one per shared memory node. Rank order within each node comm follows rank order in comm
+     *
+     * \see MPI_Comm_split_type
+     *
+     * \param[in] comm		The comm world to split
+     * \return			Returns a new comm world containing the processes that share memory with this process
+     */
+    inline Comm CommSplitShared(const Comm &comm) {
+        MPI_Comm out_comm;
+        MEL_THROW( MPI_Comm_split_type((MPI_Comm) comm, MPI_COMM_TYPE_SHARED, CommRank(comm), MPI_INFO_NULL, &out_comm), "Comm::SplitShared" );
+        return Comm(out_comm);
+    };
 #endif
     
     /**
@@ -873,6 +1269,7 @@ namespace MEL {
      * \param[in] comm		The comm world to synchronize
      */
     inline void Barrier(const Comm &comm) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, 0, MPI_DATATYPE_NULL);
         MEL_THROW( MPI_Barrier((MPI_Comm) comm), "Comm::Barrier" );
     };
 
@@ -888,6 +1285,7 @@ namespace MEL {
      * \param[out] rq		A reference to a request object used to determine when the barrier has been reached by all processes in comm
      */
     inline void Ibarrier(const Comm &comm, Request &rq) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, 0, MPI_DATATYPE_NULL);
         MEL_THROW( MPI_Ibarrier((MPI_Comm) comm, (MPI_Request*) &rq), "Comm::IBarrier" );
     };
     
@@ -1959,29 +2357,743 @@ namespace MEL {
         }
     };
 
-    /**
-     * \ingroup Datatype 
-     * Free a vector datatypes
-     * 
-     * \param[in] datatypes	A std::vector of derived datatypes
-     */
-    inline void TypeFree(std::vector<Datatype> &datatypes) {
-        for (auto &d : datatypes) TypeFree(d);
+    /**
+     * \ingroup Datatype 
+     * Free a vector datatypes
+     * 
+     * \param[in] datatypes	A std::vector of derived datatypes
+     */
+    inline void TypeFree(std::vector<Datatype> &datatypes) {
+        for (auto &d : datatypes) TypeFree(d);
+    };
+    
+    /**
+     * \ingroup Datatype 
+     * Free the varadic set of datatypes provided
+     * 
+     * \param[in] d0		The first datatype to free
+     * \param[in] d1		The second datatype to free
+     * \param[in] args		The varadic set of remaining datatypes to free
+     */
+    template<typename T0, typename T1, typename ...Args>
+    inline void TypeFree(T0 &d0, T1 &d1, Args &&...args) {
+        TypeFree(d0);
+        TypeFree(d1, args...);
+    };
+
+    /**
+     * \ingroup Datatype
+     * Hit, miss and eviction counts for the datatype cache on this process
+     */
+    struct TypeCacheStats {
+        long long hits, misses, evictions;
+
+        TypeCacheStats() : hits(0), misses(0), evictions(0) {};
+    };
+
+    /// \cond HIDE
+    namespace TypeCache {
+        typedef std::vector<long long> Key;
+
+        struct KeyHash {
+            inline size_t operator()(const Key &key) const {
+                size_t h = 14695981039346656037ULL;
+                for (const long long k : key) h = (h ^ std::hash<long long>()(k)) * 1099511628211ULL;
+                return h;
+            };
+        };
+
+        struct Entry {
+            Key                       key;
+            Datatype                  datatype;
+            /// Handles returned by TypeCacheCreate* and not yet released
+            int                       refs;
+            /// Cached types this type was built from, held for as long as this entry lives
+            std::vector<MPI_Datatype> bases;
+        };
+
+        typedef std::list<Entry>::iterator Iter;
+
+        struct Cache {
+            std::mutex                                 mutex;
+            /// Most recently used at the front
+            std::list<Entry>                           lru;
+            std::unordered_map<Key, Iter, KeyHash>     byKey;
+            std::unordered_map<MPI_Datatype, Iter>     byHandle;
+            int                                        capacity;
+            TypeCacheStats                             stats;
+
+            Cache() : capacity(256) {};
+        };
+
+        inline Cache& Get() {
+            static Cache cache;
+            return cache;
+        };
+
+        inline long long Handle(const MPI_Datatype &datatype) {
+            long long h = 0;
+            std::memcpy(&h, &datatype, std::min(sizeof(h), sizeof(MPI_Datatype)));
+            return h;
+        };
+
+        /// Append how datatype was built, recursing into the types it was built from. Returns true for a predefined type
+        inline bool AppendContents(Key &key, const MPI_Datatype &datatype) {
+            int ni, na, nd, combiner;
+            MEL_THROW( MPI_Type_get_envelope(datatype, &ni, &na, &nd, &combiner), "Datatype::TypeCache::GetEnvelope" );
+            key.push_back(combiner);
+            if (combiner == MPI_COMBINER_NAMED) {
+                key.push_back(Handle(datatype));
+                return true;
+            }
+
+            std::vector<int>          ints(ni);
+            std::vector<MPI_Aint>     aints(na);
+            std::vector<MPI_Datatype> types(nd);
+            MEL_THROW( MPI_Type_get_contents(datatype, ni, na, nd, ints.data(), aints.data(), types.data()), "Datatype::TypeCache::GetContents" );
+            key.push_back(ni);
+            key.insert(key.end(), ints.begin(), ints.end());
+            key.push_back(na);
+            key.insert(key.end(), aints.begin(), aints.end());
+            key.push_back(nd);
+            for (MPI_Datatype &t : types) {
+                if (!AppendContents(key, t)) MPI_Type_free(&t);
+            }
+            return false;
+        };
+
+        /// Append a base type to key. Predefined and cached types are identified by handle, as neither can be freed while the
+        /// entries built on them live. Any other type is identified by its contents, so a freed handle reused for a different 
+        /// type cannot return a stale entry
+        inline void AppendBase(Key &key, const Datatype &datatype) {
+            int ni, na, nd, combiner;
+            MEL_THROW( MPI_Type_get_envelope(datatype.datatype, &ni, &na, &nd, &combiner), "Datatype::TypeCache::GetEnvelope" );
+            bool stable = (combiner == MPI_COMBINER_NAMED);
+            if (!stable) {
+                Cache &cache = Get();
+                std::lock_guard<std::mutex> lock(cache.mutex);
+                stable = cache.byHandle.find(datatype.datatype) != cache.byHandle.end();
+            }
+            if (stable) {
+                key.push_back(-1);
+                key.push_back(Handle(datatype.datatype));
+                return;
+            }
+            key.push_back(-2);
+            AppendContents(key, datatype.datatype);
+        };
+
+        /// Called with the mutex held. Free one entry and drop its references on its bases, queueing any base it released
+        inline void Erase(Cache &cache, Iter it, std::vector<MPI_Datatype> &released) {
+            for (const MPI_Datatype b : it->bases) {
+                auto base = cache.byHandle.find(b);
+                if (base != cache.byHandle.end() && --base->second->refs <= 0) released.push_back(b);
+            }
+            cache.byKey.erase(it->key);
+            cache.byHandle.erase(it->datatype.datatype);
+            MPI_Type_free(&it->datatype.datatype);
+            cache.lru.erase(it);
+            ++cache.stats.evictions;
+        };
+
+        /// Called with the mutex held. Free unreferenced entries, least recently used first, until the cache fits its capacity.
+        /// Bases released along the way may lie behind the walk, so they are freed after it rather than restarting it
+        inline void Evict(Cache &cache, const int capacity) {
+            std::vector<MPI_Datatype> released;
+            auto it = cache.lru.end();
+            while ((int) cache.lru.size() > capacity && it != cache.lru.begin()) {
+                Iter victim = --it;
+                if (victim->refs > 0) continue;
+                ++it;
+                Erase(cache, victim, released);
+            }
+            for (size_t i = 0; i < released.size() && (int) cache.lru.size() > capacity; ++i) {
+                auto base = cache.byHandle.find(released[i]);
+                if (base != cache.byHandle.end() && base->second->refs <= 0) Erase(cache, base->second, released);
+            }
+        };
+
+        inline int DeleteFn(MPI_Comm, int, void*, void*) {
+            Cache &cache = Get();
+            std::lock_guard<std::mutex> lock(cache.mutex);
+            for (auto &entry : cache.lru) MPI_Type_free(&entry.datatype.datatype);
+            cache.lru.clear();
+            cache.byKey.clear();
+            cache.byHandle.clear();
+            return MPI_SUCCESS;
+        };
+
+        /// MPI_Finalize deletes the attributes on MPI_COMM_SELF first, which frees every cached type while MPI is still usable
+        inline void RegisterFinalize() {
+            static bool registered = false;
+            if (registered) return;
+            int keyval;
+            MEL_THROW( MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN, DeleteFn, &keyval, nullptr), "Datatype::TypeCache::CreateKeyval" );
+            MEL_THROW( MPI_Comm_set_attr(MPI_COMM_SELF, keyval, nullptr), "Datatype::TypeCache::SetAttr" );
+            registered = true;
+        };
+
+        /// Called with the mutex held. Take a reference on the entry for key if there is one
+        inline bool Hit(Cache &cache, const Key &key, Datatype &datatype) {
+            auto found = cache.byKey.find(key);
+            if (found == cache.byKey.end()) return false;
+            Iter it = found->second;
+            ++it->refs;
+            cache.lru.splice(cache.lru.begin(), cache.lru, it);
+            datatype = it->datatype;
+            return true;
+        };
+
+        /// Return the cached type for key, calling create on a miss. bases lists the types create builds on
+        template<typename F>
+        inline Datatype Lookup(Key &&key, const std::vector<Datatype> &bases, F create) {
+            Cache &cache = Get();
+            Datatype datatype;
+            {
+                std::lock_guard<std::mutex> lock(cache.mutex);
+                if (Hit(cache, key, datatype)) {
+                    ++cache.stats.hits;
+                    return datatype;
+                }
+                ++cache.stats.misses;
+                RegisterFinalize();
+            }
+
+            /// Create without the lock held, as create may itself look up cached types
+            datatype = create();
+
+            std::lock_guard<std::mutex> lock(cache.mutex);
+            Datatype raced;
+            if (Hit(cache, key, raced)) {
+                MPI_Type_free(&datatype.datatype);
+                return raced;
+            }
+            cache.lru.push_front(Entry{ std::move(key), datatype, 1, {} });
+            Iter it = cache.lru.begin();
+            for (const Datatype &b : bases) {
+                auto base = cache.byHandle.find(b.datatype);
+                if (base == cache.byHandle.end()) continue;
+                ++base->second->refs;
+                it->bases.push_back(b.datatype);
+            }
+            cache.byKey[it->key] = it;
+            cache.byHandle[it->datatype.datatype] = it;
+            Evict(cache, cache.capacity);
+            return it->datatype;
+        };
+    };
+    /// \endcond
+
+    /**
+     * \ingroup Datatype
+     * Set the maximum number of datatypes held by the cache. Types that are still in use are never evicted, so the cache
+     * may briefly hold more. The default capacity is 256
+     *
+     * \param[in] capacity		The maximum number of cached types
+     */
+    inline void TypeCacheSetCapacity(const int capacity) {
+        TypeCache::Cache &cache = TypeCache::Get();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        cache.capacity = std::max(0, capacity);
+        TypeCache::Evict(cache, cache.capacity);
+    };
+
+    /**
+     * \ingroup Datatype
+     * Free every cached datatype that is not currently in use
+     *
+     * \see MPI_Type_free
+     */
+    inline void TypeCacheClear() {
+        TypeCache::Cache &cache = TypeCache::Get();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        TypeCache::Evict(cache, 0);
+    };
+
+    /**
+     * \ingroup Datatype
+     * Get the hit, miss and eviction counts of the datatype cache
+     *
+     * \return				Returns a copy of the counts
+     */
+    inline TypeCacheStats TypeCacheGetStats() {
+        TypeCache::Cache &cache = TypeCache::Get();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        return cache.stats;
+    };
+
+    /**
+     * \ingroup Datatype
+     * Test whether a datatype is a handle returned by one of the TypeCacheCreate functions that has not been released as
+     * many times as it was returned, and so may be passed to TypeCacheRelease
+     *
+     * \param[in] datatype		The datatype to test
+     * \return				Returns true if datatype holds a reference on a cached type
+     */
+    inline bool TypeCacheOwns(const Datatype &datatype) {
+        TypeCache::Cache &cache = TypeCache::Get();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        auto found = cache.byHandle.find(datatype.datatype);
+        return found != cache.byHandle.end() && found->second->refs > 0;
+    };
+
+    /**
+     * \ingroup Datatype
+     * Release a datatype returned by one of the TypeCacheCreate functions. The type stays cached until it is evicted, and
+     * must not be passed to TypeFree
+     *
+     * \param[in] datatype		The datatype to release. Set to DATATYPE_NULL on return
+     */
+    inline void TypeCacheRelease(Datatype &datatype) {
+        if (datatype == MEL::Datatype::DATATYPE_NULL) return;
+        TypeCache::Cache &cache = TypeCache::Get();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        auto found = cache.byHandle.find(datatype.datatype);
+        if (found == cache.byHandle.end() || found->second->refs <= 0) MEL::Exit(-1, "MEL::TypeCacheRelease datatype was not created by the datatype cache.");
+        --found->second->refs;
+        datatype = Datatype::DATATYPE_NULL;
+        TypeCache::Evict(cache, cache.capacity);
+    };
+
+    /**
+     * \ingroup Datatype
+     * Release the varadic set of cached datatypes provided
+     *
+     * \param[in] d0		The first datatype to release
+     * \param[in] d1		The second datatype to release
+     * \param[in] args		The varadic set of remaining datatypes to release
+     */
+    template<typename T0, typename T1, typename ...Args>
+    inline void TypeCacheRelease(T0 &d0, T1 &d1, Args &&...args) {
+        TypeCacheRelease(d0);
+        TypeCacheRelease(d1, args...);
+    };
+
+    /**
+     * \ingroup Datatype
+     * Get a committed contiguous type from the datatype cache, creating it on first use. Each call must be matched by a
+     * TypeCacheRelease
+     *
+     * \see TypeCreateContiguous
+     *
+     * \param[in] datatype	The base type to use
+     * \param[in] length	The number of elements in the new type
+     * \return			Returns the cached type
+     */
+    inline Datatype TypeCacheCreateContiguous(const Datatype &datatype, const int length) {
+        TypeCache::Key key { 0 };
+        TypeCache::AppendBase(key, datatype);
+        key.push_back(length);
+        return TypeCache::Lookup(std::move(key), { datatype }, [&] { 
+            return TypeCreateContiguous(datatype, length); 
+        });
+    };
+
+    /**
+     * \ingroup Datatype
+     * Get a committed sub array type from the datatype cache, creating it on first use. Each call must be matched by a
+     * TypeCacheRelease
+     *
+     * \see TypeCreateSubArray
+     *
+     * \param[in] datatype		The datatype of the parent array
+     * \param[in] num			The number of dimensions of the data
+     * \param[in] starts		Pointer to an array of start indices
+     * \param[in] subSizes		Pointer to an array of sub sizes
+     * \param[in] sizes			Pointer to an array of sizes of the parent array
+     * \return				Returns the cached type
+     */
+    inline Datatype TypeCacheCreateSubArray(const Datatype &datatype, const int num, const int *starts, const int *subSizes, const int *sizes) {
+        TypeCache::Key key { 1 };
+        TypeCache::AppendBase(key, datatype);
+        key.push_back(num);
+        for (int i = 0; i < num; ++i) {
+            key.push_back(starts[i]);
+            key.push_back(subSizes[i]);
+            key.push_back(sizes[i]);
+        }
+        return TypeCache::Lookup(std::move(key), { datatype }, [&] { 
+            return TypeCreateSubArray(datatype, num, starts, subSizes, sizes); 
+        });
+    };
+
+    /**
+     * \ingroup Datatype
+     * Get a committed 1D sub array type from the datatype cache, creating it on first use
+     *
+     * \see TypeCreateSubArray1D
+     *
+     * \param[in] datatype		The datatype of the parent array
+     * \param[in] x				The start index in the x dimension
+     * \param[in] sx			The sub size in the x dimension
+     * \param[in] dx			The parent size in the x dimension
+     * \return				Returns the cached type
+     */
+    inline Datatype TypeCacheCreateSubArray1D(const Datatype &datatype, const int x, const int sx, const int dx) {
+        return TypeCacheCreateSubArray(datatype, 1, &x, &sx, &dx);
+    };
+
+    /**
+     * \ingroup Datatype
+     * Get a committed 2D sub array type from the datatype cache, creating it on first use
+     *
+     * \see TypeCreateSubArray2D
+     *
+     * \param[in] datatype		The datatype of the parent array
+     * \param[in] x				The start index in the x dimension
+     * \param[in] y				The start index in the y dimension
+     * \param[in] sx			The sub size in the x dimension
+     * \param[in] sy			The sub size in the y dimension
+     * \param[in] dx			The parent size in the x dimension
+     * \param[in] dy			The parent size in the y dimension
+     * \return				Returns the cached type
+     */
+    inline Datatype TypeCacheCreateSubArray2D(const Datatype &datatype,
+                                              const int x,    const int y,
+                                              const int sx,   const int sy,
+                                              const int dx,   const int dy) {
+        int starts[2]   { y,     x  };
+        int subSizes[2] { sy,    sx };
+        int sizes[2]    { dy,    dx };
+        return TypeCacheCreateSubArray(datatype, 2, starts, subSizes, sizes);
+    };
+
+    /**
+     * \ingroup Datatype
+     * Get a committed 3D sub array type from the datatype cache, creating it on first use
+     *
+     * \see TypeCreateSubArray3D
+     *
+     * \param[in] datatype		The datatype of the parent array
+     * \param[in] x				The start index in the x dimension
+     * \param[in] y				The start index in the y dimension
+     * \param[in] z				The start index in the z dimension
+     * \param[in] sx			The sub size in the x dimension
+     * \param[in] sy			The sub size in the y dimension
+     * \param[in] sz			The sub size in the z dimension
+     * \param[in] dx			The parent size in the x dimension
+     * \param[in] dy			The parent size in the y dimension
+     * \param[in] dz			The parent size in the z dimension
+     * \return				Returns the cached type
+     */
+    inline Datatype TypeCacheCreateSubArray3D(const Datatype &datatype,
+                                              const int x,  const int y,  const int z,
+                                              const int sx, const int sy, const int sz,
+                                              const int dx, const int dy, const int dz) {
+        int starts[3]   {  z,     y,         x };
+        int subSizes[3] { sz,    sy,        sx };
+        int sizes[3]    { dz,    dy,        dx };
+        return TypeCacheCreateSubArray(datatype, 3, starts, subSizes, sizes);
+    };
+
+    /**
+     * \ingroup Datatype
+     * Get a committed vector type from the datatype cache, creating it on first use
+     *
+     * \see TypeCreateVector
+     *
+     * \param[in] datatype		The datatype of the elements
+     * \param[in] num			The number of blocks
+     * \param[in] length		The number of elements in each block
+     * \param[in] stride		The number of elements between the start of each block
+     * \return				Returns the cached type
+     */
+    inline Datatype TypeCacheCreateVector(const Datatype &datatype, const int num, const int length, const int stride) {
+        TypeCache::Key key { 2 };
+        TypeCache::AppendBase(key, datatype);
+        key.insert(key.end(), { num, length, stride });
+        return TypeCache::Lookup(std::move(key), { datatype }, [&] { 
+            return TypeCreateVector(datatype, num, length, stride); 
+        });
+    };
+
+    /**
+     * \ingroup Datatype
+     * Get a committed hvector type from the datatype cache, creating it on first use
+     *
+     * \see TypeCreateHVector
+     *
+     * \param[in] datatype		The datatype of the elements
+     * \param[in] num			The number of blocks
+     * \param[in] length		The number of elements in each block
+     * \param[in] stride		The number of bytes between the start of each block
+     * \return				Returns the cached type
+     */
+    inline Datatype TypeCacheCreateHVector(const Datatype &datatype, const int num, const int length, const Aint stride) {
+        TypeCache::Key key { 3 };
+        TypeCache::AppendBase(key, datatype);
+        key.insert(key.end(), { num, length, (long long) stride });
+        return TypeCache::Lookup(std::move(key), { datatype }, [&] { 
+            return TypeCreateHVector(datatype, num, length, stride); 
+        });
+    };
+
+    /**
+     * \ingroup Datatype
+     * Get a committed indexed type from the datatype cache, creating it on first use
+     *
+     * \see TypeCreateIndexed
+     *
+     * \param[in] datatype		The datatype of the elements
+     * \param[in] num			The number of blocks
+     * \param[in] lengths		Pointer to an array of block lengths
+     * \param[in] displs		Pointer to an array of block displacements in elements
+     * \return				Returns the cached type
+     */
+    inline Datatype TypeCacheCreateIndexed(const Datatype &datatype, const int num, const int *lengths, const int *displs) {
+        TypeCache::Key key { 4 };
+        TypeCache::AppendBase(key, datatype);
+        key.push_back(num);
+        for (int i = 0; i < num; ++i) {
+            key.push_back(lengths[i]);
+            key.push_back(displs[i]);
+        }
+        return TypeCache::Lookup(std::move(key), { datatype }, [&] { 
+            return TypeCreateIndexed(datatype, num, lengths, displs); 
+        });
+    };
+
+    /**
+     * \ingroup Datatype
+     * Get a committed struct type from the datatype cache, creating it on first use
+     *
+     * \see TypeCreateStruct
+     *
+     * \param[in] num			The number of members within the struct
+     * \param[in] datatypes		Pointer to an array of datatypes
+     * \param[in] blockLengths	Pointer to an array of block lengths
+     * \param[in] offsets		Pointer to an array of offsets
+     * \return				Returns the cached type
+     */
+    inline Datatype TypeCacheCreateStruct(const int num, const Datatype *datatypes, const int *blockLengths, const Aint *offsets) {
+        TypeCache::Key key { 5, num };
+        for (int i = 0; i < num; ++i) {
+            TypeCache::AppendBase(key, datatypes[i]);
+            key.push_back(blockLengths[i]);
+            key.push_back((long long) offsets[i]);
+        }
+        return TypeCache::Lookup(std::move(key), std::vector<Datatype>(datatypes, datatypes + num), [&] { 
+            return TypeCreateStruct(num, datatypes, blockLengths, offsets); 
+        });
+    };
+
+    /**
+     * \ingroup Datatype
+     * Get a committed struct type from the datatype cache, creating it on first use
+     *
+     * \see TypeCreateStruct
+     *
+     * \param[in] blocks		A std::vector of triples representing the size of the current member block
+     * \return				Returns the cached type
+     */
+    inline Datatype TypeCacheCreateStruct(const std::vector<TypeStruct_Block> &blocks) {
+        const int num = blocks.size();
+        std::vector<Datatype>    datatypes(num);
+        std::vector<int>        blockLengths(num);
+        std::vector<Aint>        offsets(num);
+
+        for (int i = 0; i < num; ++i) {
+            datatypes[i]        = blocks[i].datatype;
+            blockLengths[i]     = blocks[i].length;
+            offsets[i]          = blocks[i].offset;
+        }
+        return TypeCacheCreateStruct(num, &datatypes[0], &blockLengths[0], &offsets[0]);
+    };
+
+    /**
+     * \ingroup Datatype
+     * Field list of a struct, used by TypeOf to build an exact MPI struct type for it. Specialised by MEL_TYPE_FIELDS, 
+     * which must be used at global scope after the struct is defined and before it is first communicated
+     *
+     * \code
+     * struct Particle { double pos[3], vel[3]; int id; };
+     * MEL_TYPE_FIELDS(Particle, pos, vel, id)
+     * \endcode
+     */
+    template<typename T>
+    struct TypeFields {
+        static constexpr bool registered = false;
+    };
+
+    /// \cond HIDE
+#define MEL_FIELD_EXPAND(x) x
+#define MEL_FIELD_CAT_(a, b) a##b
+#define MEL_FIELD_CAT(a, b) MEL_FIELD_CAT_(a, b)
+#define MEL_FIELD_COUNT_N(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, N, ...) N
+#define MEL_FIELD_COUNT(...) MEL_FIELD_EXPAND(MEL_FIELD_COUNT_N(__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1))
+
+#define MEL_FIELD_1(T, a)       f(&T::a);
+#define MEL_FIELD_2(T, a, ...)  f(&T::a); MEL_FIELD_EXPAND(MEL_FIELD_1(T, __VA_ARGS__))
+#define MEL_FIELD_3(T, a, ...)  f(&T::a); MEL_FIELD_EXPAND(MEL_FIELD_2(T, __VA_ARGS__))
+#define MEL_FIELD_4(T, a, ...)  f(&T::a); MEL_FIELD_EXPAND(MEL_FIELD_3(T, __VA_ARGS__))
+#define MEL_FIELD_5(T, a, ...)  f(&T::a); MEL_FIELD_EXPAND(MEL_FIELD_4(T, __VA_ARGS__))
+#define MEL_FIELD_6(T, a, ...)  f(&T::a); MEL_FIELD_EXPAND(MEL_FIELD_5(T, __VA_ARGS__))
+#define MEL_FIELD_7(T, a, ...)  f(&T::a); MEL_FIELD_EXPAND(MEL_FIELD_6(T, __VA_ARGS__))
+#define MEL_FIELD_8(T, a, ...)  f(&T::a); MEL_FIELD_EXPAND(MEL_FIELD_7(T, __VA_ARGS__))
+#define MEL_FIELD_9(T, a, ...)  f(&T::a); MEL_FIELD_EXPAND(MEL_FIELD_8(T, __VA_ARGS__))
+#define MEL_FIELD_10(T, a, ...) f(&T::a); MEL_FIELD_EXPAND(MEL_FIELD_9(T, __VA_ARGS__))
+#define MEL_FIELD_11(T, a, ...) f(&T::a); MEL_FIELD_EXPAND(MEL_FIELD_10(T, __VA_ARGS__))
+#define MEL_FIELD_12(T, a, ...) f(&T::a); MEL_FIELD_EXPAND(MEL_FIELD_11(T, __VA_ARGS__))
+#define MEL_FIELD_13(T, a, ...) f(&T::a); MEL_FIELD_EXPAND(MEL_FIELD_12(T, __VA_ARGS__))
+#define MEL_FIELD_14(T, a, ...) f(&T::a); MEL_FIELD_EXPAND(MEL_FIELD_13(T, __VA_ARGS__))
+#define MEL_FIELD_15(T, a, ...) f(&T::a); MEL_FIELD_EXPAND(MEL_FIELD_14(T, __VA_ARGS__))
+#define MEL_FIELD_16(T, a, ...) f(&T::a); MEL_FIELD_EXPAND(MEL_FIELD_15(T, __VA_ARGS__))
+    /// \endcond
+
+    /**
+     * \ingroup Datatype
+     * Register up to 16 members of a trivially copyable struct T so that TypeOf<T>() and the typed communication templates 
+     * use an exact MPI struct type for it. Members must be arithmetic, enums, std::complex (MEL_3), registered structs, or 
+     * fixed size arrays of these. Padding and members left out of the list between the first and last registered member 
+     * are not communicated
+     */
+#define MEL_TYPE_FIELDS(T, ...)                                                                                     \
+    namespace MEL {                                                                                                 \
+        template<> struct TypeFields<T> {                                                                           \
+            static_assert(std::is_trivially_copyable<T>::value, "MEL_TYPE_FIELDS requires a trivially copyable type");\
+            static constexpr bool registered = true;                                                                \
+            template<typename F> static inline void visit(F &f) {                                                   \
+                MEL_FIELD_EXPAND(MEL_FIELD_CAT(MEL_FIELD_, MEL_FIELD_COUNT(__VA_ARGS__))(T, __VA_ARGS__))           \
+            }                                                                                                       \
+        };                                                                                                          \
+    }
+
+    /// \cond HIDE
+    template<typename T, typename Enable = void>
+    struct TypeOf_Impl {
+        static constexpr bool defined = false;
+    };
+
+#define MEL_TYPEOF(T, D) template<> struct TypeOf_Impl<T> {                                                        \
+        static constexpr bool defined = true;                                                                       \
+        static inline Datatype get() { return Datatype(D); }                                                        \
+    };
+
+    MEL_TYPEOF(char,                        MPI_CHAR);
+    MEL_TYPEOF(signed char,                 MPI_SIGNED_CHAR);
+    MEL_TYPEOF(unsigned char,               MPI_UNSIGNED_CHAR);
+    MEL_TYPEOF(wchar_t,                     MPI_WCHAR);
+
+    MEL_TYPEOF(short,                       MPI_SHORT);
+    MEL_TYPEOF(int,                         MPI_INT);
+    MEL_TYPEOF(long,                        MPI_LONG);
+    MEL_TYPEOF(long long,                   MPI_LONG_LONG);
+
+    MEL_TYPEOF(unsigned short,              MPI_UNSIGNED_SHORT);
+    MEL_TYPEOF(unsigned int,                MPI_UNSIGNED);
+    MEL_TYPEOF(unsigned long,               MPI_UNSIGNED_LONG);
+    MEL_TYPEOF(unsigned long long,          MPI_UNSIGNED_LONG_LONG);
+
+    MEL_TYPEOF(float,                       MPI_FLOAT);
+    MEL_TYPEOF(double,                      MPI_DOUBLE);
+    MEL_TYPEOF(long double,                 MPI_LONG_DOUBLE);
+
+#ifdef MEL_3
+    MEL_TYPEOF(std::complex<float>,         MPI_CXX_FLOAT_COMPLEX);
+    MEL_TYPEOF(std::complex<double>,        MPI_CXX_DOUBLE_COMPLEX);
+    MEL_TYPEOF(std::complex<long double>,   MPI_CXX_LONG_DOUBLE_COMPLEX);
+    MEL_TYPEOF(bool,                        MPI_CXX_BOOL);
+#endif
+#undef MEL_TYPEOF
+
+    template<typename T>
+    struct TypeOf_Impl<T, typename std::enable_if<std::is_enum<T>::value>::type> : TypeOf_Impl<typename std::underlying_type<T>::type> {};
+
+    template<typename T>
+    struct TypeOf_Impl<T, typename std::enable_if<TypeFields<T>::registered>::type>;
+    /// \endcond
+
+    /**
+     * \ingroup Datatype
+     * Get the MPI datatype matching T. Registered structs are built on first use and held in the datatype cache for the 
+     * rest of the program, so the returned type must not be freed
+     *
+     * \return				Returns the datatype of T
+     */
+    template<typename T>
+    inline Datatype TypeOf() {
+        static_assert(TypeOf_Impl<T>::defined, "MEL::TypeOf<T> T must be a basic type or registered with MEL_TYPE_FIELDS");
+        return TypeOf_Impl<T>::get();
+    };
+
+    /// \cond HIDE
+    template<typename T>
+    struct TypeFields_Collect {
+        std::vector<TypeStruct_Block> &blocks;
+
+        template<typename M>
+        inline void operator()(M T::*member) {
+            typedef typename std::remove_all_extents<M>::type E;
+            /// Offset of the member within T, taken from uninitialised storage since T need not be default constructible
+            alignas(T) char storage[sizeof(T)];
+            const T *obj = reinterpret_cast<const T*>(storage);
+            const Aint offset = (Aint) ((const char*) &(obj->*member) - storage);
+            blocks.push_back(TypeStruct_Block(TypeOf<E>(), (int) (sizeof(M) / sizeof(E)), offset));
+        };
+    };
+
+    template<typename T>
+    struct TypeOf_Impl<T, typename std::enable_if<TypeFields<T>::registered>::type> {
+        static constexpr bool defined = true;
+
+        static inline Datatype create() {
+            std::vector<TypeStruct_Block> blocks;
+            TypeFields_Collect<T> collect{ blocks };
+            TypeFields<T>::visit(collect);
+
+            /// Interior padding is skipped, but any bytes before the first or after the last member are kept so the true
+            /// extent covers all of T. Reductions through OpCreate assign whole elements of T into buffers MPI sizes from it
+            Aint lb = sizeof(T), ub = 0;
+            for (const auto &b : blocks) {
+                lb = std::min(lb, b.offset);
+                ub = std::max(ub, b.offset + b.length * TypeGetExtent(b.datatype));
+            }
+            if (lb > 0)                 blocks.push_back(TypeStruct_Block(MEL::Datatype::UNSIGNED_CHAR, (int) lb, 0));
+            if (ub < (Aint) sizeof(T))  blocks.push_back(TypeStruct_Block(MEL::Datatype::UNSIGNED_CHAR, (int) (sizeof(T) - ub), ub));
+
+            /// Resize so the extent is exactly sizeof(T) and arrays of T stride correctly
+            Datatype packed = TypeCreateStruct(blocks), dt;
+            MEL_THROW( MPI_Type_create_resized((MPI_Datatype) packed, 0, sizeof(T), (MPI_Datatype*) &dt), "Datatype::TypeResized" );
+            MEL_THROW( MPI_Type_commit((MPI_Datatype*) &dt), "Datatype::TypeCommit(TypeResized)" );
+            TypeFree(packed);
+            return dt;
+        };
+
+        static inline Datatype get() {
+            /// Held by the cache for the life of the program, and freed by it during MPI_Finalize
+            static const char tag = 0;
+            static const Datatype datatype = TypeCache::Lookup({ 6, (long long) (intptr_t) &tag }, {}, create);
+            return datatype;
+        };
+    };
+
+    template<typename T>
+    inline Datatype TypeElement(std::true_type) {
+        return TypeOf<T>();
+    };
+    template<typename T>
+    inline Datatype TypeElement(std::false_type) {
+        return MEL::Datatype::CHAR;
+    };
+    template<typename T>
+    inline int TypeElements(const int num, std::true_type) {
+        return num;
+    };
+    template<typename T>
+    inline int TypeElements(const int num, std::false_type) {
+        return num * sizeof(T);
+    };
+
+    /// Registered structs are sent as num elements of their struct type, anything else as num * sizeof(T) bytes
+    template<typename T>
+    inline Datatype TypeElement() {
+        return TypeElement<T>(std::integral_constant<bool, TypeFields<T>::registered>());
     };
-    
-    /**
-     * \ingroup Datatype 
-     * Free the varadic set of datatypes provided
-     * 
-     * \param[in] d0		The first datatype to free
-     * \param[in] d1		The second datatype to free
-     * \param[in] args		The varadic set of remaining datatypes to free
-     */
-    template<typename T0, typename T1, typename ...Args>
-    inline void TypeFree(T0 &d0, T1 &d1, Args &&...args) {
-        TypeFree(d0);
-        TypeFree(d1, args...);
+    template<typename T>
+    inline int TypeElements(const int num) {
+        return TypeElements<T>(num, std::integral_constant<bool, TypeFields<T>::registered>());
     };
+    /// \endcond
 
     /**
      * \ingroup Topo 
@@ -2580,6 +3692,156 @@ namespace MEL {
         void ARRAY_OP_FUNC(T *in, T *inout, int *len, MPI_Datatype *dptr) {
             F(in, inout, *len, (Datatype) *dptr);
         };
+
+        /**
+         * \ingroup  Ops
+         * Stateless element-wise sum Functor. Unlike SUM it is passed to OpCreate as a type, so it can be inlined and vectorised
+         */
+        template<typename T>
+        struct Sum {
+            inline T operator()(const T &a, const T &b) const {
+                return (a + b);
+            };
+        };
+
+        /**
+         * \ingroup  Ops
+         * Stateless element-wise product Functor. Unlike PROD it is passed to OpCreate as a type, so it can be inlined and vectorised
+         */
+        template<typename T>
+        struct Prod {
+            inline T operator()(const T &a, const T &b) const {
+                return (a * b);
+            };
+        };
+
+        /**
+         * \ingroup  Ops
+         * Stateless element-wise min Functor. Unlike MIN it is passed to OpCreate as a type, so it can be inlined and vectorised
+         */
+        template<typename T>
+        struct Min {
+            inline T operator()(const T &a, const T &b) const {
+                return (a < b) ? a : b;
+            };
+        };
+
+        /**
+         * \ingroup  Ops
+         * Stateless element-wise max Functor. Unlike MAX it is passed to OpCreate as a type, so it can be inlined and vectorised
+         */
+        template<typename T>
+        struct Max {
+            inline T operator()(const T &a, const T &b) const {
+                return (a > b) ? a : b;
+            };
+        };
+
+        /// \cond HIDE
+#if defined(_OPENMP) && (_OPENMP >= 201307)
+#define MEL_SIMD_LOOP _Pragma("omp simd")
+#elif defined(__clang__)
+#define MEL_SIMD_LOOP _Pragma("clang loop vectorize(enable) interleave(enable)")
+#elif defined(__GNUC__)
+#define MEL_SIMD_LOOP _Pragma("GCC ivdep")
+#else
+#define MEL_SIMD_LOOP
+#endif
+
+        /// The single instance of a stateless functor / lambda, copied in by OpCreate before MPI can call the op
+        template<typename T, typename F>
+        inline const F& FunctorInstance(const F *init = nullptr) {
+            static const F instance(*init);
+            return instance;
+        };
+
+        /// Detects functors providing a whole-array kernel f(const T *in, T *inout, int len)
+        template<typename T, typename F>
+        struct IsArrayKernel {
+            template<typename G>
+            static auto test(int) -> decltype(std::declval<const G&>()(std::declval<const T*>(), std::declval<T*>(), 0), std::true_type());
+            template<typename G>
+            static std::false_type test(...);
+
+            static constexpr bool value = decltype(test<F>(0))::value;
+        };
+        /// \endcond
+
+        /**
+         * \ingroup  Ops
+         * Applies an element-wise functor over a whole array. In and inout never alias during a reduction so the loop
+         * is marked as independent, letting the compiler inline the functor and vectorise
+         */
+        template<typename T, typename F>
+        struct ArrayKernel {
+            static inline void apply(const F &f, const T * __restrict in, T * __restrict inout, const int len) {
+                MEL_SIMD_LOOP
+                for (int i = 0; i < len; ++i) inout[i] = f(in[i], inout[i]);
+            };
+        };
+
+#undef MEL_SIMD_LOOP
+
+        /// \cond HIDE
+#if defined(__GNUC__) && !defined(__clang__)
+        /// Explicit 256 bit wide kernels for the builtin functors, using GCC vector extensions. Unaligned loads and stores go through memcpy
+#define MEL_SIMD_KERNEL(T, FUNCTOR, EXPR) template<>                                                                    \
+        struct ArrayKernel<T, FUNCTOR<T>> {                                                                                \
+            static inline void apply(const FUNCTOR<T> &f, const T * __restrict in, T * __restrict inout, const int len) {    \
+                typedef T V __attribute__((vector_size(32)));                                                            \
+                constexpr int W = sizeof(V) / sizeof(T);                                                                \
+                int i = 0;                                                                                                \
+                for (; i + W <= len; i += W) {                                                                            \
+                    V a, b;                                                                                                \
+                    memcpy(&a, in + i, sizeof(V));                                                                        \
+                    memcpy(&b, inout + i, sizeof(V));                                                                    \
+                    b = EXPR;                                                                                            \
+                    memcpy(inout + i, &b, sizeof(V));                                                                    \
+                }                                                                                                        \
+                for (; i < len; ++i) inout[i] = f(in[i], inout[i]);                                                        \
+            };                                                                                                            \
+        };
+
+#define MEL_SIMD_KERNELS(T)                                \
+        MEL_SIMD_KERNEL(T, Sum,  a + b)                    \
+        MEL_SIMD_KERNEL(T, Prod, a * b)                    \
+        MEL_SIMD_KERNEL(T, Min,  (a < b) ? a : b)        \
+        MEL_SIMD_KERNEL(T, Max,  (a > b) ? a : b)
+
+        MEL_SIMD_KERNELS(float)
+        MEL_SIMD_KERNELS(double)
+        MEL_SIMD_KERNELS(int32_t)
+        MEL_SIMD_KERNELS(int64_t)
+
+#undef MEL_SIMD_KERNELS
+#undef MEL_SIMD_KERNEL
+#endif
+
+        template<typename T, typename F>
+        inline void ApplyKernel(const F &f, T *in, T *inout, const int len, std::true_type) {
+            f((const T*) in, inout, len);
+        };
+
+        template<typename T, typename F>
+        inline void ApplyKernel(const F &f, T *in, T *inout, const int len, std::false_type) {
+            ArrayKernel<T, F>::apply(f, in, inout, len);
+        };
+        /// \endcond
+
+        /**
+         * \ingroup  Ops
+         * Maps the given stateless functor type to the local array of a reduction / accumulate operation. The functor is 
+         * either element-wise, T f(const T &a, const T &b), or a whole-array kernel, void f(const T *in, T *inout, int len)
+         *
+         * \param[in] in		The left hand array for the reduction
+         * \param[in] inout		The right hand array for the reduction. This array is modified to reflect the result of the functor on each element
+         * \param[in] len		Pointer to a single int representing the number of elements to be processed
+         * \param[in] dptr		Pointer to a single derived datatype representing the data to be processed
+         */
+        template<typename T, typename F>
+        void ARRAY_KERNEL_FUNC(T *in, T *inout, int *len, MPI_Datatype *dptr) {
+            ApplyKernel<T, F>(FunctorInstance<T, F>(), in, inout, *len, std::integral_constant<bool, IsArrayKernel<T, F>::value>());
+        };
     };
 
     /**
@@ -2662,6 +3924,42 @@ namespace MEL {
         return Op(op);
     };
 
+    /**
+     * \ingroup Ops 
+     * Create a derived operation from a stateless functor or lambda. The functor is called directly rather than through 
+     * a function pointer, so element-wise functors are inlined into a vectorisable loop. Functors may instead provide a 
+     * whole-array kernel void(const T *in, T *inout, int len)
+     *
+     * \see MPI_Op_create
+     *
+     * \param[in] func		The stateless functor or captureless lambda. Only one instance per type is kept
+     * \param[in] commute	Is the operation commutative?
+     * \return			Returns a handle to a new Op
+     */
+    template<typename T, typename F>
+    inline Op OpCreate(const F &func, bool commute = true) {
+        static_assert(std::is_empty<F>::value, "MEL::OpCreate(func) requires a stateless functor or captureless lambda");
+        Functor::FunctorInstance<T, F>(&func);
+        MPI_Op op;
+        MEL_THROW( MPI_Op_create((void(*)(void*, void*, int*, MPI_Datatype*)) Functor::ARRAY_KERNEL_FUNC<T, F>, commute, (MPI_Op*) &op), "Op::CreatOp" );
+        return Op(op);
+    };
+
+    /**
+     * \ingroup Ops 
+     * Create a derived operation from a stateless, default constructible functor type, such as MEL::Functor::Sum<T>. 
+     * The builtin Sum / Prod / Min / Max functors have explicitly vectorised kernels for float, double, int32_t and int64_t
+     *
+     * \see MPI_Op_create
+     *
+     * \param[in] commute	Is the operation commutative?
+     * \return			Returns a handle to a new Op
+     */
+    template<typename T, typename F>
+    inline Op OpCreate(bool commute = true) {
+        return OpCreate<T>(F(), commute);
+    };
+
     /**
      * \ingroup Ops 
      * Free a derived operation
@@ -3154,6 +4452,7 @@ namespace MEL {
      */
     inline Status FileWrite(const File &file, const void *sptr, const int snum, const Datatype &datatype) {
         MPI_Status status;
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, snum, (MPI_Datatype) datatype);
         MEL_THROW( MPI_File_write(file, sptr, snum, (MPI_Datatype) datatype, &status), "File::Write" );
         return status;
     };
@@ -3172,6 +4471,7 @@ namespace MEL {
      */
     inline Status FileWriteAll(const File &file, const void *sptr, const int snum, const Datatype &datatype) {
         MPI_Status status;
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, snum, (MPI_Datatype) datatype);
         MEL_THROW( MPI_File_write_all(file, sptr, snum, (MPI_Datatype) datatype, &status), "File::WriteAll" );
         return status;
     };
@@ -3191,6 +4491,7 @@ namespace MEL {
      */
     inline Status FileWriteAt(const File &file, const Offset offset, const void *sptr, const int snum, const Datatype &datatype) {
         MPI_Status status;
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, snum, (MPI_Datatype) datatype);
         MEL_THROW( MPI_File_write_at(file, offset, sptr, snum, (MPI_Datatype) datatype, &status), "File::WriteAt" );
         return status;
     };
@@ -3210,6 +4511,7 @@ namespace MEL {
      */
     inline Status FileWriteAtAll(const File &file, const Offset offset, const void *sptr, const int snum, const Datatype &datatype) {
         MPI_Status status;
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, snum, (MPI_Datatype) datatype);
         MEL_THROW( MPI_File_write_at_all(file, offset, sptr, snum, (MPI_Datatype) datatype, &status), "File::WriteAtAll" );
         return status;
     };
@@ -3228,6 +4530,7 @@ namespace MEL {
      */
     inline Status FileWriteOrdered(const File &file, const void *sptr, const int snum, const Datatype &datatype) {
         MPI_Status status;
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, snum, (MPI_Datatype) datatype);
         MEL_THROW( MPI_File_write_ordered(file, sptr, snum, (MPI_Datatype) datatype, &status), "File::WriteOrdered" );
         return status;
     };
@@ -3246,6 +4549,7 @@ namespace MEL {
      */
     inline Status FileWriteShared(const File &file, const void *sptr, const int snum, const Datatype &datatype) {
         MPI_Status status;
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, snum, (MPI_Datatype) datatype);
         MEL_THROW( MPI_File_write_shared(file, sptr, snum, (MPI_Datatype) datatype, &status), "File::WriteShared" );
         return status;
     };
@@ -3264,6 +4568,7 @@ namespace MEL {
      */
     inline Request FileIwrite(const File &file, const void *sptr, const int snum, const Datatype &datatype) {
         MPI_Request request;
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, snum, (MPI_Datatype) datatype);
         MEL_THROW( MPI_File_iwrite(file, sptr, snum, (MPI_Datatype) datatype, &request), "File::Iwrite" );
         return Request(request);
     };
@@ -3283,6 +4588,7 @@ namespace MEL {
      */
     inline Request FileIwriteAt(const File &file, const Offset offset, const void *sptr, const int snum, const Datatype &datatype) {
         MPI_Request request;
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, snum, (MPI_Datatype) datatype);
         MEL_THROW(MPI_File_iwrite_at(file, offset, sptr, snum, (MPI_Datatype) datatype, &request), "File::IwriteAt");
         return Request(request);
     };
@@ -3301,6 +4607,7 @@ namespace MEL {
      */
     inline Request FileIwriteShared(const File &file, const void *sptr, const int snum, const Datatype &datatype) {
         MPI_Request request;
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, snum, (MPI_Datatype) datatype);
         MEL_THROW( MPI_File_iwrite_shared(file, sptr, snum, (MPI_Datatype) datatype, &request), "File::IwriteShared" );
         return Request(request);
     };
@@ -3319,6 +4626,7 @@ namespace MEL {
      */
     inline Status FileRead(const File &file, void *rptr, const int rnum, const Datatype &datatype) {
         MPI_Status status;
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, rnum, (MPI_Datatype) datatype);
         MEL_THROW( MPI_File_read(file, rptr, rnum, (MPI_Datatype) datatype, &status), "File::Read" );
         return status;
     };
@@ -3337,6 +4645,7 @@ namespace MEL {
      */
     inline Status FileReadAll(const File &file, void *rptr, const int rnum, const Datatype &datatype) {
         MPI_Status status;
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, rnum, (MPI_Datatype) datatype);
         MEL_THROW( MPI_File_read_all(file, rptr, rnum, (MPI_Datatype) datatype, &status), "File::ReadAll" );
         return status;
     };
@@ -3356,6 +4665,7 @@ namespace MEL {
      */
     inline Status FileReadAt(const File &file, const Offset offset, void *rptr, const int rnum, const Datatype &datatype) {
         MPI_Status status;
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, rnum, (MPI_Datatype) datatype);
         MEL_THROW( MPI_File_read_at(file, offset, rptr, rnum, (MPI_Datatype) datatype, &status), "File::ReadAt" );
         return status;
     };
@@ -3375,6 +4685,7 @@ namespace MEL {
      */
     inline Status FileReadAtAll(const File &file, const Offset offset, void *rptr, const int rnum, const Datatype &datatype) {
         MPI_Status status;
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, rnum, (MPI_Datatype) datatype);
         MEL_THROW( MPI_File_read_at_all(file, offset, rptr, rnum, (MPI_Datatype) datatype, &status), "File::ReadAtAll" );
         return status;
     };
@@ -3393,6 +4704,7 @@ namespace MEL {
      */
     inline Status FileReadOrdered(const File &file, void *rptr, const int rnum, const Datatype &datatype) {
         MPI_Status status;
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, rnum, (MPI_Datatype) datatype);
         MEL_THROW( MPI_File_read_ordered(file, rptr, rnum, (MPI_Datatype) datatype, &status), "File::ReadOrdered" );
         return status;
     };
@@ -3411,6 +4723,7 @@ namespace MEL {
      */
     inline Status FileReadShared(const File &file, void *rptr, const int rnum, const Datatype &datatype) {
         MPI_Status status;
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, rnum, (MPI_Datatype) datatype);
         MEL_THROW( MPI_File_read_shared(file, rptr, rnum, (MPI_Datatype) datatype, &status), "File::ReadShared" );
         return status;
     };
@@ -3429,6 +4742,7 @@ namespace MEL {
      */
     inline Request FileIread(const File &file, void *rptr, const int rnum, const Datatype &datatype) {
         MPI_Request request;
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, rnum, (MPI_Datatype) datatype);
         MEL_THROW( MPI_File_iread(file, rptr, rnum, (MPI_Datatype) datatype, &request), "File::Iread" );
         return Request(request);
     };
@@ -3448,6 +4762,7 @@ namespace MEL {
      */
     inline Request FileIreadAt(const File &file, const Offset offset, void *rptr, const int rnum, const Datatype &datatype) {
         MPI_Request request;
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, rnum, (MPI_Datatype) datatype);
         MEL_THROW(MPI_File_iread_at(file, offset, rptr, rnum, (MPI_Datatype) datatype, &request), "File::IreadAt");
         return Request(request);
     };
@@ -3466,6 +4781,7 @@ namespace MEL {
      */
     inline Request FileIreadShared(const File &file, void *rptr, const int rnum, const Datatype &datatype) {
         MPI_Request request;
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, rnum, (MPI_Datatype) datatype);
         MEL_THROW( MPI_File_iread_shared(file, rptr, rnum, (MPI_Datatype) datatype, &request), "File::IreadShared" );
         return Request(request);
     };    
@@ -3473,91 +4789,109 @@ namespace MEL {
     /// \cond HIDE
 #define MEL_FILE(T, D) inline Status FileWrite(const File &file, const T *sptr, const int snum) {                                    \
         MPI_Status status;                                                                                                            \
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, snum, D);                                                                                     \
         MEL_THROW( MPI_File_write(file, sptr, snum,  D, &status), "File::Write(#T, #D)" );                                            \
         return status;                                                                                                                \
     };                                                                                                                                \
     inline Status FileWriteAll(const File &file, const T *sptr, const int snum) {                                                    \
         MPI_Status status;                                                                                                            \
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, snum, D);                                                                                    \
         MEL_THROW( MPI_File_write_all(file, sptr, snum,  D, &status), "File::WriteAll(#T, #D)" );                                    \
         return status;                                                                                                                \
     };                                                                                                                                \
     inline Status FileWriteAt(const File &file, const Offset offset, const T *sptr, const int snum) {                                \
         MPI_Status status;                                                                                                            \
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, snum, D);                                                                                      \
         MEL_THROW( MPI_File_write_at(file, offset, sptr, snum,  D, &status), "File::WriteAt(#T, #D)" );                                \
         return status;                                                                                                                \
     };                                                                                                                                \
     inline Status FileWriteAtAll(const File &file, const Offset offset, const T *sptr, const int snum) {                            \
         MPI_Status status;                                                                                                            \
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, snum, D);                                                                                     \
         MEL_THROW( MPI_File_write_at_all(file, offset, sptr, snum,  D, &status), "File::WriteAtAll(#T, #D)" );                        \
         return status;                                                                                                                \
     };                                                                                                                                \
     inline Status FileWriteOrdered(const File &file, const T *sptr, const int snum) {                                                \
         MPI_Status status;                                                                                                            \
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, snum, D);                                                                                    \
         MEL_THROW( MPI_File_write_ordered(file, sptr, snum,  D, &status), "File::WriteOrdered(#T, #D)" );                            \
         return status;                                                                                                                \
     };                                                                                                                                \
     inline Status FileWriteShared(const File &file, const T *sptr, const int snum) {                                                \
         MPI_Status status;                                                                                                            \
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, snum, D);                                                                                      \
         MEL_THROW( MPI_File_write_shared(file, sptr, snum,  D, &status), "File::WriteShared(#T, #D)" );                                \
         return status;                                                                                                                \
     };                                                                                                                                \
     inline Request FileIwrite(const File &file, const T *sptr, const int snum) {                                                    \
         MPI_Request request;                                                                                                        \
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, snum, D);                                                                                    \
         MEL_THROW( MPI_File_iwrite(file, sptr, snum,  D, &request), "File::Iwrite(#T, #D)" );                                        \
         return Request(request);                                                                                                    \
     };                                                                                                                                \
     inline Request FileIwriteAt(const File &file, const Offset offset, const T *sptr, const int snum) {                                \
         MPI_Request request;                                                                                                        \
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, snum, D);                                                                                   \
         MEL_THROW(MPI_File_iwrite_at(file, offset, sptr, snum,  D, &request), "File::IwriteAt");                                    \
         return Request(request);                                                                                                    \
     };                                                                                                                                \
     inline Request FileIwriteShared(const File &file, const T *sptr, const int snum) {                                                \
         MPI_Request request;                                                                                                        \
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, snum, D);                                                                                     \
         MEL_THROW( MPI_File_iwrite_shared(file, sptr, snum,  D, &request), "File::IwriteShared(#T, #D)" );                            \
         return Request(request);                                                                                                    \
     };                                                                                                                                \
     inline Status FileRead(const File &file, T *rptr, const int rnum) {                                                                \
         MPI_Status status;                                                                                                            \
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, rnum, D);                                                                                   \
         MEL_THROW( MPI_File_read(file, rptr, rnum,  D, &status), "File::Read(#T, #D)" );                                            \
         return status;                                                                                                                \
     };                                                                                                                                \
     inline Status FileReadAll(const File &file, T *rptr, const int rnum) {                                                            \
         MPI_Status status;                                                                                                            \
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, rnum, D);                                                                                      \
         MEL_THROW( MPI_File_read_all(file, rptr, rnum,  D, &status), "File::ReadAll(#T, #D)" );                                        \
         return status;                                                                                                                \
     };                                                                                                                                \
     inline Status FileReadAt(const File &file, const Offset offset, T *rptr, const int rnum) {                                        \
         MPI_Status status;                                                                                                            \
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, rnum, D);                                                                                    \
         MEL_THROW( MPI_File_read_at(file, offset, rptr, rnum,  D, &status), "File::ReadAt(#T, #D)" );                                \
         return status;                                                                                                                \
     };                                                                                                                                \
     inline Status FileReadAtAll(const File &file, const Offset offset, T *rptr, const int rnum) {                                    \
         MPI_Status status;                                                                                                            \
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, rnum, D);                                                                                   \
         MEL_THROW( MPI_File_read_at_all(file, offset, rptr, rnum,  D, &status), "File::ReadAtAll(#T, #D)" );                        \
         return status;                                                                                                                \
     };                                                                                                                                \
     inline Status FileReadOrdered(const File &file, T *rptr, const int rnum) {                                                        \
         MPI_Status status;                                                                                                            \
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, rnum, D);                                                                                      \
         MEL_THROW( MPI_File_read_ordered(file, rptr, rnum,  D, &status), "File::ReadOrdered(#T, #D)" );                                \
         return status;                                                                                                                \
     };                                                                                                                                \
     inline Status FileReadShared(const File &file, T *rptr, const int rnum) {                                                        \
         MPI_Status status;                                                                                                            \
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, rnum, D);                                                                                    \
         MEL_THROW( MPI_File_read_shared(file, rptr, rnum,  D, &status), "File::ReadShared(#T, #D)" );                                \
         return status;                                                                                                                \
     };                                                                                                                                \
     inline Request FileIread(const File &file, T *rptr, const int rnum) {                                                            \
         MPI_Request request;                                                                                                        \
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, rnum, D);                                                                                      \
         MEL_THROW( MPI_File_iread(file, rptr, rnum,  D, &request), "File::Iread(#T, #D)" );                                            \
         return Request(request);                                                                                                    \
     };                                                                                                                                \
     inline Request FileIreadAt(const File &file, const Offset offset, T *rptr, const int rnum) {                                    \
         MPI_Request request;                                                                                                        \
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, rnum, D);                                                                                     \
         MEL_THROW(MPI_File_iread_at(file, offset, rptr, rnum,  D, &request), "File::IreadAt");                                        \
         return Request(request);                                                                                                    \
     };                                                                                                                                \
     inline Request FileIreadShared(const File &file, T *rptr, const int rnum) {                                                        \
         MPI_Request request;                                                                                                        \
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, rnum, D);                                                                                   \
         MEL_THROW( MPI_File_iread_shared(file, rptr, rnum,  D, &request), "File::IreadShared(#T, #D)" );                            \
         return Request(request);                                                                                                    \
     };                                                                                                                                
@@ -3860,6 +5194,7 @@ namespace MEL {
      * \param[in] comm				The comm world to send within
      */
     inline void Send(const void *ptr, const int num, const Datatype &datatype, const int dst, const int tag, const Comm &comm) {                
+        MEL_PROFILE_NOTE_TAG((MPI_Comm) comm, num, (MPI_Datatype) datatype, tag);
         MEL_THROW( MPI_Send(ptr, num, (MPI_Datatype) datatype, dst, tag, (MPI_Comm) comm), "Comm::Send" );                                            
     };                                                                                                                                
     
@@ -3877,6 +5212,7 @@ namespace MEL {
      * \param[in] comm				The comm world to send within
      */
     inline void Bsend(const void *ptr, const int num, const Datatype &datatype, const int dst, const int tag, const Comm &comm) {                                
+        MEL_PROFILE_NOTE_TAG((MPI_Comm) comm, num, (MPI_Datatype) datatype, tag);
         MEL_THROW( MPI_Bsend(ptr, num, (MPI_Datatype) datatype, dst, tag, (MPI_Comm) comm), "Comm::Bsend" );                                        
     };
     
@@ -3894,6 +5230,7 @@ namespace MEL {
      * \param[in] comm				The comm world to send within
      */                                                                                                                                
     inline void Ssend(const void *ptr, const int num, const Datatype &datatype, const int dst, const int tag, const Comm &comm) {                                
+        MEL_PROFILE_NOTE_TAG((MPI_Comm) comm, num, (MPI_Datatype) datatype, tag);
         MEL_THROW( MPI_Ssend(ptr, num, (MPI_Datatype) datatype, dst, tag, (MPI_Comm) comm), "Comm::Ssend" );                                        
     };
     
@@ -3913,6 +5250,7 @@ namespace MEL {
      * \param[in] comm				The comm world to send within
      */                                                                                                                                  
     inline void Rsend(const void *ptr, const int num, const Datatype &datatype, const int dst, const int tag, const Comm &comm) {                                
+        MEL_PROFILE_NOTE_TAG((MPI_Comm) comm, num, (MPI_Datatype) datatype, tag);
         MEL_THROW( MPI_Rsend(ptr, num, (MPI_Datatype) datatype, dst, tag, (MPI_Comm) comm), "Comm::Rsend" );                                        
     };  
     
@@ -3931,6 +5269,7 @@ namespace MEL {
      * \param[out] rq				A request object
      */                                                                                                                               
     inline void Isend(const void *ptr, const int num, const Datatype &datatype, const int dst, const int tag, const Comm &comm, Request &rq) {            
+        MEL_PROFILE_NOTE_TAG((MPI_Comm) comm, num, (MPI_Datatype) datatype, tag);
         MEL_THROW( MPI_Isend(ptr, num, (MPI_Datatype) datatype, dst, tag, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Isend" );                                    
     };                                                                                                                               
     
@@ -3967,6 +5306,7 @@ namespace MEL {
      * \param[out] rq				A request object
      */                                                                                                                                  
     inline void Ibsend(const void *ptr, const int num, const Datatype &datatype, const int dst, const int tag, const Comm &comm, Request &rq) {            
+        MEL_PROFILE_NOTE_TAG((MPI_Comm) comm, num, (MPI_Datatype) datatype, tag);
         MEL_THROW( MPI_Ibsend(ptr, num, (MPI_Datatype) datatype, dst, tag, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Ibsend" );                                
     };  
     
@@ -4003,6 +5343,7 @@ namespace MEL {
      * \param[out] rq				A request object
      */                                                                                                                                  
     inline void Issend(const void *ptr, const int num, const Datatype &datatype, const int dst, const int tag, const Comm &comm, Request &rq) {            
+        MEL_PROFILE_NOTE_TAG((MPI_Comm) comm, num, (MPI_Datatype) datatype, tag);
         MEL_THROW( MPI_Issend(ptr, num, (MPI_Datatype) datatype, dst, tag, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Issend" );                                
     }; 
     
@@ -4041,6 +5382,7 @@ namespace MEL {
      * \param[out] rq				A request object
      */                                                                                                                               
     inline void Irsend(const void *ptr, const int num, const Datatype &datatype, const int dst, const int tag, const Comm &comm, Request &rq) {            
+        MEL_PROFILE_NOTE_TAG((MPI_Comm) comm, num, (MPI_Datatype) datatype, tag);
         MEL_THROW( MPI_Irsend(ptr, num, (MPI_Datatype) datatype, dst, tag, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Irsend" );                                
     };
     
@@ -4064,18 +5406,23 @@ namespace MEL {
 
     /// \cond HIDE
 #define MEL_SEND(T, D)    inline void Send(const T *ptr, const int num, const int dst, const int tag, const Comm &comm) {                \
+        MEL_PROFILE_NOTE_TAG((MPI_Comm) comm, num, D, tag);                                                                           \
         MEL_THROW( MPI_Send(ptr, num, D, dst, tag, (MPI_Comm) comm), "Comm::Send( " #T ", " #D " )" );                                \
     }                                                                                                                                \
     inline void Bsend(const T *ptr, const int num, const int dst, const int tag, const Comm &comm) {                                \
+        MEL_PROFILE_NOTE_TAG((MPI_Comm) comm, num, D, tag);                                                                         \
         MEL_THROW( MPI_Bsend(ptr, num, D, dst, tag, (MPI_Comm) comm), "Comm::Bsend( " #T ", " #D " )" );                            \
     }                                                                                                                                \
     inline void Ssend(const T *ptr, const int num, const int dst, const int tag, const Comm &comm) {                                \
+        MEL_PROFILE_NOTE_TAG((MPI_Comm) comm, num, D, tag);                                                                         \
         MEL_THROW( MPI_Ssend(ptr, num, D, dst, tag, (MPI_Comm) comm), "Comm::Ssend( " #T ", " #D " )" );                            \
     }                                                                                                                                \
     inline void Rsend(const T *ptr, const int num, const int dst, const int tag, const Comm &comm) {                                \
+        MEL_PROFILE_NOTE_TAG((MPI_Comm) comm, num, D, tag);                                                                         \
         MEL_THROW( MPI_Rsend(ptr, num, D, dst, tag, (MPI_Comm) comm), "Comm::Rsend( " #T ", " #D " )" );                            \
     }                                                                                                                                \
     inline void Isend(const T *ptr, const int num, const int dst, const int tag, const Comm &comm, Request &rq) {                    \
+        MEL_PROFILE_NOTE_TAG((MPI_Comm) comm, num, D, tag);                                                                         \
         MEL_THROW( MPI_Isend(ptr, num, D, dst, tag, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Isend( " #T ", " #D " )" );        \
     }                                                                                                                                \
     inline Request Isend(const T *ptr, const int num, const int dst, const int tag, const Comm &comm) {                                \
@@ -4084,6 +5431,7 @@ namespace MEL {
         return rq;                                                                                                                    \
     }                                                                                                                                \
     inline void Ibsend(const T *ptr, const int num, const int dst, const int tag, const Comm &comm, Request &rq) {                    \
+        MEL_PROFILE_NOTE_TAG((MPI_Comm) comm, num, D, tag);                                                                           \
         MEL_THROW( MPI_Ibsend(ptr, num, D, dst, tag, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Ibsend( " #T ", " #D " )" );        \
     }                                                                                                                                \
     inline Request Ibsend(const T *ptr, const int num, const int dst, const int tag, const Comm &comm) {                            \
@@ -4092,6 +5440,7 @@ namespace MEL {
         return rq;                                                                                                                    \
     }                                                                                                                                \
     inline void Issend(const T *ptr, const int num, const int dst, const int tag, const Comm &comm, Request &rq) {                    \
+        MEL_PROFILE_NOTE_TAG((MPI_Comm) comm, num, D, tag);                                                                           \
         MEL_THROW( MPI_Issend(ptr, num, D, dst, tag, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Issend( " #T ", " #D " )" );        \
     }                                                                                                                                \
     inline Request Issend(const T *ptr, const int num, const int dst, const int tag, const Comm &comm) {                            \
@@ -4100,6 +5449,7 @@ namespace MEL {
         return rq;                                                                                                                    \
     }                                                                                                                                \
     inline void Irsend(const T *ptr, const int num, const int dst, const int tag, const Comm &comm, Request &rq) {                    \
+        MEL_PROFILE_NOTE_TAG((MPI_Comm) comm, num, D, tag);                                                                           \
         MEL_THROW( MPI_Irsend(ptr, num, D, dst, tag, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Irsend( " #T ", " #D " )" );        \
     }                                                                                                                                \
     inline Request Irsend(const T *ptr, const int num, const int dst, const int tag, const Comm &comm) {                            \
@@ -4147,7 +5497,7 @@ namespace MEL {
      */
     template<typename T>
     inline void Send(const T *ptr, const int num, const int dst, const int tag, const Comm &comm) {
-        Send(ptr, num * sizeof(T), MEL::Datatype::CHAR, dst, tag, comm);
+        Send(ptr, TypeElements<T>(num), TypeElement<T>(), dst, tag, comm);
     };
 
     /**
@@ -4162,7 +5512,7 @@ namespace MEL {
      */
     template<typename T>
     inline void Bsend(const T *ptr, const int num, const int dst, const int tag, const Comm &comm) {
-        Bsend(ptr, num * sizeof(T), MEL::Datatype::CHAR, dst, tag, comm);
+        Bsend(ptr, TypeElements<T>(num), TypeElement<T>(), dst, tag, comm);
     };
 
     /**
@@ -4177,7 +5527,7 @@ namespace MEL {
      */
     template<typename T>
     inline void Ssend(const T *ptr, const int num, const int dst, const int tag, const Comm &comm) {
-        Ssend(ptr, num * sizeof(T), MEL::Datatype::CHAR, dst, tag, comm);
+        Ssend(ptr, TypeElements<T>(num), TypeElement<T>(), dst, tag, comm);
     };
 
     /**
@@ -4194,7 +5544,7 @@ namespace MEL {
      */
     template<typename T>
     inline void Rsend(const T *ptr, const int num, const int dst, const int tag, const Comm &comm) {
-        Rsend(ptr, num * sizeof(T), MEL::Datatype::CHAR, dst, tag, comm);
+        Rsend(ptr, TypeElements<T>(num), TypeElement<T>(), dst, tag, comm);
     };
 
     /**
@@ -4210,7 +5560,7 @@ namespace MEL {
      */
     template<typename T>
     inline void Isend(const T *ptr, const int num, const int dst, const int tag, const Comm &comm, Request &rq) {
-        Isend(ptr, num * sizeof(T), MEL::Datatype::CHAR, dst, tag, comm, rq);
+        Isend(ptr, TypeElements<T>(num), TypeElement<T>(), dst, tag, comm, rq);
     };
     
     /**
@@ -4226,7 +5576,7 @@ namespace MEL {
      */
     template<typename T>
     inline Request Isend(const T *ptr, const int num, const int dst, const int tag, const Comm &comm) {
-        return Isend(ptr, num * sizeof(T), MEL::Datatype::CHAR, dst, tag, comm);
+        return Isend(ptr, TypeElements<T>(num), TypeElement<T>(), dst, tag, comm);
     };
 
     /**
@@ -4242,7 +5592,7 @@ namespace MEL {
      */
     template<typename T>
     inline void Ibsend(const T *ptr, const int num, const int dst, const int tag, const Comm &comm, Request &rq) {
-        Ibsend(ptr, num * sizeof(T), MEL::Datatype::CHAR, dst, tag, comm, rq);
+        Ibsend(ptr, TypeElements<T>(num), TypeElement<T>(), dst, tag, comm, rq);
     };
 
     /**
@@ -4258,7 +5608,7 @@ namespace MEL {
      */
     template<typename T>
     inline Request Ibsend(const T *ptr, const int num, const int dst, const int tag, const Comm &comm) {
-        return Ibsend(ptr, num * sizeof(T), MEL::Datatype::CHAR, dst, tag, comm);
+        return Ibsend(ptr, TypeElements<T>(num), TypeElement<T>(), dst, tag, comm);
     };
 
     /**
@@ -4274,7 +5624,7 @@ namespace MEL {
      */
     template<typename T>
     inline void Issend(const T *ptr, const int num, const int dst, const int tag, const Comm &comm, Request &rq) {
-        Issend(ptr, num * sizeof(T), MEL::Datatype::CHAR, dst, tag, comm, rq);
+        Issend(ptr, TypeElements<T>(num), TypeElement<T>(), dst, tag, comm, rq);
     };
 
     /**
@@ -4290,7 +5640,7 @@ namespace MEL {
      */
     template<typename T>
     inline Request Issend(const T *ptr, const int num, const int dst, const int tag, const Comm &comm) {
-        return Issend(ptr, num * sizeof(T), MEL::Datatype::CHAR, dst, tag, comm);
+        return Issend(ptr, TypeElements<T>(num), TypeElement<T>(), dst, tag, comm);
     };
 
     /**
@@ -4308,7 +5658,7 @@ namespace MEL {
      */
     template<typename T>
     inline void Irsend(const T *ptr, const int num, const int dst, const int tag, const Comm &comm, Request &rq) {
-        Irsend(ptr, num * sizeof(T), MEL::Datatype::CHAR, dst, tag, comm, rq);
+        Irsend(ptr, TypeElements<T>(num), TypeElement<T>(), dst, tag, comm, rq);
     };
 
     /**
@@ -4326,7 +5676,7 @@ namespace MEL {
      */
     template<typename T>
     inline Request Irsend(const T *ptr, const int num, const int dst, const int tag, const Comm &comm) {
-        return Irsend(ptr, num * sizeof(T), MEL::Datatype::CHAR, dst, tag, comm);
+        return Irsend(ptr, TypeElements<T>(num), TypeElement<T>(), dst, tag, comm);
     };
 
     /**
@@ -4375,8 +5725,8 @@ namespace MEL {
     template<typename T>
     inline int ProbeGetCount(const MPI_Status &status) {
         int c;
-        MEL_THROW(MPI_Get_count(&status, MPI_CHAR, &c), "Comm::ProbeGetCount");
-        return c / sizeof(T);
+        MEL_THROW(MPI_Get_count(&status, (MPI_Datatype) TypeElement<T>(), &c), "Comm::ProbeGetCount");
+        return c / (TypeElements<T>(1));
     };
     
     /**
@@ -4441,6 +5791,7 @@ namespace MEL {
      */
     inline Status Recv(void *ptr, const int num, const Datatype &datatype, const int src, const int tag, const Comm &comm) {
         Status status{};                                                                                                        
+        MEL_PROFILE_NOTE_TAG((MPI_Comm) comm, num, (MPI_Datatype) datatype, tag);
         MEL_THROW( MPI_Recv(ptr, num, (MPI_Datatype) datatype, src, tag, (MPI_Comm) comm, &status), "Comm::Recv" );                                
         return status;                                                                                                                
     };
@@ -4460,6 +5811,7 @@ namespace MEL {
      * \param[out] rq				A request object
      */                                                                                                                                
     inline void Irecv(void *ptr, const int num, const Datatype &datatype, const int src, const int tag, const Comm &comm, Request &rq) {
+        MEL_PROFILE_NOTE_TAG((MPI_Comm) comm, num, (MPI_Datatype) datatype, tag);
         MEL_THROW( MPI_Irecv(ptr, num, (MPI_Datatype) datatype, src, tag, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Irecv" );                                    
     };
     
@@ -4484,10 +5836,12 @@ namespace MEL {
     /// \cond HIDE
 #define MEL_RECV(T, D) inline Status Recv(T *ptr, const int num, const int src, const int tag, const Comm &comm) {                    \
         Status status{};                                                                                                            \
+        MEL_PROFILE_NOTE_TAG((MPI_Comm) comm, num, D, tag);                                                                            \
         MEL_THROW( MPI_Recv(ptr, num, D, src, tag, (MPI_Comm) comm, &status), "Comm::Recv( " #T ", " #D " )" );                        \
         return status;                                                                                                                \
     }                                                                                                                                \
     inline void Irecv(T *ptr, const int num, const int src, const int tag, const Comm &comm, Request &rq) {                            \
+        MEL_PROFILE_NOTE_TAG((MPI_Comm) comm, num, D, tag);                                                                         \
         MEL_THROW( MPI_Irecv(ptr, num, D, src, tag, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Irecv( " #T ", " #D " )" );        \
     }                                                                                                                                \
     inline Request Irecv(T *ptr, const int num, const int src, const int tag, const Comm &comm) {                                    \
@@ -4535,7 +5889,7 @@ namespace MEL {
      */
     template<typename T>
     inline Status Recv(T *ptr, const int num, const int src, const int tag, const Comm &comm) {
-        return Recv(ptr, num * sizeof(T), MEL::Datatype::CHAR, src, tag, comm);
+        return Recv(ptr, TypeElements<T>(num), TypeElement<T>(), src, tag, comm);
     };
 
     /**
@@ -4551,7 +5905,7 @@ namespace MEL {
      */   
     template<typename T>
     inline void Irecv(T *ptr, const int num, const int src, const int tag, const Comm &comm, Request &rq) {
-        Irecv(ptr, num * sizeof(T), MEL::Datatype::CHAR, src, tag, comm, rq);
+        Irecv(ptr, TypeElements<T>(num), TypeElement<T>(), src, tag, comm, rq);
     };
     
     /**
@@ -4567,7 +5921,7 @@ namespace MEL {
      */
     template<typename T>
     inline Request Irecv(T *ptr, const int num, const int src, const int tag, const Comm &comm) {
-        return Irecv(ptr, num * sizeof(T), MEL::Datatype::CHAR, src, tag, comm);
+        return Irecv(ptr, TypeElements<T>(num), TypeElement<T>(), src, tag, comm);
     };
 
     /**
@@ -4583,6 +5937,7 @@ namespace MEL {
      * \param[in] comm				The comm world to broadcast within
      */                                                                                                                      
     inline void Bcast(void *ptr, const int num, const Datatype &datatype, const int root, const Comm &comm) {                                                                            
+        MEL_PROFILE_NOTE((MPI_Comm) comm, num, (MPI_Datatype) datatype);
         MEL_THROW( MPI_Bcast(ptr, num, (MPI_Datatype) datatype, root, (MPI_Comm) comm), "Comm::Bcast" );                                                                
     };
 
@@ -4602,6 +5957,7 @@ namespace MEL {
      * \param[in] comm				The comm world to scatter within
      */
     inline void Scatter(void *sptr, const int snum, const Datatype &sdatatype, void *rptr, const int rnum, const Datatype &rdatatype, const int root, const Comm &comm) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, rnum, (MPI_Datatype) rdatatype);
         MEL_THROW( MPI_Scatter(sptr, snum, (MPI_Datatype) sdatatype, rptr, rnum, (MPI_Datatype) rdatatype, root, (MPI_Comm) comm), "Comm::Scatter" );                                            
     };        
     
@@ -4622,6 +5978,7 @@ namespace MEL {
      * \param[in] comm				The comm world to scatter within
      */                                                                                                                                            
     inline void Scatterv(void *sptr, const int *snum, const int *displs, const Datatype &sdatatype, void *rptr, const int rnum, const Datatype &rdatatype, const int root, const Comm &comm) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, rnum, (MPI_Datatype) rdatatype);
         MEL_THROW( MPI_Scatterv(sptr, snum, displs, (MPI_Datatype) sdatatype, rptr, rnum, (MPI_Datatype) rdatatype, root, (MPI_Comm) comm), "Comm::Scatterv" );                                
     };    
                                                                                                                                                     
@@ -4641,6 +5998,7 @@ namespace MEL {
      * \param[in] comm				The comm world to gather within
      */                                                                                                                                
     inline void Gather(void *sptr, const int snum, const Datatype &sdatatype, void *rptr, const int rnum, const Datatype &rdatatype, const int root, const Comm &comm) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, snum, (MPI_Datatype) sdatatype);
         MEL_THROW( MPI_Gather(sptr, snum, (MPI_Datatype) sdatatype, rptr, rnum, (MPI_Datatype) rdatatype, root, (MPI_Comm) comm), "Comm::Gather" );                                            
     };    
       
@@ -4661,6 +6019,7 @@ namespace MEL {
      * \param[in] comm				The comm world to gather within
      */                                                                                                                                                      
     inline void Gatherv(void *sptr, const int snum, const Datatype &sdatatype, void *rptr, const int *rnum, const int *displs, const Datatype &rdatatype, const int root, const Comm &comm) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, snum, (MPI_Datatype) sdatatype);
         MEL_THROW( MPI_Gatherv(sptr, snum, (MPI_Datatype) sdatatype, rptr, rnum, displs, (MPI_Datatype) rdatatype, root, (MPI_Comm) comm), "Comm::Gatherv" );                                    
     };
                                                                                                                                                             
@@ -4679,6 +6038,7 @@ namespace MEL {
      * \param[in] comm				The comm world to gather within
      */                                                                                                                            
     inline void Allgather(void *sptr, const int snum, const Datatype &sdatatype, void *rptr, const int rnum, const Datatype &rdatatype, const Comm &comm) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, snum, (MPI_Datatype) sdatatype);
         MEL_THROW( MPI_Allgather(sptr, snum, (MPI_Datatype) sdatatype, rptr, rnum, (MPI_Datatype) rdatatype, (MPI_Comm) comm), "Comm::Allgather" );                                            
     };    
     
@@ -4698,6 +6058,7 @@ namespace MEL {
      * \param[in] comm				The comm world to gather within
      */                                                                                                                                                          
     inline void Allgatherv(void *sptr, const int snum, const Datatype &sdatatype, void *rptr, const int *rnum, const int *displ, const Datatype &rdatatype, const Comm &comm) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, snum, (MPI_Datatype) sdatatype);
         MEL_THROW( MPI_Allgatherv(sptr, snum, (MPI_Datatype) sdatatype, rptr, rnum, displ, (MPI_Datatype) rdatatype, (MPI_Comm) comm), "Comm::Allgather" );  
     };   
                                                                                                                                                 
@@ -4716,6 +6077,7 @@ namespace MEL {
      * \param[in] comm				The comm world to broadcast within
      */                                                                                                                                
     inline void Alltoall(void *sptr, const int snum, const Datatype &sdatatype, void *rptr, const int rnum, const Datatype &rdatatype, const Comm &comm) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, snum, (MPI_Datatype) sdatatype);
         MEL_THROW( MPI_Alltoall(sptr, snum, (MPI_Datatype) sdatatype, rptr, rnum, (MPI_Datatype) rdatatype, (MPI_Comm) comm), "Comm::Alltoall" );                                                
     };    
     
@@ -4736,6 +6098,7 @@ namespace MEL {
      * \param[in] comm				The comm world to broadcast within
      */                                                                                                                                         
     inline void Alltoallv(void *sptr, const int *snum, const int *sdispl, const Datatype &sdatatype, void *rptr, const int *rnum, const int *rdispl, const Datatype &rdatatype, const Comm &comm) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, 0, MPI_DATATYPE_NULL);
         MEL_THROW( MPI_Alltoallv(sptr, snum, sdispl, (MPI_Datatype) sdatatype, rptr, rnum, rdispl, (MPI_Datatype) rdatatype, (MPI_Comm) comm), "Comm::Alltoallv" );                            
     };
 
@@ -4756,6 +6119,7 @@ namespace MEL {
      * \param[in] comm				The comm world to broadcast within
      */    
     inline void Alltoallw(void *sptr, const int *snum, const int *sdispl, const Datatype *sdatatype, void *rptr, const int *rnum, const int *rdispl, const Datatype *rdatatype, const Comm &comm) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, 0, MPI_DATATYPE_NULL);
         MEL_THROW( MPI_Alltoallw(sptr, snum, sdispl, (MPI_Datatype*) sdatatype, rptr, rnum, rdispl, (MPI_Datatype*) rdatatype, (MPI_Comm) comm), "Comm::Alltoallw" );
     };
 
@@ -4774,6 +6138,7 @@ namespace MEL {
      * \param[in] comm				The comm world to reduce within
      */                                                                                                                             
     inline void Reduce(void *sptr, void *rptr, const int num, const Datatype &datatype, const Op &op, const int root, const Comm &comm) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, num, (MPI_Datatype) datatype);
         MEL_THROW( MPI_Reduce(sptr, rptr, num, (MPI_Datatype) datatype, (MPI_Op) op, root, (MPI_Comm) comm), "Comm::Reduce" );                                                
     };                                                                                                                                                
     
@@ -4791,8 +6156,45 @@ namespace MEL {
      * \param[in] comm				The comm world to reduce within
      */
     inline void Allreduce(void *sptr, void *rptr, const int num, const Datatype &datatype, const Op &op, const Comm &comm) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, num, (MPI_Datatype) datatype);
         MEL_THROW( MPI_Allreduce(sptr, rptr, num, (MPI_Datatype) datatype, (MPI_Op) op, (MPI_Comm) comm), "Comm::Allreduce" );                                            
     };
+
+    /**
+     * \ingroup COL
+     * Compute the inclusive prefix reduction of an array across the processes in comm, in rank order
+     *
+     * \see MPI_Scan
+     *
+     * \param[in] sptr				Pointer to num elements to send
+     * \param[out] rptr				Pointer to the receive buffer
+     * \param[in] num				The number of elements in the array
+     * \param[in] datatype			The derived datatype of the elements to reduce
+     * \param[in] op				The operation to perform for the reduction
+     * \param[in] comm				The comm world to reduce within
+     */
+    inline void Scan(void *sptr, void *rptr, const int num, const Datatype &datatype, const Op &op, const Comm &comm) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, num, (MPI_Datatype) datatype);
+        MEL_THROW( MPI_Scan(sptr, rptr, num, (MPI_Datatype) datatype, (MPI_Op) op, (MPI_Comm) comm), "Comm::Scan" );
+    };
+
+    /**
+     * \ingroup COL
+     * Compute the exclusive prefix reduction of an array across the processes in comm, in rank order. The receive buffer on rank 0 is left undefined
+     *
+     * \see MPI_Exscan
+     *
+     * \param[in] sptr				Pointer to num elements to send
+     * \param[out] rptr				Pointer to the receive buffer
+     * \param[in] num				The number of elements in the array
+     * \param[in] datatype			The derived datatype of the elements to reduce
+     * \param[in] op				The operation to perform for the reduction
+     * \param[in] comm				The comm world to reduce within
+     */
+    inline void Exscan(void *sptr, void *rptr, const int num, const Datatype &datatype, const Op &op, const Comm &comm) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, num, (MPI_Datatype) datatype);
+        MEL_THROW( MPI_Exscan(sptr, rptr, num, (MPI_Datatype) datatype, (MPI_Op) op, (MPI_Comm) comm), "Comm::Exscan" );
+    };
     
 #ifdef MEL_3
     /**
@@ -4809,6 +6211,7 @@ namespace MEL {
      * \param[out] rq				A request object
      */
     inline void Ibcast(void *ptr, const int num, const Datatype &datatype, const int root, const Comm &comm, Request &rq) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, num, (MPI_Datatype) datatype);
         MEL_THROW(MPI_Ibcast(ptr, num, (MPI_Datatype) datatype, root, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Ibcast");
     };
     
@@ -4846,6 +6249,7 @@ namespace MEL {
      * \param[out] rq				A request object
      */
     inline void Iscatter(void *sptr, const int snum, const Datatype &sdatatype, void *rptr, const int rnum, const Datatype &rdatatype, const int root, const Comm &comm, Request &rq) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, rnum, (MPI_Datatype) rdatatype);
         MEL_THROW(MPI_Iscatter(sptr, snum, (MPI_Datatype) sdatatype, rptr, rnum, (MPI_Datatype) rdatatype, root, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Iscatter");
     };
 
@@ -4887,6 +6291,7 @@ namespace MEL {
      * \param[out] rq				A request object
      */
     inline void Iscatterv(void *sptr, const int *snum, const int *displs, const Datatype &sdatatype, void *rptr, const int rnum, const Datatype &rdatatype, const int root, const Comm &comm, Request &rq) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, rnum, (MPI_Datatype) rdatatype);
         MEL_THROW(MPI_Iscatterv(sptr, snum, displs, (MPI_Datatype) sdatatype, rptr, rnum, (MPI_Datatype) rdatatype, root, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Iscatterv");
     };
 
@@ -4928,6 +6333,7 @@ namespace MEL {
      * \param[out] rq				A request object
      */ 
     inline void Igather(void *sptr, const int snum, const Datatype &sdatatype, void *rptr, const int rnum, const Datatype &rdatatype, const int root, const Comm &comm, Request &rq) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, snum, (MPI_Datatype) sdatatype);
         MEL_THROW(MPI_Igather(sptr, snum, (MPI_Datatype) sdatatype, rptr, rnum, (MPI_Datatype) rdatatype, root, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Igather");
     };
 
@@ -4969,6 +6375,7 @@ namespace MEL {
      * \param[out] rq				A request object
      */ 
     inline void Igatherv(void *sptr, const int snum, const Datatype &sdatatype, void *rptr, const int *rnum, const int *displs, const Datatype &rdatatype, const int root, const Comm &comm, Request &rq) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, snum, (MPI_Datatype) sdatatype);
         MEL_THROW(MPI_Igatherv(sptr, snum, (MPI_Datatype) sdatatype, rptr, rnum, displs, (MPI_Datatype) rdatatype, root, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Igatherv");
     };
 
@@ -5009,6 +6416,7 @@ namespace MEL {
      * \param[out] rq				A request object
      */  
     inline void Iallgather(void *sptr, const int snum, const Datatype &sdatatype, void *rptr, const int rnum, const Datatype &rdatatype, const Comm &comm, Request &rq) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, snum, (MPI_Datatype) sdatatype);
         MEL_THROW(MPI_Iallgather(sptr, snum, (MPI_Datatype) sdatatype, rptr, rnum, (MPI_Datatype) rdatatype, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Iallgather");
     };
 
@@ -5048,6 +6456,7 @@ namespace MEL {
      * \param[out] rq				A request object
      */  
     inline void Iallgatherv(void *sptr, const int snum, const Datatype &sdatatype, void *rptr, const int *rnum, const int *displ, const Datatype &rdatatype, const Comm &comm, Request &rq) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, snum, (MPI_Datatype) sdatatype);
         MEL_THROW(MPI_Iallgatherv(sptr, snum, (MPI_Datatype) sdatatype, rptr, rnum, displ, (MPI_Datatype) rdatatype, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Iallgather");
     };
 
@@ -5087,6 +6496,7 @@ namespace MEL {
      * \param[out] rq				A request object
      */
     inline void Ialltoall(void *sptr, const int snum, const Datatype &sdatatype, void *rptr, const int rnum, const Datatype &rdatatype, const Comm &comm, Request &rq) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, snum, (MPI_Datatype) sdatatype);
         MEL_THROW(MPI_Ialltoall(sptr, snum, (MPI_Datatype) sdatatype, rptr, rnum, (MPI_Datatype) rdatatype, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Ialltoall");
     };
 
@@ -5127,6 +6537,7 @@ namespace MEL {
      * \param[out] rq				A request object
      */
     inline void Ialltoallv(void *sptr, const int *snum, const int *sdispl, const Datatype &sdatatype, void *rptr, const int *rnum, const int *rdispl, const Datatype &rdatatype, const Comm &comm, Request &rq) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, 0, MPI_DATATYPE_NULL);
         MEL_THROW(MPI_Ialltoallv(sptr, snum, sdispl, (MPI_Datatype) sdatatype, rptr, rnum, rdispl, (MPI_Datatype) rdatatype, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Ialltoallv");
     };
 
@@ -5169,6 +6580,7 @@ namespace MEL {
      * \param[out] rq				A request object
      */   
     inline void Ialltoallw(void *sptr, const int *snum, const int *sdispl, const Datatype *sdatatype, void *rptr, const int *rnum, const int *rdispl, const Datatype *rdatatype, const Comm &comm, Request &rq) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, 0, MPI_DATATYPE_NULL);
         MEL_THROW(MPI_Ialltoallw(sptr, snum, sdispl, (MPI_Datatype*) sdatatype, rptr, rnum, rdispl, (MPI_Datatype*) rdatatype, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Ialltoallw");
     };
 
@@ -5209,6 +6621,7 @@ namespace MEL {
      * \param[out] rq				A request object
      */     
     inline void Ireduce(void *sptr, void *rptr, const int num, const Datatype &datatype, const Op &op, const int root, const Comm &comm, Request &rq) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, num, (MPI_Datatype) datatype);
         MEL_THROW(MPI_Ireduce(sptr, rptr, num, (MPI_Datatype) datatype, (MPI_Op) op, root, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Ireduce");
     };
 
@@ -5246,6 +6659,7 @@ namespace MEL {
      * \param[out] rq				A request object
      */
     inline void Iallreduce(void *sptr, void *rptr, const int num, const Datatype &datatype, const Op &op, const Comm &comm, Request &rq) {
+        MEL_PROFILE_NOTE((MPI_Comm) comm, num, (MPI_Datatype) datatype);
         MEL_THROW( MPI_Iallreduce(sptr, rptr, num, (MPI_Datatype) datatype, (MPI_Op) op, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Iallreduce" );                            
     }; 
     
@@ -5270,45 +6684,57 @@ namespace MEL {
 
     /// \cond HIDE
 #define MEL_COLLECTIVE(T, D) inline void Bcast(T *ptr, const int num, const int root, const Comm &comm) {                                                    \
+        MEL_PROFILE_NOTE((MPI_Comm) comm, num, D);                                                                                                          \
         MEL_THROW( MPI_Bcast(ptr, num, D, root, (MPI_Comm) comm), "Comm::Bcast( " #T ", " #D " )" );                                                        \
     }                                                                                                                                                        \
     /* Scatter / Scatterv */                                                                                                                                \
     inline void Scatter(T *sptr, const int snum, T *rptr, const int rnum, const int root, const Comm &comm) {                                                \
+        MEL_PROFILE_NOTE((MPI_Comm) comm, rnum, D);                                                                                                          \
         MEL_THROW( MPI_Scatter(sptr, snum, D, rptr, rnum, D, root, (MPI_Comm) comm), "Comm::Scatter( " #T ", " #D " )" );                                    \
     }                                                                                                                                                        \
     inline void Scatterv(T *sptr, const int *snum, const int *displs, T *rptr, const int rnum, const int root, const Comm &comm) {                            \
+        MEL_PROFILE_NOTE((MPI_Comm) comm, rnum, D);                                                                                                            \
         MEL_THROW( MPI_Scatterv(sptr, snum, displs, D, rptr, rnum, D, root, (MPI_Comm) comm), "Comm::Scatterv( " #T ", " #D " )" );                            \
     }                                                                                                                                                        \
     /* Gather / Gatherv */                                                                                                                                    \
     inline void Gather(T *sptr, const int snum, T *rptr, const int rnum, const int root, const Comm &comm) {                                                \
+        MEL_PROFILE_NOTE((MPI_Comm) comm, snum, D);                                                                                                            \
         MEL_THROW( MPI_Gather(sptr, snum, D, rptr, rnum, D, root, (MPI_Comm) comm), "Comm::Gather( " #T ", " #D " )" );                                        \
     }                                                                                                                                                        \
     inline void Gatherv(T *sptr, const int snum, T *rptr, const int *rnum, const int *displs, const int root, const Comm &comm) {                            \
+        MEL_PROFILE_NOTE((MPI_Comm) comm, snum, D);                                                                                                          \
         MEL_THROW( MPI_Gatherv(sptr, snum, D, rptr, rnum, displs, D, root, (MPI_Comm) comm), "Comm::Gatherv( " #T ", " #D " )" );                            \
     }                                                                                                                                                        \
     /* Allgather / Allgatherv */                                                                                                                            \
     inline void Allgather(T *sptr, const int snum, T *rptr, const int rnum, const Comm &comm) {                                                                \
+        MEL_PROFILE_NOTE((MPI_Comm) comm, snum, D);                                                                                                            \
         MEL_THROW( MPI_Allgather(sptr, snum, D, rptr, rnum, D, (MPI_Comm) comm), "Comm::Allgather( " #T ", " #D " )" );                                        \
     }                                                                                                                                                        \
     inline void Allgatherv(T *sptr, const int snum, T *rptr, const int *rnum, const int *displ, const Comm &comm) {                                            \
+        MEL_PROFILE_NOTE((MPI_Comm) comm, snum, D);                                                                                                         \
         MEL_THROW( MPI_Allgatherv(sptr, snum, D, rptr, rnum, displ, D, (MPI_Comm) comm), "Comm::Allgatherv( " #T ", " #D " )" );                            \
     }                                                                                                                                                        \
     /* Alltoall / Alltoallv */                                                                                                                                \
     inline void Alltoall(T *sptr, const int snum, T *rptr, const int rnum, const Comm &comm) {                                                                \
+        MEL_PROFILE_NOTE((MPI_Comm) comm, snum, D);                                                                                                          \
         MEL_THROW( MPI_Alltoall(sptr, snum, D, rptr, rnum, D, (MPI_Comm) comm), "Comm::Alltoall( " #T ", " #D " )" );                                        \
     }                                                                                                                                                        \
     inline void Alltoallv(T *sptr, const int *snum, const int *sdispl, T *rptr, const int *rnum, const int *rdispl, const Comm &comm) {                        \
+        MEL_PROFILE_NOTE((MPI_Comm) comm, 0, MPI_DATATYPE_NULL);                                                                                               \
         MEL_THROW( MPI_Alltoallv(sptr, snum, sdispl, D, rptr, rnum, rdispl, D, (MPI_Comm) comm), "Comm::Alltoallv( " #T ", " #D " )" );                        \
     }                                                                                                                                                        \
     /* Reduce / Allreduce */                                                                                                                                \
     inline void Reduce(T *sptr, T *rptr, const int num, const Op &op, const int root, const Comm &comm) {                                                    \
+        MEL_PROFILE_NOTE((MPI_Comm) comm, num, D);                                                                                                            \
         MEL_THROW( MPI_Reduce(sptr, rptr, num, D, (MPI_Op) op, root, (MPI_Comm) comm), "Comm::Reduce( " #T ", " #D " )" );                                    \
     }                                                                                                                                                        \
     inline void Allreduce(T *sptr, T *rptr, const int num, const Op &op, const Comm &comm) {                                                                \
+        MEL_PROFILE_NOTE((MPI_Comm) comm, num, D);                                                                                                            \
         MEL_THROW( MPI_Allreduce(sptr, rptr, num, D, (MPI_Op) op, (MPI_Comm) comm), "Comm::Allreduce( " #T ", " #D " )" );                                    \
     }                                                                                                                                                        
 
 #define MEL_3_COLLECTIVE(T, D) inline void Ibcast(T *ptr, const int num, const int root, const Comm &comm, Request &rq) {                                    \
+        MEL_PROFILE_NOTE((MPI_Comm) comm, num, D);                                                                                                            \
         MEL_THROW( MPI_Ibcast(ptr, num, D, root, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Ibcast( " #T ", " #D " )" );                                    \
     }                                                                                                                                                        \
     inline Request Ibcast(T *ptr, const int num, const int root, const Comm &comm) {                                                                        \
@@ -5318,6 +6744,7 @@ namespace MEL {
     }                                                                                                                                                        \
     /* Scatter / Scatterv */                                                                                                                                \
     inline void Iscatter(T *sptr, const int snum, T *rptr, const int rnum, const int root, const Comm &comm, Request &rq) {                                    \
+        MEL_PROFILE_NOTE((MPI_Comm) comm, rnum, D);                                                                                                            \
         MEL_THROW( MPI_Iscatter(sptr, snum, D, rptr, rnum, D, root, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Iscatter( " #T ", " #D " )" );                \
     }                                                                                                                                                        \
     inline Request Iscatter(T *sptr, const int snum, T *rptr, const int rnum, const int root, const Comm &comm) {                                            \
@@ -5326,6 +6753,7 @@ namespace MEL {
         return rq;                                                                                                                                            \
     }                                                                                                                                                        \
     inline void Iscatterv(T *sptr, const int *snum, const int *displs, T *rptr, const int rnum, const int root, const Comm &comm, Request &rq) {            \
+        MEL_PROFILE_NOTE((MPI_Comm) comm, rnum, D);                                                                                                          \
         MEL_THROW( MPI_Iscatterv(sptr, snum, displs, D, rptr, rnum, D, root, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Iscatterv( " #T ", " #D " )" );    \
     }                                                                                                                                                        \
     inline Request Iscatterv(T *sptr, const int *snum, const int *displs, T *rptr, const int rnum, const int root, const Comm &comm) {                        \
@@ -5335,6 +6763,7 @@ namespace MEL {
     }                                                                                                                                                        \
     /* Gather / Gatherv */                                                                                                                                    \
     inline void Igather(T *sptr, const int snum, T *rptr, const int rnum, const int root, const Comm &comm, Request &rq) {                                    \
+        MEL_PROFILE_NOTE((MPI_Comm) comm, snum, D);                                                                                                          \
         MEL_THROW( MPI_Igather(sptr, snum, D, rptr, rnum, D, root, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Igather( " #T ", " #D " )" );                \
     }                                                                                                                                                        \
     inline Request Igather(T *sptr, const int snum, T *rptr, const int rnum, const int root, const Comm &comm) {                                            \
@@ -5343,6 +6772,7 @@ namespace MEL {
         return rq;                                                                                                                                            \
     }                                                                                                                                                        \
     inline void Igatherv(T *sptr, const int snum, T *rptr, const int *rnum, const int *displs, const int root, const Comm &comm, Request &rq) {                \
+        MEL_PROFILE_NOTE((MPI_Comm) comm, snum, D);                                                                                                            \
         MEL_THROW( MPI_Igatherv(sptr, snum, D, rptr, rnum, displs, D, root, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Igatherv( " #T ", " #D " )" );        \
     }                                                                                                                                                        \
     inline Request Igatherv(T *sptr, const int snum, T *rptr, const int *rnum, const int *displs, const int root, const Comm &comm) {                        \
@@ -5352,6 +6782,7 @@ namespace MEL {
     }                                                                                                                                                        \
     /* Allgather / Allgatherv */                                                                                                                            \
     inline void Iallgather(T *sptr, const int snum, T *rptr, const int rnum, const Comm &comm, Request &rq) {                                                \
+        MEL_PROFILE_NOTE((MPI_Comm) comm, snum, D);                                                                                                          \
         MEL_THROW( MPI_Iallgather(sptr, snum, D, rptr, rnum, D, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Iallgather( " #T ", " #D " )" );                \
     }                                                                                                                                                        \
     inline Request Iallgather(T *sptr, const int snum, T *rptr, const int rnum, const Comm &comm) {                                                            \
@@ -5360,6 +6791,7 @@ namespace MEL {
         return rq;                                                                                                                                            \
     }                                                                                                                                                        \
     inline void Iallgatherv(T *sptr, const int snum, T *rptr, const int *rnum, const int *displ, const Comm &comm, Request &rq) {                            \
+        MEL_PROFILE_NOTE((MPI_Comm) comm, snum, D);                                                                                                           \
         MEL_THROW( MPI_Iallgatherv(sptr, snum, D, rptr, rnum, displ, D, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Iallgatherv( " #T ", " #D " )" );        \
     }                                                                                                                                                        \
     inline Request Iallgatherv(T *sptr, const int snum, T *rptr, const int *rnum, const int *displ, const Comm &comm) {                                        \
@@ -5369,6 +6801,7 @@ namespace MEL {
     }                                                                                                                                                        \
     /* Alltoall / Alltoallv */                                                                                                                                \
     inline void Ialltoall(T *sptr, const int snum, T *rptr, const int rnum, const Comm &comm, Request &rq) {                                                \
+        MEL_PROFILE_NOTE((MPI_Comm) comm, snum, D);                                                                                                            \
         MEL_THROW( MPI_Ialltoall(sptr, snum, D, rptr, rnum, D, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Ialltoall( " #T ", " #D " )" );                    \
     }                                                                                                                                                        \
     inline Request Ialltoall(T *sptr, const int snum, T *rptr, const int rnum, const Comm &comm) {                                                            \
@@ -5377,6 +6810,7 @@ namespace MEL {
         return rq;                                                                                                                                            \
     }                                                                                                                                                        \
     inline void Ialltoallv(T *sptr, const int *snum, const int *sdispl, T *rptr, const int *rnum, const int *rdispl, const Comm &comm, Request &rq) {        \
+        MEL_PROFILE_NOTE((MPI_Comm) comm, 0, MPI_DATATYPE_NULL);                                                                                                 \
         MEL_THROW( MPI_Ialltoallv(sptr, snum, sdispl, D, rptr, rnum, rdispl, D, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Ialltoallv( " #T ", " #D " )" );    \
     }                                                                                                                                                        \
     inline Request Ialltoallv(T *sptr, const int *snum, const int *sdispl, T *rptr, const int *rnum, const int *rdispl, const Comm &comm) {                    \
@@ -5386,6 +6820,7 @@ namespace MEL {
     }                                                                                                                                                        \
     /* Reduce / Allreduce */                                                                                                                                \
     inline void Ireduce(T *sptr, T *rptr, const int num, const Op &op, const int root, const Comm &comm, Request &rq) {                                        \
+        MEL_PROFILE_NOTE((MPI_Comm) comm, num, D);                                                                                                          \
         MEL_THROW( MPI_Ireduce(sptr, rptr, num, D, (MPI_Op) op, root, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Ireduce( " #T ", " #D " )" );            \
     }                                                                                                                                                        \
     inline Request Ireduce(T *sptr, T *rptr, const int num, const Op &op, const int root, const Comm &comm) {                                                \
@@ -5394,6 +6829,7 @@ namespace MEL {
         return rq;                                                                                                                                            \
     }                                                                                                                                                        \
     inline void Iallreduce(T *sptr, T *rptr, const int num, const Op &op, const Comm &comm, Request &rq) {                                                    \
+        MEL_PROFILE_NOTE((MPI_Comm) comm, num, D);                                                                                                          \
         MEL_THROW( MPI_Iallreduce(sptr, rptr, num, D, (MPI_Op) op, (MPI_Comm) comm, (MPI_Request*) &rq), "Comm::Iallreduce( " #T ", " #D " )" );            \
     }                                                                                                                                                        \
     inline Request Iallreduce(T *sptr, T *rptr, const int num, const Op &op, const Comm &comm) {                                                            \
@@ -5463,7 +6899,38 @@ namespace MEL {
      */
     template<typename T>
     inline void Bcast(T *ptr, const int num, const int root, const Comm &comm) {
-        Bcast(ptr, num * sizeof(T), MEL::Datatype::CHAR, root, comm);
+        Bcast(ptr, TypeElements<T>(num), TypeElement<T>(), root, comm);
+    };
+
+    /**
+     * \ingroup COL
+     * Reduce an array of a struct registered with MEL_TYPE_FIELDS onto the root process
+     *
+     * \param[in] sptr				Pointer to the local array to reduce
+     * \param[out] rptr				Pointer to the memory to reduce into on the root process
+     * \param[in] num				The number of elements to reduce
+     * \param[in] op				The operation to reduce with, created over T with OpCreate
+     * \param[in] root				The rank of the process to reduce onto
+     * \param[in] comm				The comm world to reduce within
+     */
+    template<typename T>
+    inline typename std::enable_if<TypeFields<T>::registered>::type Reduce(T *sptr, T *rptr, const int num, const Op &op, const int root, const Comm &comm) {
+        Reduce(sptr, rptr, num, TypeOf<T>(), op, root, comm);
+    };
+
+    /**
+     * \ingroup COL
+     * Reduce an array of a struct registered with MEL_TYPE_FIELDS onto all processes
+     *
+     * \param[in] sptr				Pointer to the local array to reduce
+     * \param[out] rptr				Pointer to the memory to reduce into
+     * \param[in] num				The number of elements to reduce
+     * \param[in] op				The operation to reduce with, created over T with OpCreate
+     * \param[in] comm				The comm world to reduce within
+     */
+    template<typename T>
+    inline typename std::enable_if<TypeFields<T>::registered>::type Allreduce(T *sptr, T *rptr, const int num, const Op &op, const Comm &comm) {
+        Allreduce(sptr, rptr, num, TypeOf<T>(), op, comm);
     };
 
 #ifdef MEL_3
@@ -5480,7 +6947,7 @@ namespace MEL {
      */
     template<typename T>
     inline void Ibcast(T *ptr, const int num, const int root, const Comm &comm, Request &rq) {
-        Ibcast(ptr, num * sizeof(T), MEL::Datatype::CHAR, root, comm, rq);
+        Ibcast(ptr, TypeElements<T>(num), TypeElement<T>(), root, comm, rq);
     }; 
 
     /**
@@ -5495,7 +6962,262 @@ namespace MEL {
      */
     template<typename T>
     inline Request Ibcast(T *ptr, const int num, const int root, const Comm &comm) {
-        return Ibcast(ptr, num * sizeof(T), MEL::Datatype::CHAR, root, comm);
+        return Ibcast(ptr, TypeElements<T>(num), TypeElement<T>(), root, comm);
+    };
+
+#endif
+
+#ifdef MEL_3
+
+    /**
+     * \ingroup COL
+     * The node-aware layout of a comm world, used by the hierarchical collectives. Built collectively on first use by 
+     * CommGetHierarchy, or set with CommSetHierarchy, and cached on the comm as an attribute, so the node and leader comms are freed 
+     * along with the comm
+     */
+    struct CommHierarchy {
+        /// Processes that share memory with this process, ordered by rank in the parent comm
+        Comm node;
+        /// One process per node (node rank 0) ordered by rank in the parent comm. COMM_NULL on all other processes
+        Comm leaders;
+        int nodeRank, nodeSize, nodeIndex, numNodes;
+        /// Indexed by rank in the parent comm
+        std::vector<int> nodeOf, nodeRankOf;
+        /// Indexed by node
+        std::vector<int> nodeSizes, nodeOffsets;
+
+        /// True when every process is on its own node, or all processes share one node
+        inline bool flat() const {
+            return numNodes == 1 || numNodes == (int) nodeOf.size();
+        };
+    };
+
+    /// \cond HIDE
+    inline int CommHierarchyDelete(MPI_Comm, int, void *attr, void*) {
+        CommHierarchy *hierarchy = (CommHierarchy*) attr;
+        if (hierarchy->leaders.comm != MPI_COMM_NULL) MPI_Comm_free(&hierarchy->leaders.comm);
+        MPI_Comm_free(&hierarchy->node.comm);
+        delete hierarchy;
+        return MPI_SUCCESS;
+    };
+
+    inline int CommHierarchyKeyval() {
+        static int keyval = MPI_KEYVAL_INVALID;
+        if (keyval == MPI_KEYVAL_INVALID) {
+            MEL_THROW( MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN, CommHierarchyDelete, &keyval, nullptr), "Comm::CreateKeyval" );
+        }
+        return keyval;
+    };
+    /// \endcond
+
+    /**
+     * \ingroup COL
+     * Set the node-aware layout of a comm world from a given split into nodes, replacing any cached layout. Collective. Lets the 
+     * hierarchical collectives group processes by something other than shared memory, such as a socket or a modelled node
+     *
+     * \see MPI_Comm_set_attr
+     *
+     * \param[in] comm			The comm world to set the layout of
+     * \param[in] node			The comm of processes on the same node as this process, ordered by rank in comm. Owned by the layout from now on
+     * \return					Returns a reference to the cached layout, valid until comm is freed
+     */
+    inline const CommHierarchy& CommSetHierarchy(const Comm &comm, const Comm &node) {
+        CommHierarchy *hierarchy = new CommHierarchy();
+        const int size = CommSize(comm);
+
+        hierarchy->node      = node;
+        hierarchy->nodeRank  = CommRank(hierarchy->node);
+        hierarchy->nodeSize  = CommSize(hierarchy->node);
+        hierarchy->leaders   = CommSplit(comm, (hierarchy->nodeRank == 0) ? 0 : MPI_UNDEFINED);
+        hierarchy->nodeIndex = (hierarchy->nodeRank == 0) ? CommRank(hierarchy->leaders) : 0;
+        Bcast(&hierarchy->nodeIndex, 1, 0, hierarchy->node);
+
+        int local[2] = { hierarchy->nodeIndex, hierarchy->nodeRank };
+        std::vector<int> layout(2 * size);
+        Allgather(local, 2, Datatype::INT, &layout[0], 2, Datatype::INT, comm);
+
+        hierarchy->nodeOf.resize(size);
+        hierarchy->nodeRankOf.resize(size);
+        hierarchy->numNodes = 0;
+        for (int i = 0; i < size; ++i) {
+            hierarchy->nodeOf[i]     = layout[2 * i];
+            hierarchy->nodeRankOf[i] = layout[2 * i + 1];
+            hierarchy->numNodes      = std::max(hierarchy->numNodes, layout[2 * i] + 1);
+        }
+
+        hierarchy->nodeSizes.assign(hierarchy->numNodes, 0);
+        hierarchy->nodeOffsets.assign(hierarchy->numNodes, 0);
+        for (int i = 0; i < size; ++i) ++hierarchy->nodeSizes[hierarchy->nodeOf[i]];
+        for (int i = 1; i < hierarchy->numNodes; ++i) hierarchy->nodeOffsets[i] = hierarchy->nodeOffsets[i - 1] + hierarchy->nodeSizes[i - 1];
+
+        MEL_THROW( MPI_Comm_set_attr((MPI_Comm) comm, CommHierarchyKeyval(), hierarchy), "Comm::SetAttr" );
+        return *hierarchy;
+    };
+
+    /**
+     * \ingroup COL
+     * Get the node-aware layout of a comm world. The first call on a comm is collective and builds the node and leader comms, 
+     * later calls return the cached layout
+     *
+     * \see MPI_Comm_split_type, MPI_Comm_get_attr
+     *
+     * \param[in] comm			The comm world to get the layout of
+     * \return					Returns a reference to the cached layout, valid until comm is freed
+     */
+    inline const CommHierarchy& CommGetHierarchy(const Comm &comm) {
+        void *attr; int found;
+        MEL_THROW( MPI_Comm_get_attr((MPI_Comm) comm, CommHierarchyKeyval(), &attr, &found), "Comm::GetAttr" );
+        if (found) return *((CommHierarchy*) attr);
+        return CommSetHierarchy(comm, CommSplitShared(comm));
+    };
+
+    /**
+     * \ingroup COL
+     * Broadcast an array to all processes in comm, crossing the network once per node rather than once per process. The root's 
+     * node broadcasts first, then the node leaders, then every other node
+     *
+     * \see MPI_Bcast
+     *
+     * \param[in,out] ptr			Pointer to the memory receive into
+     * \param[in] num				The number of elements to broadcast
+     * \param[in] datatype			The derived datatype of the elements to broadcast
+     * \param[in] root				The rank of the process to send from
+     * \param[in] comm				The comm world to broadcast within
+     */
+    inline void HierarchicalBcast(void *ptr, const int num, const Datatype &datatype, const int root, const Comm &comm) {
+        const CommHierarchy &hierarchy = CommGetHierarchy(comm);
+        if (hierarchy.flat()) {
+            Bcast(ptr, num, datatype, root, comm);
+            return;
+        }
+
+        const int rootNode = hierarchy.nodeOf[root];
+        if (hierarchy.nodeIndex == rootNode) Bcast(ptr, num, datatype, hierarchy.nodeRankOf[root], hierarchy.node);
+        if (hierarchy.nodeRank == 0)         Bcast(ptr, num, datatype, rootNode, hierarchy.leaders);
+        if (hierarchy.nodeIndex != rootNode) Bcast(ptr, num, datatype, 0, hierarchy.node);
+    };
+
+    /**
+     * \ingroup COL
+     * Broadcast an array to all processes in comm, crossing the network once per node rather than once per process
+     *
+     * \param[in,out] ptr			Pointer to the memory receive into
+     * \param[in] num				The number of elements to broadcast
+     * \param[in] root				The rank of the process to send from
+     * \param[in] comm				The comm world to broadcast within
+     */
+    template<typename T>
+    inline void HierarchicalBcast(T *ptr, const int num, const int root, const Comm &comm) {
+        HierarchicalBcast(ptr, TypeElements<T>(num), TypeElement<T>(), root, comm);
+    };
+
+    /**
+     * \ingroup COL
+     * Reduce an array across all processes in comm and distribute the result, reducing within each node before crossing the network. 
+     * Processes are combined in node order rather than rank order so op must be commutative
+     *
+     * \see MPI_Reduce, MPI_Allreduce
+     *
+     * \param[in] sptr				Pointer to num elements to send, or MPI_IN_PLACE
+     * \param[out] rptr				Pointer to the receive buffer
+     * \param[in] num				The number of elements in the array
+     * \param[in] datatype			The derived datatype of the elements to reduce
+     * \param[in] op				The commutative operation to perform for the reduction
+     * \param[in] comm				The comm world to reduce within
+     */
+    inline void HierarchicalAllreduce(void *sptr, void *rptr, const int num, const Datatype &datatype, const Op &op, const Comm &comm) {
+        const CommHierarchy &hierarchy = CommGetHierarchy(comm);
+        if (hierarchy.flat()) {
+            Allreduce(sptr, rptr, num, datatype, op, comm);
+            return;
+        }
+
+        if (hierarchy.nodeRank == 0) {
+            Reduce(sptr, rptr, num, datatype, op, 0, hierarchy.node);
+            Allreduce(MPI_IN_PLACE, rptr, num, datatype, op, hierarchy.leaders);
+        }
+        else {
+            Reduce((sptr == MPI_IN_PLACE) ? rptr : sptr, nullptr, num, datatype, op, 0, hierarchy.node);
+        }
+        Bcast(rptr, num, datatype, 0, hierarchy.node);
+    };
+
+    /**
+     * \ingroup COL
+     * Gather an array from all processes in comm, gathering within each node before crossing the network. The blocks are staged 
+     * in node order as sdatatype and received on root through an indexed rdatatype that places each block at its rank's offset
+     *
+     * \see MPI_Gather, MPI_Gatherv
+     *
+     * \param[in] sptr				Pointer to snum elements to send
+     * \param[in] snum				The number of elements to send from each process
+     * \param[in] sdatatype			The derived datatype of the elements to send
+     * \param[out] rptr				Pointer to size * rnum elements to receive into, significant only on root
+     * \param[in] rnum				The number of elements to receive from each process
+     * \param[in] rdatatype			The derived datatype of the elements to receive
+     * \param[in] root				The rank of the process to gather onto
+     * \param[in] comm				The comm world to gather within
+     */
+    inline void HierarchicalGather(void *sptr, const int snum, const Datatype &sdatatype, void *rptr, const int rnum, const Datatype &rdatatype, const int root, const Comm &comm) {
+        const CommHierarchy &hierarchy = CommGetHierarchy(comm);
+        if (hierarchy.flat()) {
+            Gather(sptr, snum, sdatatype, rptr, rnum, rdatatype, root, comm);
+            return;
+        }
+
+        const int size = (int) hierarchy.nodeOf.size(), rootNode = hierarchy.nodeOf[root];
+        const Aint block = snum * TypeGetExtent(sdatatype);
+
+        /// Gather each node's blocks onto its leader, in node rank order
+        std::vector<char> nodeBlocks((hierarchy.nodeRank == 0) ? (block * hierarchy.nodeSize) : 1);
+        Gather(sptr, snum, sdatatype, &nodeBlocks[0], snum, sdatatype, 0, hierarchy.node);
+
+        /// Gather the node blocks onto the leader of the root's node, in node order
+        std::vector<char> allBlocks((hierarchy.nodeIndex == rootNode) ? (block * size) : 1);
+        if (hierarchy.nodeRank == 0) {
+            std::vector<int> counts(hierarchy.numNodes), displs(hierarchy.numNodes);
+            for (int i = 0; i < hierarchy.numNodes; ++i) {
+                counts[i] = hierarchy.nodeSizes[i] * snum;
+                displs[i] = hierarchy.nodeOffsets[i] * snum;
+            }
+            Gatherv(&nodeBlocks[0], hierarchy.nodeSize * snum, sdatatype, &allBlocks[0], &counts[0], &displs[0], sdatatype, rootNode, hierarchy.leaders);
+
+            if (hierarchy.nodeIndex == rootNode && hierarchy.nodeRankOf[root] != 0) {
+                Send(&allBlocks[0], size * snum, sdatatype, hierarchy.nodeRankOf[root], 0, hierarchy.node);
+            }
+        }
+
+        /// Receive the node ordered blocks straight into rank order
+        if (CommRank(comm) == root) {
+            std::vector<int> displs(size);
+            for (int i = 0; i < size; ++i) {
+                displs[hierarchy.nodeOffsets[hierarchy.nodeOf[i]] + hierarchy.nodeRankOf[i]] = i * rnum;
+            }
+            Datatype rankOrder = TypeCreateIndexedBlock(rdatatype, rnum, displs);
+
+            Request rq;
+            if (hierarchy.nodeRank == 0) Isend(&allBlocks[0], size * snum, sdatatype, 0, 0, hierarchy.node, rq);
+            Recv(rptr, 1, rankOrder, 0, 0, hierarchy.node);
+            if (hierarchy.nodeRank == 0) Wait(rq);
+
+            TypeFree(rankOrder);
+        }
+    };
+
+    /**
+     * \ingroup COL
+     * Gather an array from all processes in comm, gathering within each node before crossing the network
+     *
+     * \param[in] sptr				Pointer to snum elements to send
+     * \param[in] snum				The number of elements to send from each process
+     * \param[out] rptr				Pointer to size * rnum elements to receive into, significant only on root
+     * \param[in] rnum				The number of elements to receive from each process
+     * \param[in] root				The rank of the process to gather onto
+     * \param[in] comm				The comm world to gather within
+     */
+    template<typename T>
+    inline void HierarchicalGather(T *sptr, const int snum, T *rptr, const int rnum, const int root, const Comm &comm) {
+        HierarchicalGather(sptr, TypeElements<T>(snum), TypeElement<T>(), rptr, TypeElements<T>(rnum), TypeElement<T>(), root, comm);
     };
 
 #endif
@@ -5744,6 +7466,7 @@ namespace MEL {
      * \param[in] win				The window to put into
      */
     inline void Put(void *origin_ptr, int origin_num, const Datatype &origin_datatype, const Aint target_disp, const int target_num, const Datatype &target_datatype, const int target_rank, const Win &win) {
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, origin_num, (MPI_Datatype) origin_datatype);
         MEL_THROW( MPI_Put(origin_ptr, origin_num, (MPI_Datatype) origin_datatype, target_rank, target_disp, target_num, (MPI_Datatype) target_datatype, (MPI_Win) win), "RMA::Put" );
     };
 
@@ -5764,6 +7487,7 @@ namespace MEL {
      * \param[in] win				The window to put into
      */
     inline void Accumulate(void *origin_ptr, int origin_num, const Datatype &origin_datatype, const Aint target_disp, const int target_num, const Datatype &target_datatype, const Op &op, const int target_rank, const Win &win) {
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, origin_num, (MPI_Datatype) origin_datatype);
         MEL_THROW( MPI_Accumulate(origin_ptr, origin_num, (MPI_Datatype) origin_datatype, target_rank, target_disp, target_num, (MPI_Datatype) target_datatype, (MPI_Op) op, (MPI_Win) win), "RMA::Accumulate" );
     };
 
@@ -5783,6 +7507,7 @@ namespace MEL {
      * \param[in] win				The window to get from
      */
     inline void Get(void *origin_ptr, int origin_num, const Datatype &origin_datatype, const Aint target_disp, const int target_num, const Datatype &target_datatype, const int target_rank, const Win &win) {
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, origin_num, (MPI_Datatype) origin_datatype);
         MEL_THROW( MPI_Get(origin_ptr, origin_num, (MPI_Datatype) origin_datatype, target_rank, target_disp, target_num, (MPI_Datatype) target_datatype, (MPI_Win) win), "RMA::Get" );
     };
 
@@ -5902,6 +7627,7 @@ namespace MEL {
      * \param[out] rq				A request object
      */
     inline void Rput(void *origin_ptr, int origin_num, const Datatype &origin_datatype, const Aint target_disp, const int target_num, const Datatype &target_datatype, const int target_rank, const Win &win, Request &rq) {
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, origin_num, (MPI_Datatype) origin_datatype);
         MEL_THROW(MPI_Rput(origin_ptr, origin_num, (MPI_Datatype) origin_datatype, target_rank, target_disp, target_num, (MPI_Datatype) target_datatype, (MPI_Win) win, (MPI_Request*) &rq), "RMA::Rput");
     };
 
@@ -5942,6 +7668,7 @@ namespace MEL {
      * \param[out] rq				A request object
      */
     inline void Rget(void *origin_ptr, int origin_num, const Datatype &origin_datatype, const Aint target_disp, const int target_num, const Datatype &target_datatype, const int target_rank, const Win &win, Request &rq) {
+        MEL_PROFILE_NOTE(MPI_COMM_NULL, origin_num, (MPI_Datatype) origin_datatype);
         MEL_THROW(MPI_Rget(origin_ptr, origin_num, (MPI_Datatype) origin_datatype, target_rank, target_disp, target_num, (MPI_Datatype) target_datatype, (MPI_Win) win, (MPI_Request*) &rq), "RMA::Rget");
     };
     
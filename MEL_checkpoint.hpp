@@ -0,0 +1,175 @@
+/*
+The MIT License(MIT)
+
+Copyright(c) 2016 Joss Whittle
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "MEL.hpp"
+#include "MEL_deepcopy.hpp"
+
+#include <string>
+#include <vector>
+
+namespace MEL {
+    namespace Deep {
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Checkpoint
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        // Timings in seconds, accumulated over every checkpoint taken by a Checkpointer on this process
+        struct CheckpointStats {
+            long long checkpoints, bytes;
+            double    packTime, issueTime, waitTime;
+
+            CheckpointStats() : checkpoints(0), bytes(0), packTime(0), issueTime(0), waitTime(0) {};
+        };
+
+        // Asynchronous double-buffered checkpointing of a deep object to a shared file per checkpoint. write() packs into one of
+        // two buffers, opens the next file in the rotation and issues non-blocking MPI_File_iwrite_at calls, then returns. The
+        // previous checkpoint is completed and its file closed at the start of the next write(), by wait(), or on destruction,
+        // so only the time spent blocked there (waitTime) is not overlapped with computation. Files are named prefix.0 ...
+        // prefix.(numFiles - 1) and use the FileWriteAll layout, so a completed checkpoint can be read back with Deep::FileReadAll.
+        // numFiles must be at least 2, so the file being rewritten is never the only complete checkpoint. write() and wait() are 
+        // collective over comm
+        class Checkpointer {
+        private:
+            struct Slot {
+                std::vector<char>    buffer;
+                char                 index[FILE_COLLECTIVE_HEADER + sizeof(FileCollectiveEntry)];
+                std::vector<Request> requests;
+                MEL::File            file;
+                bool                 pending;
+
+                Slot() : pending(false) {};
+            };
+
+            /// Members
+            const MEL::Comm comm;
+            const std::string prefix;
+            const int numFiles;
+            int next, last;
+            Slot slots[2];
+            CheckpointStats stats;
+
+            inline void complete(Slot &slot) {
+                if (!slot.pending) return;
+                const double start = MEL::Wtime();
+                MEL::Waitall(slot.requests);
+                slot.requests.clear();
+                MEL::FileClose(slot.file);
+                slot.pending = false;
+                stats.waitTime += MEL::Wtime() - start;
+            };
+
+            inline void issue(Slot &slot, const int len, const int fileIndex) {
+                const int rank = MEL::CommRank(comm), size = MEL::CommSize(comm);
+                long long bytes = len, start = 0;
+                MEL::Exscan(&bytes, &start, 1, MEL::Datatype::LONG_LONG, MEL::Op::SUM, comm);
+                if (rank == 0) start = 0;
+
+                slot.file = MEL::FileOpen(comm, getPath(fileIndex), MEL::FileMode::CREATE | MEL::FileMode::WRONLY);
+                MEL::FileSetSize(slot.file, 0);
+
+                const MEL::Offset dataOffset = FILE_COLLECTIVE_HEADER + (MEL::Offset) size * sizeof(FileCollectiveEntry);
+                FileCollectiveEntry entry = { dataOffset + start, bytes };
+                long long numPieces = size;
+                memcpy(slot.index, "MELDEEPA", 8);
+                memcpy(slot.index + 8, &numPieces, sizeof(long long));
+                memcpy(slot.index + FILE_COLLECTIVE_HEADER, &entry, sizeof(entry));
+
+                if (rank == 0) slot.requests.push_back(MEL::FileIwriteAt(slot.file, 0, slot.index, sizeof(slot.index), MEL::Datatype::CHAR));
+                else           slot.requests.push_back(MEL::FileIwriteAt(slot.file, FILE_COLLECTIVE_HEADER + (MEL::Offset) rank * sizeof(entry), slot.index + FILE_COLLECTIVE_HEADER, sizeof(entry), MEL::Datatype::CHAR));
+                if (len > 0) slot.requests.push_back(MEL::FileIwriteAt(slot.file, dataOffset + start, &slot.buffer[0], len, MEL::Datatype::CHAR));
+                slot.pending = true;
+            };
+
+        public:
+            Checkpointer(const MEL::Comm &_comm, const std::string &_prefix, const int _numFiles = 2)
+                : comm(_comm), prefix(_prefix), numFiles(_numFiles), next(0), last(-1) {
+                if (numFiles < 2) MEL::Abort(-1, "MEL::Deep::Checkpointer : numFiles must be at least 2, or a crash while writing would leave no complete checkpoint...");
+            };
+
+            ~Checkpointer() {
+                wait();
+            };
+
+            Checkpointer(const Checkpointer &)            = delete;
+            Checkpointer& operator=(const Checkpointer &) = delete;
+
+            template<typename T>
+            inline void write(T &obj) {
+                Slot &slot = slots[next % 2], &previous = slots[(next + 1) % 2];
+
+                /// Pack while the previous checkpoint may still be in flight from the other buffer
+                double start = MEL::Wtime();
+                complete(slot);
+                const int bufferSize = MEL::Deep::BufferSize(obj);
+                if ((int) slot.buffer.size() < bufferSize) slot.buffer.resize(bufferSize);
+                int len = 0;
+                if (bufferSize > 0) {
+                    Message<TransportBufferWrite> msg(&slot.buffer[0], bufferSize);
+                    msg.packRootVar(obj);
+                    len = msg.getOffset();
+                }
+                stats.packTime += MEL::Wtime() - start;
+
+                /// Keep one checkpoint in flight so a file in the rotation is never being written twice
+                complete(previous);
+
+                start = MEL::Wtime();
+                issue(slot, len, next % numFiles);
+                stats.issueTime += MEL::Wtime() - start;
+
+                ++stats.checkpoints;
+                stats.bytes += len;
+                last = next % numFiles;
+                ++next;
+            };
+
+            // Give the MPI library a chance to progress the outstanding writes without blocking
+            inline bool progress() {
+                bool done = true;
+                for (auto &slot : slots) if (slot.pending) done = MEL::Testall(slot.requests) && done;
+                return done;
+            };
+
+            inline void wait() {
+                complete(slots[0]);
+                complete(slots[1]);
+            };
+
+            inline std::string getPath(const int fileIndex) const {
+                return prefix + "." + std::to_string(fileIndex);
+            };
+
+            // Path of the most recent checkpoint, complete once wait() or the next write() returns
+            inline std::string getLastPath() const {
+                return (last >= 0) ? getPath(last) : std::string();
+            };
+
+            inline const CheckpointStats& getStats() const {
+                return stats;
+            };
+        };
+    };
+};
@@ -27,14 +27,25 @@ SOFTWARE.
 
 #include <vector>
 #include <list>
+#include <deque>
+#include <array>
+#include <map>
+#include <set>
 #include <fstream>
 #include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <cstdint>
+#include <climits>
 
 namespace MEL {
     namespace Deep {
 
         /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+        // The transports move each block as raw bytes. The typed MEL::Send / Recv / Bcast would use the MPI struct type of a 
+        // type registered with MEL_TYPE_FIELDS, which covers only its listed fields and would drop the pointers DeepCopy relies on
+
         class TransportSend {
         private:
             /// Members
@@ -48,24 +59,36 @@ namespace MEL {
 
             template<typename T>
             inline void transport(T *&ptr, const int len) {
-                MEL::Send(ptr, len, pid, tag, comm);
+                MEL::Send((void*) ptr, len * sizeof(T), MEL::Datatype::CHAR, pid, tag, comm);
             };
         };
 
         class TransportRecv {
         private:
             /// Members
-            const int pid, tag;
+            int pid, tag;
             const MEL::Comm comm;
+            MEL::Status status;
 
         public:
             static constexpr bool SOURCE = false;
 
-            TransportRecv(const int _pid, const int _tag, const MEL::Comm &_comm) : pid(_pid), tag(_tag), comm(_comm) {};
+            TransportRecv(const int _pid, const int _tag, const MEL::Comm &_comm) : pid(_pid), tag(_tag), comm(_comm), status{} {
+                status.MPI_SOURCE = _pid;
+                status.MPI_TAG    = _tag;
+            };
 
+            // A deep message is a sequence of envelopes on one (source, tag) pair. Once the first has been matched against
+            // MEL::ANY_SOURCE / MEL::ANY_TAG the rest are pinned to that sender, so concurrent senders cannot interleave
             template<typename T>
             inline void transport(T *&ptr, const int len) {
-                MEL::Recv(ptr, len, pid, tag, comm);
+                status = MEL::Recv((void*) ptr, len * sizeof(T), MEL::Datatype::CHAR, pid, tag, comm);
+                pid    = status.MPI_SOURCE;
+                tag    = status.MPI_TAG;
+            };
+
+            inline MEL::Status getStatus() const {
+                return status;
             };
         };
 
@@ -82,7 +105,7 @@ namespace MEL {
 
             template<typename T>
             inline void transport(T *&ptr, const int len) {
-                MEL::Bcast(ptr, len, root, comm);
+                MEL::Bcast((void*) ptr, len * sizeof(T), MEL::Datatype::CHAR, root, comm);
             };
         };
 
@@ -99,23 +122,123 @@ namespace MEL {
 
             template<typename T>
             inline void transport(T *&ptr, const int len) {
-                MEL::Bcast(ptr, len, root, comm);
+                MEL::Bcast((void*) ptr, len * sizeof(T), MEL::Datatype::CHAR, root, comm);
+            };
+        };
+
+#ifdef MEL_3
+        class TransportHierarchicalBcastRoot {
+        private:
+            /// Members
+            const int root;
+            const MEL::Comm comm;
+            
+        public:
+            static constexpr bool SOURCE = true;
+
+            TransportHierarchicalBcastRoot(const int _root, const MEL::Comm &_comm) : root(_root), comm(_comm) {};
+
+            template<typename T>
+            inline void transport(T *&ptr, const int len) {
+                MEL::HierarchicalBcast((void*) ptr, len * sizeof(T), MEL::Datatype::CHAR, root, comm);
+            };
+        };
+
+        class TransportHierarchicalBcast {
+        private:
+            /// Members
+            const int root;
+            const MEL::Comm comm;
+
+        public:
+            static constexpr bool SOURCE = false;
+
+            TransportHierarchicalBcast(const int _root, const MEL::Comm &_comm) : root(_root), comm(_comm) {};
+
+            template<typename T>
+            inline void transport(T *&ptr, const int len) {
+                MEL::HierarchicalBcast((void*) ptr, len * sizeof(T), MEL::Datatype::CHAR, root, comm);
             };
         };
+#endif
+
+        // Block sizes used by TransportFileWrite / TransportFileRead. Visited chunks are combined into writeBlock sized writes, aligned 
+        // to writeBlock in the file (set it to the file system stripe size), and reads are served from read-ahead that starts at 
+        // FILE_READ_AHEAD bytes and doubles on each refill up to readBlock, so reading a small object does not pay for a whole 
+        // block. Memory use stays bounded by the block size, and 0 disables the buffering so every chunk is its own MPI-IO call
+        struct FileTransportConfig {
+            int writeBlock, readBlock;
+
+            FileTransportConfig() : writeBlock(1 << 22), readBlock(1 << 22) {};
+        };
+
+        inline FileTransportConfig& GetFileTransportConfig() {
+            static FileTransportConfig config;
+            return config;
+        };
+
+        static constexpr int FILE_READ_AHEAD = 1 << 12;
 
         class TransportFileWrite {
         private:
             /// Members
             const MEL::File file;
+            const int blockSize;
+            int used, capacity;
+            char *buffer;
+
+            inline void flush() {
+                if (used > 0) MEL::FileWrite(file, buffer, used, MEL::Datatype::CHAR);
+                used = 0;
+                capacity = blockSize;
+            };
 
         public:
             static constexpr bool SOURCE = true;
 
-            TransportFileWrite(const MEL::File &_file) : file(_file) {};
+            TransportFileWrite(const MEL::File &_file) : file(_file), blockSize(GetFileTransportConfig().writeBlock), used(0), capacity(0), buffer(nullptr) {
+                if (blockSize > 0) {
+                    /// The first block ends on a block boundary in the file, so every later flush is aligned
+                    buffer   = MEL::MemAlloc<char>(blockSize);
+                    capacity = blockSize - (int) (MEL::FileGetByteOffset(file, MEL::FileGetPosition(file)) % blockSize);
+                }
+            };
+            ~TransportFileWrite() {
+                if (buffer != nullptr) {
+                    flush();
+                    MEL::MemFree(buffer);
+                }
+            };
+
+            TransportFileWrite(const TransportFileWrite &)            = delete;
+            TransportFileWrite& operator=(const TransportFileWrite &) = delete;
 
             template<typename T>
             inline void transport(T *&ptr, const int len) {
-                MEL::FileWrite(file, ptr, len);
+                if (buffer == nullptr) {
+                    MEL::FileWrite(file, ptr, len);
+                    return;
+                }
+
+                const char *src = (const char*) ptr;
+                int num = len * sizeof(T);
+                while (num > 0) {
+                    /// Chunks that cover whole blocks bypass the buffer once it is empty
+                    if (used == 0 && num >= capacity) {
+                        const int direct = capacity + ((num - capacity) / blockSize) * blockSize;
+                        MEL::FileWrite(file, src, direct, MEL::Datatype::CHAR);
+                        src += direct;
+                        num -= direct;
+                        capacity = blockSize;
+                        continue;
+                    }
+                    const int n = std::min(num, capacity - used);
+                    memcpy(buffer + used, src, n);
+                    used += n;
+                    src  += n;
+                    num  -= n;
+                    if (used == capacity) flush();
+                }
             };
         };
 
@@ -123,15 +246,72 @@ namespace MEL {
         private:
             /// Members
             const MEL::File file;
+            const int blockSize;
+            int window, capacity, begin, end;
+            MEL::Offset remaining;
+            char *buffer;
+
+            /// Read-ahead is bounded by the bytes left in the file rather than the status of a short read. The buffer is empty 
+            /// whenever this is called, so growing it need not keep its contents
+            inline void fill() {
+                if (window > capacity) {
+                    MEL::MemFree(buffer);
+                    buffer   = MEL::MemAlloc<char>(window);
+                    capacity = window;
+                }
+                begin  = 0;
+                end    = (int) std::min<MEL::Offset>(window, remaining);
+                if (end > 0) MEL::FileRead(file, buffer, end, MEL::Datatype::CHAR);
+                remaining -= end;
+                window     = (window < (blockSize / 2)) ? (window * 2) : blockSize;
+            };
 
         public:
             static constexpr bool SOURCE = false;
 
-            TransportFileRead(const MEL::File &_file) : file(_file) {};
+            TransportFileRead(const MEL::File &_file) : file(_file), blockSize(GetFileTransportConfig().readBlock), window(0), capacity(0), 
+                                                        begin(0), end(0), remaining(0), buffer(nullptr) {
+                if (blockSize > 0) {
+                    window    = std::min(FILE_READ_AHEAD, blockSize);
+                    remaining = MEL::FileGetSize(file) - MEL::FileGetByteOffset(file, MEL::FileGetPosition(file));
+                }
+            };
+            ~TransportFileRead() {
+                /// Leave the file pointer just after the last byte consumed rather than at the end of the read-ahead
+                if (end > begin) MEL::FileSeek(file, -(MEL::Offset) (end - begin), MEL::SeekMode::CUR);
+                MEL::MemFree(buffer);
+            };
+
+            TransportFileRead(const TransportFileRead &)            = delete;
+            TransportFileRead& operator=(const TransportFileRead &) = delete;
 
             template<typename T>
             inline void transport(T *&ptr, const int len) {
-                MEL::FileRead(file, ptr, len);
+                if (blockSize <= 0) {
+                    MEL::FileRead(file, ptr, len);
+                    return;
+                }
+
+                char *dst = (char*) ptr;
+                int num = len * sizeof(T);
+                while (num > 0) {
+                    if (begin == end) {
+                        /// Chunks of at least the read-ahead window are read straight into place
+                        if (num >= window) {
+                            if (num > remaining) MEL::Abort(-1, "TransportFileRead : Unexpected end of file...");
+                            MEL::FileRead(file, dst, num, MEL::Datatype::CHAR);
+                            remaining -= num;
+                            return;
+                        }
+                        fill();
+                        if (begin == end) MEL::Abort(-1, "TransportFileRead : Unexpected end of file...");
+                    }
+                    const int n = std::min(num, end - begin);
+                    memcpy(dst, buffer + begin, n);
+                    begin += n;
+                    dst   += n;
+                    num   -= n;
+                }
             };
         };
 
@@ -262,7 +442,150 @@ namespace MEL {
         
         /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-        template<typename TRANSPORT_METHOD, typename HASH_MAP = MEL::Deep::PointerHashMap>
+        // Default allocation policy for received pointers, one MPI_Alloc_mem per pointer. Free the graph with MEL::MemDestruct / MEL::MemFree
+        class MemAllocator {
+        public:
+            /// Pointers must be allocated one by one so each can be freed on its own
+            static constexpr bool CONTIGUOUS = false;
+
+            template<typename T>
+            inline T* alloc(const int len) {
+                return MEL::MemAlloc<T>(len);
+            };
+        };
+
+        // Carves received pointers out of a few large blocks allocated with MEL::MemAlloc. release() frees every block at once, 
+        // without walking the graph. Destructors of the received objects are not run, so members that own their own memory 
+        // (such as std::vector) are not freed by it
+        class Arena {
+        private:
+            struct Block {
+                char  *ptr;
+                size_t size, used;
+            };
+
+            /// Members
+            std::vector<Block> blocks;
+            size_t blockSize, bytesUsed;
+
+            inline void addBlock(const size_t size) {
+                Block block;
+                block.size = std::max(size, blockSize);
+                block.used = 0;
+                block.ptr  = MEL::MemAlloc<char>(block.size);
+                blocks.push_back(block);
+            };
+
+        public:
+            explicit Arena(const size_t _blockSize = 1 << 20) : blockSize(_blockSize), bytesUsed(0) {};
+            ~Arena() {
+                release();
+            };
+
+            Arena(const Arena &)            = delete;
+            Arena& operator=(const Arena &) = delete;
+
+            // Make sure at least bytes can be allocated without starting another block
+            inline void reserve(const size_t bytes) {
+                if (blocks.empty() || (blocks.back().size - blocks.back().used) < bytes) addBlock(bytes);
+            };
+
+            // Make sure a graph unpacked from packedBytes of buffer fits without starting another block. No allocation is larger 
+            // than the bytes it was unpacked from, and each pads to its alignment by less than its own size
+            inline void reservePacked(const size_t packedBytes) {
+                reserve(2 * packedBytes);
+            };
+
+            template<typename T>
+            inline T* alloc(const int len) {
+                const size_t align = alignof(T), bytes = len * sizeof(T);
+                if (!blocks.empty()) {
+                    Block &block = blocks.back();
+                    const size_t offset = (block.used + align - 1) & ~(align - 1);
+                    if ((offset + bytes) <= block.size) {
+                        block.used = offset + bytes;
+                        bytesUsed += bytes;
+                        return (T*) (block.ptr + offset);
+                    }
+                }
+                addBlock(bytes);
+                blocks.back().used = bytes;
+                bytesUsed += bytes;
+                return (T*) blocks.back().ptr;
+            };
+
+            inline void release() {
+                for (auto &block : blocks) MEL::MemFree(block.ptr);
+                blocks.clear();
+                bytesUsed = 0;
+            };
+
+            inline size_t getBytesUsed() const {
+                return bytesUsed;
+            };
+
+            inline int getNumBlocks() const {
+                return (int) blocks.size();
+            };
+        };
+
+        // Allocation policy that forwards to the Arena bound with bind()
+        class ArenaAllocator {
+        private:
+            /// Members
+            Arena *arena;
+
+        public:
+            /// Pointers may be carved from one shared allocation, as they are only ever freed all at once
+            static constexpr bool CONTIGUOUS = true;
+
+            ArenaAllocator() : arena(nullptr) {};
+
+            inline void bind(Arena &_arena) {
+                arena = &_arena;
+            };
+
+            template<typename T>
+            inline T* alloc(const int len) {
+                if (arena == nullptr) MEL::Abort(-1, "ArenaAllocator : No arena bound...");
+                return arena->template alloc<T>(len);
+            };
+        };
+
+        // Order in which Message visits pointers. Depth-first (the default) transports and recurses into each pointer as it is 
+        // packed. Breadth-first queues packPtr targets and, once the outermost packRoot call returns, transports every queued 
+        // target of the same type and level as one chunk before visiting their members. Received graphs are then allocated 
+        // level by level, and contiguously per type and level when allocating from an Arena. Both ends of a message (or the 
+        // writer and reader of a file) must use the same order. 
+        //
+        // Iterative keeps depth-first order, and so the same bytes, but drives it from an explicit worklist on the heap rather 
+        // than the native stack, so lists and degenerate trees of any depth can be copied. Only the side with the deep 
+        // structure needs it enabled. It has no effect when breadthFirst is set. Pointers are still followed by recursion until 
+        // a traversal has used iterativeStack bytes of stack, which keeps balanced structures off the worklist; set it to 0 to 
+        // always use the worklist.
+        //
+        // In breadth-first or iterative order a DeepCopy method must pass members themselves (not local copies) to the pack 
+        // functions, and must not read through a pointer it has just packed. Iterative order also defers containers of deep 
+        // types, and containers of other types packed after a deferred member, so those must not be read in DeepCopy either
+        //
+        // In place receives update the structure the receiver already holds rather than building a new one. Pointers that 
+        // the receiver already had at the same length, strings, std::vector and std::unique_ptr members keep their memory, 
+        // and only pointers and containers whose sizes differ are allocated again. It affects receiving messages only, 
+        // uses depth-first order (so no effect when breadthFirst is set), and a root pointer is reused when one object is 
+        // received into it. Memory beneath a pointer that is not reused is not freed, just as for any other receive
+        struct TraversalConfig {
+            bool breadthFirst, iterative, inPlace;
+            size_t iterativeStack;
+
+            TraversalConfig() : breadthFirst(false), iterative(false), inPlace(false), iterativeStack(1 << 16) {};
+        };
+
+        inline TraversalConfig& GetTraversalConfig() {
+            static TraversalConfig config;
+            return config;
+        };
+
+        template<typename TRANSPORT_METHOD, typename HASH_MAP = MEL::Deep::PointerHashMap, typename ALLOCATOR = MEL::Deep::MemAllocator>
         class Message;
 
         template<typename T>
@@ -301,28 +624,373 @@ namespace MEL {
         template<typename T> struct is_list : public std::false_type {};
         template<typename T, typename A>
         struct is_list<std::list<T, A>> : public std::true_type{};
-        //template <typename T>
-        //using is_string = typename std::is_same<T, std::string>;
+
+        template<typename T> struct is_deque : public std::false_type {};
+        template<typename T, typename A>
+        struct is_deque<std::deque<T, A>> : public std::true_type{};
+
+        template<typename T> struct is_std_array : public std::false_type {};
+        template<typename T, size_t N>
+        struct is_std_array<std::array<T, N>> : public std::true_type{};
+
+        template<typename T> struct is_map : public std::false_type {};
+        template<typename K, typename V, typename C, typename A>
+        struct is_map<std::map<K, V, C, A>> : public std::true_type{};
+        template<typename K, typename V, typename H, typename E, typename A>
+        struct is_map<std::unordered_map<K, V, H, E, A>> : public std::true_type{};
+
+        template<typename T> struct is_set : public std::false_type {};
+        template<typename K, typename C, typename A>
+        struct is_set<std::set<K, C, A>> : public std::true_type{};
+        template<typename K, typename H, typename E, typename A>
+        struct is_set<std::unordered_set<K, H, E, A>> : public std::true_type{};
+
+        template<typename T> struct is_string : public std::false_type {};
+        template<>           struct is_string<std::string> : public std::true_type {};
+
+        template<typename T> struct is_smart_ptr : public std::false_type {};
+        template<typename T>
+        struct is_smart_ptr<std::unique_ptr<T>> : public std::true_type{};
+        template<typename T>
+        struct is_smart_ptr<std::shared_ptr<T>> : public std::true_type{};
+
+        // Containers that can be the root of a message
+        template<typename T>
+        struct is_stl : public std::integral_constant<bool, is_vector<T>::value || is_list<T>::value || is_deque<T>::value 
+                                                          || is_std_array<T>::value || is_map<T>::value || is_set<T>::value> {};
+
+        // Members rebuilt by Message::packSTL, as their own bytes are not enough to copy them
+        template<typename T>
+        struct is_member_stl : public std::integral_constant<bool, is_stl<T>::value || is_string<T>::value || is_smart_ptr<T>::value> {};
+
+        // Elements that own more than their own bytes and must be visited after they are transported
+        template<typename T>
+        struct NeedsVisit : public std::integral_constant<bool, HasDeepCopyMethod<T>::Has || is_member_stl<T>::value> {};
         
         template<typename T, typename R = void>
-        using enable_if_stl = typename std::enable_if<is_vector<T>::value || is_list<T>::value, R>::type; //  || is_string<T>::value
+        using enable_if_stl = typename std::enable_if<is_stl<T>::value, R>::type;
         template<typename T, typename R = void>
-        using enable_if_not_pointer_not_stl = typename std::enable_if<!(is_vector<T>::value || is_list<T>::value) && !std::is_pointer<T>::value, R>::type; //  || is_string<T>::value
+        using enable_if_not_pointer_not_stl = typename std::enable_if<!is_stl<T>::value && !std::is_pointer<T>::value, R>::type;
         template<typename T, typename R = void>
-        using enable_if_deep_not_pointer_not_stl = typename std::enable_if<HasDeepCopyMethod<T>::Has && !(is_vector<T>::value || is_list<T>::value) && !std::is_pointer<T>::value, R>::type; //  || is_string<T>::value
+        using enable_if_deep_not_pointer_not_stl = typename std::enable_if<HasDeepCopyMethod<T>::Has && !is_stl<T>::value && !std::is_pointer<T>::value, R>::type;
 
-        template<typename T, typename TRANSPORT_METHOD, typename HASH_MAP>
-        using DEEP_FUNCTOR = void(*)(T&, MEL::Deep::Message<TRANSPORT_METHOD, HASH_MAP>&); 
+        template<typename T, typename TRANSPORT_METHOD, typename HASH_MAP, typename ALLOCATOR = MEL::Deep::MemAllocator>
+        using DEEP_FUNCTOR = void(*)(T&, MEL::Deep::Message<TRANSPORT_METHOD, HASH_MAP, ALLOCATOR>&); 
 
         /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-        template<typename TRANSPORT_METHOD, typename HASH_MAP>
+        template<typename TRANSPORT_METHOD, typename HASH_MAP, typename ALLOCATOR>
         class Message {
         private:
             /// Members
             int              offset;
             TRANSPORT_METHOD transporter;
             HASH_MAP         pointerMap;
+            ALLOCATOR        allocator;
+
+            /// Breadth-first traversal
+            struct PendingBase {
+                const void *key;
+
+                virtual ~PendingBase() {};
+                virtual void flush(Message &msg) = 0;
+            };
+
+            template<typename T, void(*V)(T&, Message&)>
+            struct Pending : public PendingBase {
+                std::vector<std::pair<T**, int>> slots;
+
+                static inline const void* Key() {
+                    static const char key = 0;
+                    return &key;
+                };
+
+                inline void flush(Message &msg) {
+                    msg. template flushPending<T, V>(slots);
+                };
+            };
+
+            // Packs in place, without queueing or deferring anything, for objects that are moved once they have been packed
+            struct DirectScope {
+                Message    &msg;
+                const bool breadthFirst, iterative;
+
+                DirectScope(Message &_msg) : msg(_msg), breadthFirst(_msg.breadthFirst), iterative(_msg.iterative) {
+                    msg.breadthFirst = false;
+                    msg.iterative    = false;
+                };
+                ~DirectScope() {
+                    msg.breadthFirst = breadthFirst;
+                    msg.iterative    = iterative;
+                };
+            };
+
+            // Elements rebuilt from the sender's bytes are visited under an empty frame, so an in place receive never revives 
+            // records of the enclosing object at their addresses
+            struct FreshScope {
+                Message    &msg;
+                const bool active;
+
+                FreshScope(Message &_msg) : msg(_msg), active(!TRANSPORT_METHOD::SOURCE && !_msg.frames.empty()) {
+                    if (!active) return;
+                    const size_t records = msg.recordPool.size();
+                    msg.frames.push_back({ nullptr, 0, msg.backupPool.size(), records, records, records });
+                };
+                ~FreshScope() {
+                    if (active) msg.frames.pop_back();
+                };
+            };
+
+            struct RootScope {
+                Message &msg;
+
+                RootScope(Message &_msg) : msg(_msg) {
+                    ++msg.rootDepth;
+                };
+                ~RootScope() {
+                    if (--msg.rootDepth == 0 && msg.breadthFirst) msg.drain();
+                };
+            };
+
+            bool                                      breadthFirst;
+            int                                       rootDepth;
+
+            /// In place receive
+            struct Record {
+                size_t offset;
+                int    len;
+            };
+
+            // Elements being received in place. Records of their previous members and a copy of their previous bytes are 
+            // kept in recordPool and backupPool, from the indices given, so that nested frames share the same storage
+            struct Frame {
+                char   *base;
+                size_t size, backup, records, recordsEnd, cursor;
+            };
+
+            bool                                      inPlace, recording;
+            std::vector<Frame>                        frames;
+            std::vector<Record>                       recordPool;
+            std::vector<char>                         backupPool;
+            /// Previous allocations behind shared pointers that have already been reused
+            std::unordered_set<const void*>           reusedShared;
+
+            /// Objects behind std::shared_ptr members, by the address they had on the sender
+            std::unordered_map<size_t, std::shared_ptr<void>> sharedObjects;
+
+            /// Iterative traversal
+            struct Action {
+                void (*run)(Message&, void*, int);
+                void *ref;
+                int  len;
+            };
+
+            bool                                      iterative, driving, runNow;
+            const char                                *stackBase;
+            size_t                                    maxStack;
+            /// Actions still to run, next on top, and those recorded while running the current action in call order
+            std::vector<Action>                       work, recorded;
+            /// Targets queued for the next level, one group per type and visit function in order of first appearance
+            std::vector<std::unique_ptr<PendingBase>> pending;
+
+            template<typename T>
+            static inline void visitNone(T &, Message &) {};
+
+            template<typename D>
+            static inline void visitDeep(D &obj, Message &msg) {
+                obj.DeepCopy(msg);
+            };
+
+            template<typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP, ALLOCATOR> F>
+            static inline void visitFunctor(T &obj, Message &msg) {
+                F(obj, msg);
+            };
+
+            template<typename T, void(*V)(T&, Message&)>
+            inline void enqueue(T* &ptr, const int len) {
+                const void *key = Pending<T, V>::Key();
+                for (auto &group : pending) {
+                    if (group->key == key) {
+                        static_cast<Pending<T, V>*>(group.get())->slots.emplace_back(&ptr, len);
+                        return;
+                    }
+                }
+                Pending<T, V> *group = new Pending<T, V>();
+                group->key = key;
+                group->slots.emplace_back(&ptr, len);
+                pending.emplace_back(group);
+            };
+
+            // Transport every queued target of one type and level as a single chunk, then visit their members. Targets are 
+            // staged through a contiguous buffer unless there is only one, or the allocator can place them contiguously
+            template<typename T, void(*V)(T&, Message&)>
+            inline void flushPending(std::vector<std::pair<T**, int>> &slots) {
+                int total = 0, count = 0;
+                std::pair<T**, int> *single = nullptr;
+                for (auto &slot : slots) {
+                    if (*slot.first != nullptr && slot.second > 0) {
+                        total += slot.second;
+                        single = &slot;
+                        ++count;
+                    }
+                    else if (!TRANSPORT_METHOD::SOURCE) {
+                        *slot.first = nullptr;
+                    }
+                }
+
+                if (count == 1) {
+                    transportAlloc(*single->first, single->second);
+                }
+                else if (count > 1) {
+                    if (TRANSPORT_METHOD::SOURCE) {
+                        std::vector<char> stage(std::is_same<TRANSPORT_METHOD, NoTransport>::value ? 1 : total * sizeof(T));
+                        if (!std::is_same<TRANSPORT_METHOD, NoTransport>::value) {
+                            char *dst = &stage[0];
+                            for (auto &slot : slots) {
+                                if (*slot.first == nullptr || slot.second <= 0) continue;
+                                std::memcpy(dst, *slot.first, slot.second * sizeof(T));
+                                dst += slot.second * sizeof(T);
+                            }
+                        }
+                        T *p = (T*) &stage[0];
+                        transport(p, total);
+                    }
+                    else if (ALLOCATOR::CONTIGUOUS) {
+                        T *block = allocator.template alloc<T>(total), *p = block;
+                        transport(p, total);
+                        for (auto &slot : slots) {
+                            if (*slot.first == nullptr || slot.second <= 0) continue;
+                            *slot.first = block;
+                            block += slot.second;
+                        }
+                    }
+                    else {
+                        std::vector<char> stage(total * sizeof(T));
+                        T *p = (T*) &stage[0];
+                        transport(p, total);
+                        const char *src = &stage[0];
+                        for (auto &slot : slots) {
+                            if (*slot.first == nullptr || slot.second <= 0) continue;
+                            *slot.first = allocator.template alloc<T>(slot.second);
+                            std::memcpy((void*) *slot.first, src, slot.second * sizeof(T));
+                            src += slot.second * sizeof(T);
+                        }
+                    }
+                }
+
+                /// Visiting members queues the next level
+                for (auto &slot : slots) {
+                    T *ptr = *slot.first;
+                    if (ptr == nullptr) continue;
+                    for (int i = 0; i < slot.second; ++i) V(ptr[i], *this);
+                }
+            };
+
+            // Returns false when the caller should pack now: iterative traversal is off, the call is the worklist running an 
+            // action, or nothing is recorded ahead of the call and it cannot recurse (leaf) or the stack is still shallow. Such 
+            // calls are already next in depth-first order, so balanced structures never touch the worklist. Otherwise records 
+            // the call and returns true, running the worklist first if this is the outermost deferred call
+            inline bool defer(void (*run)(Message&, void*, int), void *ref, const int len, const bool leaf = false) {
+                if (!iterative && !recording) return false;
+                if (recording) {
+                    recordPool.push_back({ (size_t) ((const char*) ref - frames.back().base), len });
+                    return true;
+                }
+                if (runNow) {
+                    runNow = false;
+                    return false;
+                }
+                if (recorded.empty()) {
+                    const char here = 0;
+                    if (rootDepth == 0 && !driving) stackBase = &here;
+                    if (leaf || stackUsed(&here) < maxStack) return false;
+                }
+                recorded.push_back({ run, ref, len });
+                if (!driving) drive();
+                return true;
+            };
+
+            inline size_t stackUsed(const char *here) const {
+                const std::intptr_t used = (std::intptr_t) stackBase - (std::intptr_t) here;
+                return (size_t) (used < 0 ? -used : used);
+            };
+
+            // Each action packs one member. Calls it makes are recorded and pushed so they run next and in call order, 
+            // which reproduces the recursive depth-first order exactly
+            inline void drive() {
+                const char *outerBase = stackBase, base = 0;
+                driving = true;
+                while (true) {
+                    for (size_t i = recorded.size(); i-- > 0;) work.push_back(recorded[i]);
+                    recorded.clear();
+                    if (work.empty()) break;
+
+                    const Action action = work.back();
+                    work.pop_back();
+                    stackBase = &base;
+                    runNow    = true;
+                    action.run(*this, action.ref, action.len);
+                }
+                driving   = false;
+                stackBase = outerBase;
+            };
+
+            template<typename T>
+            static inline void runRootVar(Message &msg, void *ref, int) {
+                msg.packRootVar(*(T*) ref);
+            };
+            template<typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP, ALLOCATOR> F>
+            static inline void runRootVarF(Message &msg, void *ref, int) {
+                msg. template packRootVar<T, F>(*(T*) ref);
+            };
+            template<typename T>
+            static inline void runPtr(Message &msg, void *ref, int len) {
+                msg.packPtr(*(T**) ref, len);
+            };
+            template<typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP, ALLOCATOR> F>
+            static inline void runPtrF(Message &msg, void *ref, int len) {
+                msg. template packPtr<T, F>(*(T**) ref, len);
+            };
+            template<typename T>
+            static inline void runSharedPtr(Message &msg, void *ref, int len) {
+                msg.packSharedPtr(*(T**) ref, len);
+            };
+            template<typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP, ALLOCATOR> F>
+            static inline void runSharedPtrF(Message &msg, void *ref, int len) {
+                msg. template packSharedPtr<T, F>(*(T**) ref, len);
+            };
+            template<typename T>
+            static inline void runRootPtr(Message &msg, void *ref, int len) {
+                msg.packRootPtr(*(T**) ref, len);
+            };
+            template<typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP, ALLOCATOR> F>
+            static inline void runRootPtrF(Message &msg, void *ref, int len) {
+                msg. template packRootPtr<T, F>(*(T**) ref, len);
+            };
+            template<typename S>
+            static inline void runSTL(Message &msg, void *ref, int) {
+                msg.packSTL(*(S*) ref);
+            };
+            template<typename S, typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP, ALLOCATOR> F>
+            static inline void runSTLF(Message &msg, void *ref, int) {
+                msg. template packSTL<T, F>(*(S*) ref);
+            };
+            template<typename S>
+            static inline void runRootSTL(Message &msg, void *ref, int) {
+                msg.packRootSTL(*(S*) ref);
+            };
+            template<typename S, typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP, ALLOCATOR> F>
+            static inline void runRootSTLF(Message &msg, void *ref, int) {
+                msg. template packRootSTL<T, F>(*(S*) ref);
+            };
+
+            inline void drain() {
+                while (!pending.empty()) {
+                    std::vector<std::unique_ptr<PendingBase>> level;
+                    level.swap(pending);
+                    for (auto &group : level) group->flush(*this);
+                }
+            };
             
             template<typename P>
             inline enable_if_pointer<P> transport(P &ptr, const int len) {
@@ -344,81 +1012,457 @@ namespace MEL {
             inline enable_if_pointer<P> transportAlloc(P &ptr, const int len) {
                 if (!TRANSPORT_METHOD::SOURCE) {
                     typedef typename std::remove_pointer<P>::type T; // where P == T*, find T
-                    ptr = (len > 0 && ptr != nullptr) ? MEL::MemAlloc<T>(len) : nullptr; 
+                    ptr = (len > 0 && ptr != nullptr) ? allocator.template alloc<T>(len) : nullptr;
                 }
                 transport(ptr, len);
             };
 
-        public:
-            
-            template<typename ...Args>
-            Message(Args &&...args) : offset(0), transporter(std::forward<Args>(args)...) {};
-
-            Message()                           = delete;
-            Message(const Message &)            = delete;
-            Message& operator=(const Message &) = delete;
-            Message(Message &&)                 = delete;
-            Message& operator=(Message &&)      = delete;
+            /// In place receive
 
-            inline int getOffset() const {
-                return offset;
+            template<typename T>
+            static inline void visitContents(T &obj, Message &msg) {
+                msg.packContents(obj);
             };
 
-            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-            // Transport API
-            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-            // Object
+            // Runs V over the receiver's previous elements with every pack call recorded rather than followed, then keeps their 
+            // bytes, so the visits made once the sender's bytes have overwritten them can find what the receiver had
+            template<typename T, void(*V)(T&, Message&)>
+            inline void pushFrame(T *old, const int len) {
+                Frame frame;
+                frame.base    = (char*) old;
+                frame.size    = len * sizeof(T);
+                frame.records = frame.cursor = recordPool.size();
+                frames.push_back(frame);
+
+                recording = true;
+                for (int i = 0; i < len; ++i) V(old[i], *this);
+                recording = false;
+
+                Frame &top     = frames.back();
+                top.recordsEnd = recordPool.size();
+                top.backup     = backupPool.size();
+                backupPool.insert(backupPool.end(), top.base, top.base + top.size);
+            };
 
-            template<typename D>
-            inline enable_if_deep<D> packVar(D &obj) {
-                obj.DeepCopy(*this);
+            inline void popFrame() {
+                const Frame &top = frames.back();
+                recordPool.resize(top.records);
+                backupPool.resize(top.backup);
+                frames.pop_back();
             };
 
-            template<typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP> F>
-            inline void packVar(T &obj) {
-                F(obj, *this);
+            // Finds the record of the member at ref in the innermost frame, members are usually visited in record order
+            inline bool findRecord(const void *ref, Record &record, const char* &previous) {
+                if (TRANSPORT_METHOD::SOURCE || frames.empty()) return false;
+                Frame &top = frames.back();
+                const char *p = (const char*) ref;
+                if (p < top.base || p >= top.base + top.size) return false;
+
+                const size_t offset = p - top.base;
+                for (size_t n = top.recordsEnd - top.records, i = top.cursor - top.records; n > 0; --n, ++i) {
+                    if (i == top.recordsEnd - top.records) i = 0;
+                    if (recordPool[top.records + i].offset == offset) {
+                        record     = recordPool[top.records + i];
+                        top.cursor = top.records + i + 1;
+                        previous   = &backupPool[top.backup + offset];
+                        return true;
+                    }
+                }
+                return false;
             };
 
+            // The receiver's previous allocation behind ptr, if it held len elements and the sender's ptr is not null
             template<typename T>
-            inline enable_if_not_deep<T> packRootVar(T &obj) {
-                transport(obj);
+            inline T* previousAlloc(T* const &ptr, const int len) {
+                Record record;
+                const char *previous;
+                if (ptr == nullptr || !findRecord(&ptr, record, previous) || record.len != len) return nullptr;
+                T *old;
+                std::memcpy((void*) &old, previous, sizeof(T*));
+                return old;
             };
 
-            template<typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP> F>
-            inline void packRootVar(T &obj) {
-                transport(obj);
-                F(obj, *this);
+            // As previousAlloc, but an allocation reached through several shared pointers is only reused once
+            template<typename T>
+            inline T* previousShared(T* const &ptr, const int len) {
+                T *old = previousAlloc(ptr, len);
+                if (old == nullptr || !reusedShared.insert(old).second) return nullptr;
+                return old;
             };
 
-            template<typename D>
-            inline enable_if_deep<D> packRootVar(D &obj) {
-                transport(obj);
-                obj.DeepCopy(*this);
+            // Moves the receiver's previous container back into obj, whose bytes are now the sender's
+            template<typename S>
+            inline bool revive(S &obj) {
+                Record record;
+                const char *previous;
+                if (!findRecord(&obj, record, previous)) return false;
+                std::memcpy((void*) &obj, previous, sizeof(S));
+                return true;
             };
 
-            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-            // Pointer
-
-            template<typename T>
-            inline enable_if_not_deep<T> packPtr(T* &ptr, int len = 1) {
-                transportAlloc(ptr, len);
+            // Receives len elements over the receiver's previous ones and visits them with V
+            template<typename T, void(*V)(T&, Message&)>
+            inline void transportInPlace(T *old, const int len) {
+                pushFrame<T, V>(old, len);
+                transport(old, len);
+                for (int i = 0; i < len; ++i) V(old[i], *this);
+                popFrame();
             };
 
-            template<typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP> F>
-            inline void packPtr(T* &ptr, int len = 1) {
-                transportAlloc(ptr, len);
-                /// Copy elements
-                if (ptr != nullptr) {
-                    for (int i = 0; i < len; ++i) {
-                        F(ptr[i], *this);
-                    }
+            // Receives len elements into a vector holding the receiver's previous elements. Those kept are received in place, 
+            // the vector only reallocates when it grows past its capacity
+            template<typename T, void(*V)(T&, Message&)>
+            inline void transportInPlace(std::vector<T> &obj, const int len) {
+                const int keep = std::min((int) obj.size(), len);
+                obj.resize(len);
+                if (len <= 0) return;
+
+                T *p = &obj[0];
+                for (int i = keep; i < len; ++i) (&obj[i])->~T();
+                if (V == visitNone<T> || (V == visitContents<T> && !NeedsVisit<T>::value)) {
+                    transport(p, len);
+                    return;
                 }
+                if (keep > 0) pushFrame<T, V>(p, keep);
+                transport(p, len);
+                for (int i = 0; i < len; ++i) V(obj[i], *this);
+                if (keep > 0) popFrame();
             };
 
+            /// Containers
+
+            // Visits what an element owns beyond its own bytes
+            template<typename T>
+            inline typename std::enable_if<!NeedsVisit<T>::value>::type packContents(T &) {};
+
             template<typename D>
-            inline enable_if_deep<D> packPtr(D* &ptr, int len = 1) {
+            inline enable_if_deep<D> packContents(D &obj) {
+                obj.DeepCopy(*this);
+            };
+
+            template<typename S>
+            inline typename std::enable_if<is_member_stl<S>::value>::type packContents(S &obj) {
+                packSTL(obj);
+            };
+
+            // Elements of node based and segmented containers travel as one contiguous block. The sender gathers the bytes of 
+            // get(element) for len elements from it, the receiver is left with them in stage until they are moved in
+            template<typename T, typename IT, typename GET>
+            inline void transportGather(IT it, const int len, GET get, std::vector<char> &stage) {
+                if (len <= 0) return;
+                const bool gather = TRANSPORT_METHOD::SOURCE && !std::is_same<TRANSPORT_METHOD, NoTransport>::value;
+                stage.resize((gather || !TRANSPORT_METHOD::SOURCE) ? len * sizeof(T) : 1);
+                if (gather) {
+                    char *dst = &stage[0];
+                    for (int i = 0; i < len; ++i, ++it, dst += sizeof(T)) std::memcpy(dst, (const void*) &get(*it), sizeof(T));
+                }
+                T *p = (T*) &stage[0];
+                transport(p, len);
+            };
+
+            template<typename C>
+            static inline void reserve(C &, const int) {};
+
+            template<typename K, typename V, typename H, typename E, typename A>
+            static inline void reserve(std::unordered_map<K, V, H, E, A> &obj, const int len) {
+                obj.reserve(len);
+            };
+
+            template<typename K, typename H, typename E, typename A>
+            static inline void reserve(std::unordered_set<K, H, E, A> &obj, const int len) {
+                obj.reserve(len);
+            };
+
+            // Keys are fixed up before they are moved into the container, so are packed directly
+            template<typename K, typename IT>
+            inline void packKeys(IT it, const int len, std::vector<char> &stage) {
+                if (!NeedsVisit<K>::value || len <= 0) return;
+                DirectScope direct(*this);
+                if (TRANSPORT_METHOD::SOURCE) {
+                    for (int i = 0; i < len; ++i, ++it) packContents(const_cast<K&>(Key(*it)));
+                }
+                else {
+                    K *keys = (K*) &stage[0];
+                    for (int i = 0; i < len; ++i) packContents(keys[i]);
+                }
+            };
+
+            template<typename K>
+            static inline const K& Key(const K &key) {
+                return key;
+            };
+
+            template<typename K, typename V>
+            static inline const K& Key(const std::pair<const K, V> &pair) {
+                return pair.first;
+            };
+
+            // Sorted (or hashed) keys and values arrive as two arrays and are inserted in order at the end, which is amortised 
+            // O(1) per element for ordered containers, into a container reserved up front for hashed ones
+            template<typename C>
+            inline void packMap(C &obj) {
+                typedef typename C::key_type    K;
+                typedef typename C::mapped_type V;
+                typedef typename C::value_type  E;
+
+                int len = obj.size();
+                transport(len);
+
+                std::vector<char> keys, values;
+                transportGather<K>(obj.begin(), len, [](const E &e) -> const K& { return e.first; }, keys);
+                packKeys<K>(obj.begin(), len, keys);
+                transportGather<V>(obj.begin(), len, [](const E &e) -> const V& { return e.second; }, values);
+
+                if (TRANSPORT_METHOD::SOURCE) {
+                    if (NeedsVisit<V>::value) for (auto &e : obj) packContents(e.second);
+                    return;
+                }
+                if (len <= 0) return;
+
+                K *k = (K*) &keys[0];
+                V *v = (V*) &values[0];
+                reserve(obj, len);
+                const bool trivial = std::is_trivially_copyable<K>::value && std::is_trivially_copyable<V>::value;
+                std::vector<V*> slots(NeedsVisit<V>::value ? len : 0);
+                for (int i = 0; i < len; ++i) {
+                    V *value;
+                    if (trivial) {
+                        value = &obj.emplace_hint(obj.end(), k[i], v[i])->second;
+                    }
+                    else {
+                        value = &obj.emplace_hint(obj.end(), std::move(k[i]), V())->second;
+                        k[i].~K();
+                        value->~V();
+                        std::memcpy((void*) value, (const void*) &v[i], sizeof(V));
+                    }
+                    if (NeedsVisit<V>::value) slots[i] = value;
+                }
+                /// Values are visited in the order the sender visited them, which a hashed container need not keep
+                for (auto value : slots) packContents(*value);
+            };
+
+            template<typename C>
+            inline void packSet(C &obj) {
+                typedef typename C::key_type K;
+
+                int len = obj.size();
+                transport(len);
+
+                std::vector<char> keys;
+                transportGather<K>(obj.begin(), len, [](const K &k) -> const K& { return k; }, keys);
+                packKeys<K>(obj.begin(), len, keys);
+
+                if (TRANSPORT_METHOD::SOURCE || len <= 0) return;
+
+                K *k = (K*) &keys[0];
+                reserve(obj, len);
+                for (int i = 0; i < len; ++i) {
+                    obj.emplace_hint(obj.end(), std::move(k[i]));
+                    k[i].~K();
+                }
+            };
+
+            // Lists and deques travel as one array rather than element by element. Elements are left for the caller to visit
+            template<typename C>
+            inline void packSequence(C &obj) {
+                typedef typename C::value_type T;
+
+                int len = obj.size();
+                transport(len);
+
+                std::vector<char> stage;
+                transportGather<T>(obj.begin(), len, [](const T &e) -> const T& { return e; }, stage);
+
+                if (TRANSPORT_METHOD::SOURCE) return;
+                /// A container revived by an in place receive still holds the receiver's previous elements
+                if (len <= 0) {
+                    obj.clear();
+                    return;
+                }
+
+                T *t = (T*) &stage[0];
+                if (std::is_trivially_copyable<T>::value) {
+                    obj.assign(t, t + len);
+                    return;
+                }
+                obj.resize(len);
+                int i = 0;
+                for (auto &e : obj) {
+                    e.~T();
+                    std::memcpy((void*) &e, (const void*) &t[i++], sizeof(T));
+                }
+            };
+
+        public:
+            
+            template<typename ...Args>
+            Message(Args &&...args) : offset(0), transporter(std::forward<Args>(args)...), 
+                                      breadthFirst(GetTraversalConfig().breadthFirst), rootDepth(0),
+                                      inPlace(GetTraversalConfig().inPlace && !breadthFirst && !TRANSPORT_METHOD::SOURCE), recording(false),
+                                      iterative(GetTraversalConfig().iterative && !breadthFirst && !inPlace), driving(false), runNow(false),
+                                      stackBase(nullptr), maxStack(GetTraversalConfig().iterativeStack) {};
+
+            Message()                           = delete;
+            Message(const Message &)            = delete;
+            Message& operator=(const Message &) = delete;
+            Message(Message &&)                 = delete;
+            Message& operator=(Message &&)      = delete;
+
+            inline int getOffset() const {
+                return offset;
+            };
+
+            inline ALLOCATOR& getAllocator() {
+                return allocator;
+            };
+
+            inline TRANSPORT_METHOD& getTransporter() {
+                return transporter;
+            };
+
+            inline HASH_MAP& getPointerMap() {
+                return pointerMap;
+            };
+
+            // Addresses, on the sender, of the objects behind std::shared_ptr members transported so far
+            inline void getSharedAddresses(std::vector<size_t> &addrs) const {
+                addrs.clear();
+                for (const auto &e : sharedObjects) addrs.push_back(e.first);
+            };
+
+            // Treat the object at addr behind std::shared_ptr members as already transported. Only meaningful when sending
+            inline void markShared(const size_t addr) {
+                if (TRANSPORT_METHOD::SOURCE) sharedObjects.insert(std::make_pair(addr, std::shared_ptr<void>()));
+            };
+
+            // Override the traversal order from GetTraversalConfig() for this message. Must be called before packing
+            inline void setBreadthFirst(const bool _breadthFirst) {
+                breadthFirst = _breadthFirst;
+            };
+
+            inline bool isBreadthFirst() const {
+                return breadthFirst;
+            };
+
+            // Override the iterative setting from GetTraversalConfig() for this message. Must be called before packing
+            inline void setIterative(const bool _iterative) {
+                iterative = _iterative && !breadthFirst;
+            };
+
+            inline bool isIterative() const {
+                return iterative;
+            };
+
+            // Override the in place setting from GetTraversalConfig() for this message. Must be called before packing
+            inline void setInPlace(const bool _inPlace) {
+                inPlace = _inPlace && !breadthFirst && !TRANSPORT_METHOD::SOURCE;
+                if (inPlace) iterative = false;
+            };
+
+            inline bool isInPlace() const {
+                return inPlace;
+            };
+
+            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+            // Transport API
+            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+            // Object
+
+            template<typename D>
+            inline enable_if_deep<D> packVar(D &obj) {
+                obj.DeepCopy(*this);
+            };
+
+            template<typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP, ALLOCATOR> F>
+            inline void packVar(T &obj) {
+                F(obj, *this);
+            };
+
+            template<typename T>
+            inline enable_if_not_deep<T> packRootVar(T &obj) {
+                if (defer(runRootVar<T>, (void*) &obj, 0, true)) return;
+                RootScope scope(*this);
+                transport(obj);
+            };
+
+            template<typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP, ALLOCATOR> F>
+            inline void packRootVar(T &obj) {
+                if (defer(runRootVarF<T, F>, (void*) &obj, 0)) return;
+                RootScope scope(*this);
+                if (inPlace) {
+                    transportInPlace<T, visitFunctor<T, F>>(&obj, 1);
+                    return;
+                }
+                transport(obj);
+                F(obj, *this);
+            };
+
+            template<typename D>
+            inline enable_if_deep<D> packRootVar(D &obj) {
+                if (defer(runRootVar<D>, (void*) &obj, 0)) return;
+                RootScope scope(*this);
+                if (inPlace) {
+                    transportInPlace<D, visitDeep<D>>(&obj, 1);
+                    return;
+                }
+                transport(obj);
+                obj.DeepCopy(*this);
+            };
+
+            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+            // Pointer
+
+            template<typename T>
+            inline enable_if_not_deep<T> packPtr(T* &ptr, int len = 1) {
+                if (defer(runPtr<T>, &ptr, len, true)) return;
+                if (breadthFirst) {
+                    enqueue<T, visitNone<T>>(ptr, len);
+                    return;
+                }
+                T *previous = previousAlloc(ptr, len);
+                if (previous != nullptr) {
+                    ptr = previous;
+                    transport(ptr, len);
+                    return;
+                }
+                transportAlloc(ptr, len);
+            };
+
+            template<typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP, ALLOCATOR> F>
+            inline void packPtr(T* &ptr, int len = 1) {
+                if (defer(runPtrF<T, F>, &ptr, len)) return;
+                if (breadthFirst) {
+                    enqueue<T, visitFunctor<T, F>>(ptr, len);
+                    return;
+                }
+                T *previous = previousAlloc(ptr, len);
+                if (previous != nullptr) {
+                    transportInPlace<T, visitFunctor<T, F>>(ptr = previous, len);
+                    return;
+                }
+                transportAlloc(ptr, len);
+                /// Copy elements
+                if (ptr != nullptr) {
+                    for (int i = 0; i < len; ++i) {
+                        F(ptr[i], *this);
+                    }
+                }
+            };
+
+            template<typename D>
+            inline enable_if_deep<D> packPtr(D* &ptr, int len = 1) {
+                if (defer(runPtr<D>, &ptr, len)) return;
+                if (breadthFirst) {
+                    enqueue<D, visitDeep<D>>(ptr, len);
+                    return;
+                }
+                D *previous = previousAlloc(ptr, len);
+                if (previous != nullptr) {
+                    transportInPlace<D, visitDeep<D>>(ptr = previous, len);
+                    return;
+                }
                 transportAlloc(ptr, len);
                 /// Copy elements
                 if (ptr != nullptr) {
@@ -433,18 +1477,32 @@ namespace MEL {
 
             template<typename T>
             inline enable_if_not_deep<T> packSharedPtr(T* &ptr, int len = 1) {
+                if (defer(runSharedPtr<T>, &ptr, len, true)) return;
                 T *oldPtr = ptr;
                 if (pointerMap.find(oldPtr, ptr)) return;
 
+                T *previous = previousShared(ptr, len);
+                if (previous != nullptr) {
+                    pointerMap.insert(oldPtr, ptr = previous);
+                    transport(ptr, len);
+                    return;
+                }
                 transportAlloc(ptr, len);
                 pointerMap.insert(oldPtr, ptr);
             };
 
-            template<typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP> F>
+            template<typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP, ALLOCATOR> F>
             inline void packSharedPtr(T* &ptr, int len = 1) {
+                if (defer(runSharedPtrF<T, F>, &ptr, len)) return;
                 T *oldPtr = ptr;
                 if (pointerMap.find(oldPtr, ptr)) return;
 
+                T *previous = previousShared(ptr, len);
+                if (previous != nullptr) {
+                    pointerMap.insert(oldPtr, ptr = previous);
+                    transportInPlace<T, visitFunctor<T, F>>(ptr, len);
+                    return;
+                }
                 transportAlloc(ptr, len);
                 pointerMap.insert(oldPtr, ptr);
 
@@ -458,9 +1516,16 @@ namespace MEL {
 
             template<typename D>
             inline enable_if_deep<D> packSharedPtr(D* &ptr, int len = 1) {
+                if (defer(runSharedPtr<D>, &ptr, len)) return;
                 D *oldPtr = ptr;
                 if (pointerMap.find(oldPtr, ptr)) return;
 
+                D *previous = previousShared(ptr, len);
+                if (previous != nullptr) {
+                    pointerMap.insert(oldPtr, ptr = previous);
+                    transportInPlace<D, visitDeep<D>>(ptr, len);
+                    return;
+                }
                 transportAlloc(ptr, len);
                 pointerMap.insert(oldPtr, ptr);
 
@@ -477,6 +1542,9 @@ namespace MEL {
 
             template<typename T>
             inline enable_if_not_deep<T> packRootPtr(T* &ptr, int len = 1) {
+                if (defer(runRootPtr<T>, &ptr, len, true)) return;
+                RootScope scope(*this);
+                T *previous = (inPlace && len == 1) ? ptr : nullptr;
                 // Explicitly transport the pointer value for the root node
                 size_t addr = (size_t) ptr;
                 transport(addr);
@@ -485,12 +1553,20 @@ namespace MEL {
                 T *oldPtr = ptr;
                 if (pointerMap.find(oldPtr, ptr)) return;
 
+                if (previous != nullptr && ptr != nullptr) {
+                    pointerMap.insert(oldPtr, ptr = previous);
+                    transport(ptr, len);
+                    return;
+                }
                 transportAlloc(ptr, len);
                 pointerMap.insert(oldPtr, ptr);
             };
 
-            template<typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP> F>
+            template<typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP, ALLOCATOR> F>
             inline void packRootPtr(T* &ptr, int len = 1) {
+                if (defer(runRootPtrF<T, F>, &ptr, len)) return;
+                RootScope scope(*this);
+                T *previous = (inPlace && len == 1) ? ptr : nullptr;
                 // Explicitly transport the pointer value for the root node
                 size_t addr = (size_t) ptr;
                 transport(addr);
@@ -499,6 +1575,11 @@ namespace MEL {
                 T *oldPtr = ptr;
                 if (pointerMap.find(oldPtr, ptr)) return;
 
+                if (previous != nullptr && ptr != nullptr) {
+                    pointerMap.insert(oldPtr, ptr = previous);
+                    transportInPlace<T, visitFunctor<T, F>>(ptr, len);
+                    return;
+                }
                 transportAlloc(ptr, len);
                 pointerMap.insert(oldPtr, ptr);
                 
@@ -512,6 +1593,9 @@ namespace MEL {
 
             template<typename D>
             inline enable_if_deep<D> packRootPtr(D* &ptr, int len = 1) {
+                if (defer(runRootPtr<D>, &ptr, len)) return;
+                RootScope scope(*this);
+                D *previous = (inPlace && len == 1) ? ptr : nullptr;
                 // Explicitly transport the pointer value for the root node
                 size_t addr = (size_t) ptr;
                 transport(addr);
@@ -520,6 +1604,11 @@ namespace MEL {
                 D *oldPtr = ptr;
                 if (pointerMap.find(oldPtr, ptr)) return;
 
+                if (previous != nullptr && ptr != nullptr) {
+                    pointerMap.insert(oldPtr, ptr = previous);
+                    transportInPlace<D, visitDeep<D>>(ptr, len);
+                    return;
+                }
                 transportAlloc(ptr, len);
                 pointerMap.insert(oldPtr, ptr);
 
@@ -535,14 +1624,16 @@ namespace MEL {
             // STL
 
             inline void packSTL(std::string &obj) {
-                int len;
+                if (defer(runSTL<std::string>, &obj, 0, true)) return;
+                int len = 0;
                 if (TRANSPORT_METHOD::SOURCE) {
                     len = obj.size();
                     transport(len);
                 }
                 else {
                     transport(len);
-                    new (&obj) std::string(len, ' ');
+                    if (revive(obj)) obj.resize(len);
+                    else new (&obj) std::string(len, ' ');
                 }
 
                 char *p = &obj[0];
@@ -551,7 +1642,12 @@ namespace MEL {
 
             template<typename T>
             inline enable_if_not_deep<T> packSTL(std::vector<T> &obj) {
+                if (defer(runSTL<std::vector<T>>, &obj, 0, !NeedsVisit<T>::value)) return;
                 int len = obj.size();
+                if (!TRANSPORT_METHOD::SOURCE && revive(obj)) {
+                    transportInPlace<T, visitContents<T>>(obj, len);
+                    return;
+                }
                 if (!TRANSPORT_METHOD::SOURCE) {
                     new (&obj) std::vector<T>(len, T());
                     for (int i = 0; i < len; ++i) (&obj[i])->~T();
@@ -559,11 +1655,18 @@ namespace MEL {
 
                 T *p = &obj[0];
                 if (len > 0) transport(p, len);
+                /// Copy content
+                if (NeedsVisit<T>::value) for (int i = 0; i < len; ++i) packContents(obj[i]);
             };
 
-            template<typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP> F>
+            template<typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP, ALLOCATOR> F>
             inline void packSTL(std::vector<T> &obj) {
+                if (defer(runSTLF<std::vector<T>, T, F>, &obj, 0)) return;
                 int len = obj.size();
+                if (!TRANSPORT_METHOD::SOURCE && revive(obj)) {
+                    transportInPlace<T, visitFunctor<T, F>>(obj, len);
+                    return;
+                }
                 if (!TRANSPORT_METHOD::SOURCE) {
                     new (&obj) std::vector<T>(len);
                     for (int i = 0; i < len; ++i) (&obj[i])->~T();
@@ -580,7 +1683,12 @@ namespace MEL {
 
             template<typename D>
             inline enable_if_deep<D> packSTL(std::vector<D> &obj) {
+                if (defer(runSTL<std::vector<D>>, &obj, 0)) return;
                 int len = obj.size();
+                if (!TRANSPORT_METHOD::SOURCE && revive(obj)) {
+                    transportInPlace<D, visitDeep<D>>(obj, len);
+                    return;
+                }
                 if (!TRANSPORT_METHOD::SOURCE) {
                     new (&obj) std::vector<D>(len);
                     for (int i = 0; i < len; ++i) (&obj[i])->~D();
@@ -596,51 +1704,144 @@ namespace MEL {
 
             template<typename T>
             inline enable_if_not_deep<T> packSTL(std::list<T> &obj) {
-                int len;
-                if (TRANSPORT_METHOD::SOURCE) {
-                    len = obj.size(); transport(len);
-                }
-                else {
-                    transport(len); new (&obj) std::list<T>(len);
-                }
+                if (defer(runSTL<std::list<T>>, &obj, 0, !NeedsVisit<T>::value)) return;
+                if (!TRANSPORT_METHOD::SOURCE && !revive(obj)) new (&obj) std::list<T>();
+                packSequence(obj);
                 /// Copy content
-                for (auto it = obj.begin(); it != obj.end(); ++it) {
-                    if (!TRANSPORT_METHOD::SOURCE) (it)->~T();
-                    this->packRootVar(*it);
-                }
+                FreshScope fresh(*this);
+                if (NeedsVisit<T>::value) for (auto &e : obj) packContents(e);
             };
 
-            template<typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP> F>
+            template<typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP, ALLOCATOR> F>
             inline void packSTL(std::list<T> &obj) {
-                int len;
-                if (TRANSPORT_METHOD::SOURCE) {
-                    len = obj.size(); transport(len);
-                }
-                else {
-                    transport(len); new (&obj) std::list<T>(len);
-                }
+                if (defer(runSTLF<std::list<T>, T, F>, &obj, 0)) return;
+                if (!TRANSPORT_METHOD::SOURCE && !revive(obj)) new (&obj) std::list<T>();
+                packSequence(obj);
                 /// Copy content
-                for (auto it = obj.begin(); it != obj.end(); ++it) {
-                    if (!TRANSPORT_METHOD::SOURCE) (it)->~T();
-                    this->packRootVar<T, F>(*it);
-                }
+                FreshScope fresh(*this);
+                for (auto &e : obj) F(e, *this);
             };
 
             template<typename D>
             inline enable_if_deep<D> packSTL(std::list<D> &obj) {
-                int len;
-                if (TRANSPORT_METHOD::SOURCE) {
-                    len = obj.size(); transport(len);
+                if (defer(runSTL<std::list<D>>, &obj, 0)) return;
+                if (!TRANSPORT_METHOD::SOURCE && !revive(obj)) new (&obj) std::list<D>();
+                packSequence(obj);
+                /// Copy content
+                FreshScope fresh(*this);
+                for (auto &e : obj) e.DeepCopy(*this);
+            };
+
+            template<typename T, typename A>
+            inline void packSTL(std::deque<T, A> &obj) {
+                if (defer(runSTL<std::deque<T, A>>, &obj, 0, !NeedsVisit<T>::value)) return;
+                if (!TRANSPORT_METHOD::SOURCE && !revive(obj)) new (&obj) std::deque<T, A>();
+                packSequence(obj);
+                /// Copy content
+                FreshScope fresh(*this);
+                if (NeedsVisit<T>::value) for (auto &e : obj) packContents(e);
+            };
+
+            // The elements' bytes already travel with the enclosing object
+            template<typename T, size_t N>
+            inline void packSTL(std::array<T, N> &obj) {
+                /// The elements are part of the enclosing object, so in place receives record them rather than the array
+                if (!recording && defer(runSTL<std::array<T, N>>, &obj, 0, !NeedsVisit<T>::value)) return;
+                if (NeedsVisit<T>::value) for (auto &e : obj) packContents(e);
+            };
+
+            template<typename K, typename V, typename C, typename A>
+            inline void packSTL(std::map<K, V, C, A> &obj) {
+                if (defer(runSTL<std::map<K, V, C, A>>, &obj, 0, !NeedsVisit<K>::value && !NeedsVisit<V>::value)) return;
+                if (!TRANSPORT_METHOD::SOURCE) {
+                    if (revive(obj)) obj.clear();
+                    else new (&obj) std::map<K, V, C, A>();
                 }
-                else {
-                    transport(len); new (&obj) std::list<D>(len);
+                packMap(obj);
+            };
+
+            template<typename K, typename V, typename H, typename E, typename A>
+            inline void packSTL(std::unordered_map<K, V, H, E, A> &obj) {
+                if (defer(runSTL<std::unordered_map<K, V, H, E, A>>, &obj, 0, !NeedsVisit<K>::value && !NeedsVisit<V>::value)) return;
+                if (!TRANSPORT_METHOD::SOURCE) {
+                    if (revive(obj)) obj.clear();
+                    else new (&obj) std::unordered_map<K, V, H, E, A>();
                 }
+                packMap(obj);
+            };
 
-                /// Copy content
-                for (auto it = obj.begin(); it != obj.end(); ++it) {
-                    if (!TRANSPORT_METHOD::SOURCE) (it)->~D();
-                    this->packRootVar(*it);
+            template<typename K, typename C, typename A>
+            inline void packSTL(std::set<K, C, A> &obj) {
+                if (defer(runSTL<std::set<K, C, A>>, &obj, 0, !NeedsVisit<K>::value)) return;
+                if (!TRANSPORT_METHOD::SOURCE) {
+                    if (revive(obj)) obj.clear();
+                    else new (&obj) std::set<K, C, A>();
+                }
+                packSet(obj);
+            };
+
+            template<typename K, typename H, typename E, typename A>
+            inline void packSTL(std::unordered_set<K, H, E, A> &obj) {
+                if (defer(runSTL<std::unordered_set<K, H, E, A>>, &obj, 0, !NeedsVisit<K>::value)) return;
+                if (!TRANSPORT_METHOD::SOURCE) {
+                    if (revive(obj)) obj.clear();
+                    else new (&obj) std::unordered_set<K, H, E, A>();
+                }
+                packSet(obj);
+            };
+
+            // The pointee is owned by the received std::unique_ptr and allocated with new, not by the message's allocator
+            template<typename T>
+            inline void packSTL(std::unique_ptr<T> &obj) {
+                if (defer(runSTL<std::unique_ptr<T>>, &obj, 0)) return;
+                int exists = TRANSPORT_METHOD::SOURCE && obj != nullptr;
+                transport(exists);
+                if (!TRANSPORT_METHOD::SOURCE) {
+                    if (!revive(obj)) new (&obj) std::unique_ptr<T>();
+                    if (!exists) {
+                        obj.reset();
+                        return;
+                    }
+                    if (obj != nullptr) {
+                        transportInPlace<T, visitContents<T>>(obj.get(), 1);
+                        return;
+                    }
+                    obj.reset(new T());
+                    obj->~T();
+                }
+                if (!exists) return;
+
+                T *ptr = obj.get();
+                transport(ptr, 1);
+                packContents(*obj);
+            };
+
+            // Objects shared by several std::shared_ptr members are transported once and stay shared on the receiver
+            template<typename T>
+            inline void packSTL(std::shared_ptr<T> &obj) {
+                if (defer(runSTL<std::shared_ptr<T>>, &obj, 0)) return;
+                size_t addr = TRANSPORT_METHOD::SOURCE ? (size_t) obj.get() : 0;
+                transport(addr);
+                if (!TRANSPORT_METHOD::SOURCE) {
+                    if (!revive(obj)) new (&obj) std::shared_ptr<T>();
+                    if (addr == 0) obj.reset();
+                }
+                if (addr == 0) return;
+
+                const auto it = sharedObjects.find(addr);
+                if (it != sharedObjects.end()) {
+                    if (!TRANSPORT_METHOD::SOURCE) obj = std::static_pointer_cast<T>(it->second);
+                    return;
+                }
+                if (!TRANSPORT_METHOD::SOURCE) {
+                    obj.reset(new T());
+                    obj->~T();
                 }
+                sharedObjects.insert(std::make_pair(addr, std::static_pointer_cast<void>(obj)));
+
+                T *ptr = obj.get();
+                transport(ptr, 1);
+                packContents(*obj);
             };
 
             /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -648,10 +1849,17 @@ namespace MEL {
 
             template<typename T>
             inline enable_if_not_deep<T> packRootSTL(std::vector<T> &obj) {
-                int len;
+                if (defer(runRootSTL<std::vector<T>>, &obj, 0, !NeedsVisit<T>::value)) return;
+                RootScope scope(*this);
+                int len = 0;
                 if (TRANSPORT_METHOD::SOURCE) {
                     len = obj.size(); transport(len);
                 }
+                else if (inPlace) {
+                    transport(len);
+                    transportInPlace<T, visitContents<T>>(obj, len);
+                    return;
+                }
                 else {
                     transport(len); obj.resize(len);
                     for (int i = 0; i < len; ++i) (&obj[i])->~T();
@@ -659,14 +1867,23 @@ namespace MEL {
 
                 T *p = &obj[0];
                 if (len > 0) transport(p, len);
+                /// Copy content
+                if (NeedsVisit<T>::value) for (int i = 0; i < len; ++i) packContents(obj[i]);
             };
 
-            template<typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP> F>
+            template<typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP, ALLOCATOR> F>
             inline void packRootSTL(std::vector<T> &obj) {
-                int len;
+                if (defer(runRootSTLF<std::vector<T>, T, F>, &obj, 0)) return;
+                RootScope scope(*this);
+                int len = 0;
                 if (TRANSPORT_METHOD::SOURCE) {
                     len = obj.size(); transport(len);
                 }
+                else if (inPlace) {
+                    transport(len);
+                    transportInPlace<T, visitFunctor<T, F>>(obj, len);
+                    return;
+                }
                 else {
                     transport(len); obj.resize(len);
                     for (int i = 0; i < len; ++i) (&obj[i])->~T();
@@ -680,14 +1897,32 @@ namespace MEL {
                 }
             };
 
+            // A root vector packed by MEL::OMP::Deep::Pack starts with the negated size of a chunk table that only parallel 
+            // readers use, a length is never negative otherwise. Serial readers skip the table and read the length after it
+            inline void transportRootLength(int &len) {
+                transport(len);
+                if (len >= 0) return;
+                std::vector<char> table(-len);
+                char *p = &table[0];
+                transport(p, -len);
+                transport(len);
+            };
+
             template<typename D>
             inline enable_if_deep<D> packRootSTL(std::vector<D> &obj) {
-                int len;
+                if (defer(runRootSTL<std::vector<D>>, &obj, 0)) return;
+                RootScope scope(*this);
+                int len = 0;
                 if (TRANSPORT_METHOD::SOURCE) {
                     len = obj.size(); transport(len);
                 }
+                else if (inPlace) {
+                    transportRootLength(len);
+                    transportInPlace<D, visitDeep<D>>(obj, len);
+                    return;
+                }
                 else {
-                    transport(len); obj.resize(len);
+                    transportRootLength(len); obj.resize(len);
                     for (int i = 0; i < len; ++i) (&obj[i])->~D();
                 }
 
@@ -701,82 +1936,214 @@ namespace MEL {
 
             template<typename T>
             inline enable_if_not_deep<T> packRootSTL(std::list<T> &obj) {
-                int len;
-                if (TRANSPORT_METHOD::SOURCE) {
-                    len = obj.size(); transport(len);
-                }
-                else {
-                    transport(len); obj.resize(len);
-                }
-
+                if (defer(runRootSTL<std::list<T>>, &obj, 0, !NeedsVisit<T>::value)) return;
+                RootScope scope(*this);
+                if (!TRANSPORT_METHOD::SOURCE) obj.clear();
+                packSequence(obj);
                 /// Copy content
-                for (auto it = obj.begin(); it != obj.end(); ++it) {
-                    if (!TRANSPORT_METHOD::SOURCE) (it)->~T();
-                    this->packRootVar(*it);
-                }
+                if (NeedsVisit<T>::value) for (auto &e : obj) packContents(e);
             };
 
-            template<typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP> F>
+            template<typename T, DEEP_FUNCTOR<T, TRANSPORT_METHOD, HASH_MAP, ALLOCATOR> F>
             inline void packRootSTL(std::list<T> &obj) {
-                int len;
-                if (TRANSPORT_METHOD::SOURCE) {
-                    len = obj.size(); transport(len);
-                }
-                else {
-                    transport(len); obj.resize(len);
-                }
-
+                if (defer(runRootSTLF<std::list<T>, T, F>, &obj, 0)) return;
+                RootScope scope(*this);
+                if (!TRANSPORT_METHOD::SOURCE) obj.clear();
+                packSequence(obj);
                 /// Copy content
-                for (auto it = obj.begin(); it != obj.end(); ++it) {
-                    if (!TRANSPORT_METHOD::SOURCE) (it)->~T();
-                    this->packRootVar<T, F>(*it);
-                }
+                for (auto &e : obj) F(e, *this);
             };
 
             template<typename D>
             inline enable_if_deep<D> packRootSTL(std::list<D> &obj) {
-                int len;
-                if (TRANSPORT_METHOD::SOURCE) {
-                    len = obj.size(); transport(len);
-                }
-                else {
-                    transport(len); obj.resize(len);
-                }
+                if (defer(runRootSTL<std::list<D>>, &obj, 0)) return;
+                RootScope scope(*this);
+                if (!TRANSPORT_METHOD::SOURCE) obj.clear();
+                packSequence(obj);
+                /// Copy content
+                for (auto &e : obj) e.DeepCopy(*this);
+            };
 
+            template<typename T, typename A>
+            inline void packRootSTL(std::deque<T, A> &obj) {
+                if (defer(runRootSTL<std::deque<T, A>>, &obj, 0, !NeedsVisit<T>::value)) return;
+                RootScope scope(*this);
+                if (!TRANSPORT_METHOD::SOURCE) obj.clear();
+                packSequence(obj);
                 /// Copy content
-                for (auto it = obj.begin(); it != obj.end(); ++it) {
-                    if (!TRANSPORT_METHOD::SOURCE) (it)->~D();
-                    this->packRootVar(*it);
-                }
+                if (NeedsVisit<T>::value) for (auto &e : obj) packContents(e);
+            };
+
+            template<typename T, size_t N>
+            inline void packRootSTL(std::array<T, N> &obj) {
+                if (defer(runRootSTL<std::array<T, N>>, &obj, 0, !NeedsVisit<T>::value)) return;
+                RootScope scope(*this);
+                if (!TRANSPORT_METHOD::SOURCE) for (auto &e : obj) e.~T();
+                transport(obj);
+                /// Copy content
+                if (NeedsVisit<T>::value) for (auto &e : obj) packContents(e);
+            };
+
+            template<typename K, typename V, typename C, typename A>
+            inline void packRootSTL(std::map<K, V, C, A> &obj) {
+                if (defer(runRootSTL<std::map<K, V, C, A>>, &obj, 0, !NeedsVisit<K>::value && !NeedsVisit<V>::value)) return;
+                RootScope scope(*this);
+                if (!TRANSPORT_METHOD::SOURCE) obj.clear();
+                packMap(obj);
+            };
+
+            template<typename K, typename V, typename H, typename E, typename A>
+            inline void packRootSTL(std::unordered_map<K, V, H, E, A> &obj) {
+                if (defer(runRootSTL<std::unordered_map<K, V, H, E, A>>, &obj, 0, !NeedsVisit<K>::value && !NeedsVisit<V>::value)) return;
+                RootScope scope(*this);
+                if (!TRANSPORT_METHOD::SOURCE) obj.clear();
+                packMap(obj);
+            };
+
+            template<typename K, typename C, typename A>
+            inline void packRootSTL(std::set<K, C, A> &obj) {
+                if (defer(runRootSTL<std::set<K, C, A>>, &obj, 0, !NeedsVisit<K>::value)) return;
+                RootScope scope(*this);
+                if (!TRANSPORT_METHOD::SOURCE) obj.clear();
+                packSet(obj);
+            };
+
+            template<typename K, typename H, typename E, typename A>
+            inline void packRootSTL(std::unordered_set<K, H, E, A> &obj) {
+                if (defer(runRootSTL<std::unordered_set<K, H, E, A>>, &obj, 0, !NeedsVisit<K>::value)) return;
+                RootScope scope(*this);
+                if (!TRANSPORT_METHOD::SOURCE) obj.clear();
+                packSet(obj);
             };
 
             /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
             // Shorthand Overloads
 
             template<typename T>
-            inline Message<TRANSPORT_METHOD, HASH_MAP>& operator&(std::vector<T> &obj) {
+            inline Message<TRANSPORT_METHOD, HASH_MAP, ALLOCATOR>& operator&(std::vector<T> &obj) {
+                packSTL(obj);
+                return *this;
+            };
+
+            template<typename T>
+            inline Message<TRANSPORT_METHOD, HASH_MAP, ALLOCATOR>& operator&(std::list<T> &obj) {
+                packSTL(obj);
+                return *this;
+            };
+
+            template<typename T, typename A>
+            inline Message<TRANSPORT_METHOD, HASH_MAP, ALLOCATOR>& operator&(std::deque<T, A> &obj) {
+                packSTL(obj);
+                return *this;
+            };
+
+            template<typename T, size_t N>
+            inline Message<TRANSPORT_METHOD, HASH_MAP, ALLOCATOR>& operator&(std::array<T, N> &obj) {
+                packSTL(obj);
+                return *this;
+            };
+
+            template<typename K, typename V, typename C, typename A>
+            inline Message<TRANSPORT_METHOD, HASH_MAP, ALLOCATOR>& operator&(std::map<K, V, C, A> &obj) {
+                packSTL(obj);
+                return *this;
+            };
+
+            template<typename K, typename V, typename H, typename E, typename A>
+            inline Message<TRANSPORT_METHOD, HASH_MAP, ALLOCATOR>& operator&(std::unordered_map<K, V, H, E, A> &obj) {
+                packSTL(obj);
+                return *this;
+            };
+
+            template<typename K, typename C, typename A>
+            inline Message<TRANSPORT_METHOD, HASH_MAP, ALLOCATOR>& operator&(std::set<K, C, A> &obj) {
+                packSTL(obj);
+                return *this;
+            };
+
+            template<typename K, typename H, typename E, typename A>
+            inline Message<TRANSPORT_METHOD, HASH_MAP, ALLOCATOR>& operator&(std::unordered_set<K, H, E, A> &obj) {
+                packSTL(obj);
+                return *this;
+            };
+
+            template<typename T>
+            inline Message<TRANSPORT_METHOD, HASH_MAP, ALLOCATOR>& operator&(std::unique_ptr<T> &obj) {
                 packSTL(obj);
                 return *this;
             };
 
             template<typename T>
-            inline Message<TRANSPORT_METHOD, HASH_MAP>& operator&(std::list<T> &obj) {
+            inline Message<TRANSPORT_METHOD, HASH_MAP, ALLOCATOR>& operator&(std::shared_ptr<T> &obj) {
                 packSTL(obj);
                 return *this;
             };
 
             template<typename T>
-            inline Message<TRANSPORT_METHOD, HASH_MAP>& operator&(T &obj) {
+            inline Message<TRANSPORT_METHOD, HASH_MAP, ALLOCATOR>& operator&(T &obj) {
                 packVar(obj);
                 return *this;
             };
 
-            inline Message<TRANSPORT_METHOD, HASH_MAP>& operator&(std::string &obj) {
+            inline Message<TRANSPORT_METHOD, HASH_MAP, ALLOCATOR>& operator&(std::string &obj) {
                 packSTL(obj);
                 return *this;
             };
         };
 
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Field Lists
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        /// \cond HIDE
+        // Members that need no visit, their bytes already travel with the enclosing object
+        template<typename MSG, typename T>
+        inline typename std::enable_if<!NeedsVisit<T>::value && !std::is_pointer<T>::value && !std::is_array<T>::value>::type PackField(MSG &, T &) {};
+
+        template<typename MSG, typename D>
+        inline enable_if_deep<D> PackField(MSG &msg, D &obj) {
+            msg.packVar(obj);
+        };
+
+        template<typename MSG, typename T>
+        inline void PackField(MSG &msg, T* &ptr) {
+            msg.packPtr(ptr);
+        };
+
+        template<typename MSG, typename S>
+        inline typename std::enable_if<is_member_stl<S>::value>::type PackField(MSG &msg, S &obj) {
+            msg.packSTL(obj);
+        };
+
+        template<typename MSG, typename T, size_t N>
+        inline void PackField(MSG &msg, T (&arr)[N]) {
+            for (size_t i = 0; i < N; ++i) PackField(msg, arr[i]);
+        };
+
+        template<typename T, typename MSG>
+        struct PackFields {
+            T   &obj;
+            MSG &msg;
+
+            template<typename M>
+            inline void operator()(M T::*member) {
+                PackField(msg, obj.*member);
+            };
+        };
+        /// \endcond
+
+        // Generates DeepCopy for the enclosing struct from a list of up to 16 member names. Members are visited in list order:
+        // deep members recurse, pointers are followed as single objects (packPtr), and STL containers, strings and smart 
+        // pointers are rebuilt. Trivially copyable members already travel with the object's own bytes, so they may be listed 
+        // but cost no transport. Pointers to arrays or to shared objects still need a hand written DeepCopy
+#define MEL_DEEP_FIELDS(...)                                                                                            \
+        template<typename MSG>                                                                                          \
+        inline void DeepCopy(MSG &msg) {                                                                                \
+            typedef typename std::remove_reference<decltype(*this)>::type MEL_DEEP_SELF;                                \
+            MEL::Deep::PackFields<MEL_DEEP_SELF, MSG> f{ *this, msg };                                                  \
+            MEL_FIELD_EXPAND(MEL_FIELD_CAT(MEL_FIELD_, MEL_FIELD_COUNT(__VA_ARGS__))(MEL_DEEP_SELF, __VA_ARGS__))       \
+        }
+
 #define TEMPLATE_STL template<typename S, typename HASH_MAP = MEL::Deep::PointerHashMap>
 #define TEMPLATE_T   template<typename T, typename HASH_MAP = MEL::Deep::PointerHashMap>
 #define TEMPLATE_P   template<typename P, typename HASH_MAP = MEL::Deep::PointerHashMap>
@@ -792,6 +2159,29 @@ namespace MEL {
 #define TEMPLATE_P_F2(transport_method1, transport_method2)   template<typename P, typename HASH_MAP, DEEP_FUNCTOR<typename std::remove_pointer<P>::type, transport_method1, HASH_MAP> F1, \
                                                                                                       DEEP_FUNCTOR<typename std::remove_pointer<P>::type, transport_method2, HASH_MAP> F2>
 
+/// Functors for the Arena receive variants, whose receiving messages allocate from an ArenaAllocator
+#define TEMPLATE_STL_F_ARENA(transport_method) template<typename S, typename HASH_MAP, DEEP_FUNCTOR<typename S::value_type, transport_method, HASH_MAP, MEL::Deep::ArenaAllocator> F>
+#define TEMPLATE_T_F_ARENA(transport_method)   template<typename T, typename HASH_MAP, DEEP_FUNCTOR<T, transport_method, HASH_MAP, MEL::Deep::ArenaAllocator> F>
+#define TEMPLATE_P_F_ARENA(transport_method)   template<typename P, typename HASH_MAP, DEEP_FUNCTOR<typename std::remove_pointer<P>::type, transport_method, HASH_MAP, MEL::Deep::ArenaAllocator> F>
+
+#define TEMPLATE_STL_F2_ARENA(transport_method1, transport_method2) template<typename S, typename HASH_MAP, DEEP_FUNCTOR<typename S::value_type, transport_method1, HASH_MAP> F1,                \
+                                                                                                            DEEP_FUNCTOR<typename S::value_type, transport_method2, HASH_MAP, MEL::Deep::ArenaAllocator> F2>
+#define TEMPLATE_T_F2_ARENA(transport_method1, transport_method2)   template<typename T, typename HASH_MAP, DEEP_FUNCTOR<T, transport_method1, HASH_MAP> F1,                                     \
+                                                                                                            DEEP_FUNCTOR<T, transport_method2, HASH_MAP, MEL::Deep::ArenaAllocator> F2>
+#define TEMPLATE_P_F2_ARENA(transport_method1, transport_method2)   template<typename P, typename HASH_MAP, DEEP_FUNCTOR<typename std::remove_pointer<P>::type, transport_method1, HASH_MAP> F1, \
+                                                                                                            DEEP_FUNCTOR<typename std::remove_pointer<P>::type, transport_method2, HASH_MAP, MEL::Deep::ArenaAllocator> F2>
+
+#define TEMPLATE_VIA_STL template<typename COLLECTIVE, typename S, typename HASH_MAP>
+#define TEMPLATE_VIA_T   template<typename COLLECTIVE, typename T, typename HASH_MAP>
+#define TEMPLATE_VIA_P   template<typename COLLECTIVE, typename P, typename HASH_MAP>
+
+#define TEMPLATE_VIA_STL_F2(transport_method1, transport_method2) template<typename COLLECTIVE, typename S, typename HASH_MAP, DEEP_FUNCTOR<typename S::value_type, transport_method1, HASH_MAP> F1,                \
+                                                                                                                               DEEP_FUNCTOR<typename S::value_type, transport_method2, HASH_MAP> F2>
+#define TEMPLATE_VIA_T_F2(transport_method1, transport_method2)   template<typename COLLECTIVE, typename T, typename HASH_MAP, DEEP_FUNCTOR<T, transport_method1, HASH_MAP> F1,                                     \
+                                                                                                                               DEEP_FUNCTOR<T, transport_method2, HASH_MAP> F2>
+#define TEMPLATE_VIA_P_F2(transport_method1, transport_method2)   template<typename COLLECTIVE, typename P, typename HASH_MAP, DEEP_FUNCTOR<typename std::remove_pointer<P>::type, transport_method1, HASH_MAP> F1, \
+                                                                                                                               DEEP_FUNCTOR<typename std::remove_pointer<P>::type, transport_method2, HASH_MAP> F2>
+
         /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
         // Buffer Size
         /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -869,6 +2259,258 @@ namespace MEL {
             return msg.getOffset();
         };
 
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Compression
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        // Buffered messages sent between processes are compressed when enabled is set and the packed buffer is at least threshold bytes.
+        // shuffleWidth > 1 byte-shuffles the buffer before compressing, which helps buffers dominated by float / double arrays.
+        // All processes taking part in a buffered transfer must use the same value of enabled. Nothing on the wire says whether a
+        // buffer is compressed, so the setting has to be agreed out of band, as the types of a plain MPI message are
+        struct CompressionConfig {
+            bool enabled;
+            int  threshold, shuffleWidth;
+
+            CompressionConfig() : enabled(false), threshold(1 << 16), shuffleWidth(0) {};
+        };
+
+        inline CompressionConfig& GetCompressionConfig() {
+            static CompressionConfig config;
+            return config;
+        };
+
+        // Running totals for this process, counting only buffers that went through the compression stage
+        struct CompressionStats {
+            long long messages, rawBytes, wireBytes;
+
+            CompressionStats() : messages(0), rawBytes(0), wireBytes(0) {};
+
+            inline double ratio() const {
+                return (wireBytes > 0) ? ((double) rawBytes / (double) wireBytes) : 1.0;
+            };
+        };
+
+        inline CompressionStats& GetCompressionStats() {
+            static CompressionStats stats;
+            return stats;
+        };
+
+        namespace Codec {
+            // A byte oriented LZ77 codec using the LZ4 block layout: a token of literal / match length nibbles, 
+            // the literals, a 16 bit little-endian offset, and 255-run length extensions
+            static constexpr int HASH_BITS = 14, MIN_MATCH = 4, LAST_LITERALS = 5, MATCH_LIMIT = 12, MAX_OFFSET = 65535;
+
+            inline unsigned int Read32(const unsigned char *ptr) {
+                unsigned int v;
+                memcpy(&v, ptr, sizeof(unsigned int));
+                return v;
+            };
+
+            inline unsigned int Hash(const unsigned int v) {
+                return (v * 2654435761u) >> (32 - HASH_BITS);
+            };
+
+            inline void PutLength(unsigned char *&op, int len) {
+                for (; len >= 255; len -= 255) *op++ = 255;
+                *op++ = (unsigned char) len;
+            };
+
+            inline bool GetLength(const unsigned char *&ip, const unsigned char *iend, int &len) {
+                unsigned char b;
+                do {
+                    if (ip >= iend) return false;
+                    b = *ip++;
+                    len += b;
+                } while (b == 255);
+                return true;
+            };
+
+            // Returns the compressed size, or -1 if it would not fit in cap bytes
+            inline int Compress(const char *src, const int len, char *dst, const int cap) {
+                const unsigned char *base = (const unsigned char*) src, *ip = base, *anchor = base, *iend = base + len;
+                unsigned char *op = (unsigned char*) dst, *oend = op + cap;
+
+                if (len > MATCH_LIMIT) {
+                    std::vector<int> table(1 << HASH_BITS, -1);
+                    const unsigned char *mflimit = iend - MATCH_LIMIT, *mlimit = iend - LAST_LITERALS;
+
+                    while (ip < mflimit) {
+                        const unsigned int seq = Read32(ip), h = Hash(seq);
+                        const int pos = (int) (ip - base), cand = table[h];
+                        table[h] = pos;
+
+                        if (cand < 0 || (pos - cand) > MAX_OFFSET || Read32(base + cand) != seq) {
+                            ++ip;
+                            continue;
+                        }
+
+                        const unsigned char *ref = base + cand;
+                        int matchLen = MIN_MATCH;
+                        while ((ip + matchLen) < mlimit && ip[matchLen] == ref[matchLen]) ++matchLen;
+
+                        const int litLen = (int) (ip - anchor), offset = pos - cand;
+                        if ((oend - op) < (litLen + (litLen / 255) + (matchLen / 255) + 8)) return -1;
+
+                        unsigned char *token = op++;
+                        *token = (unsigned char) ((std::min(litLen, 15) << 4) | std::min(matchLen - MIN_MATCH, 15));
+                        if (litLen >= 15) PutLength(op, litLen - 15);
+                        memcpy(op, anchor, litLen);
+                        op += litLen;
+                        *op++ = (unsigned char) (offset & 255);
+                        *op++ = (unsigned char) (offset >> 8);
+                        if ((matchLen - MIN_MATCH) >= 15) PutLength(op, matchLen - MIN_MATCH - 15);
+
+                        ip += matchLen;
+                        anchor = ip;
+                    }
+                }
+
+                const int litLen = (int) (iend - anchor);
+                if ((oend - op) < (litLen + (litLen / 255) + 2)) return -1;
+                *op++ = (unsigned char) (std::min(litLen, 15) << 4);
+                if (litLen >= 15) PutLength(op, litLen - 15);
+                memcpy(op, anchor, litLen);
+                op += litLen;
+                return (int) (op - (unsigned char*) dst);
+            };
+
+            // Returns false if src is not a valid stream that decodes to exactly len bytes
+            inline bool Decompress(const char *src, const int srcLen, char *dst, const int len) {
+                const unsigned char *ip = (const unsigned char*) src, *iend = ip + srcLen;
+                unsigned char *base = (unsigned char*) dst, *op = base, *oend = base + len;
+
+                while (ip < iend) {
+                    const unsigned char token = *ip++;
+                    int litLen = token >> 4;
+                    if (litLen == 15 && !GetLength(ip, iend, litLen)) return false;
+                    if (litLen > (iend - ip) || litLen > (oend - op)) return false;
+                    memcpy(op, ip, litLen);
+                    op += litLen;
+                    ip += litLen;
+                    if (ip == iend) break;
+
+                    if ((iend - ip) < 2) return false;
+                    const int offset = ip[0] | (ip[1] << 8);
+                    ip += 2;
+                    int matchLen = token & 15;
+                    if (matchLen == 15 && !GetLength(ip, iend, matchLen)) return false;
+                    matchLen += MIN_MATCH;
+                    if (offset == 0 || offset > (op - base) || matchLen > (oend - op)) return false;
+
+                    const unsigned char *ref = op - offset;
+                    for (int i = 0; i < matchLen; ++i) op[i] = ref[i];
+                    op += matchLen;
+                }
+                return op == oend;
+            };
+
+            // Groups byte b of every width byte element together, so slowly varying high bytes form long runs
+            inline void Shuffle(const char *src, char *dst, const int len, const int width) {
+                const int count = len / width;
+                for (int b = 0; b < width; ++b)
+                    for (int i = 0; i < count; ++i) dst[b * count + i] = src[i * width + b];
+                memcpy(dst + count * width, src + count * width, len - count * width);
+            };
+
+            inline void Unshuffle(const char *src, char *dst, const int len, const int width) {
+                const int count = len / width;
+                for (int b = 0; b < width; ++b)
+                    for (int i = 0; i < count; ++i) dst[i * width + b] = src[b * count + i];
+                memcpy(dst + count * width, src + count * width, len - count * width);
+            };
+        };
+
+        // A compressed frame is a four int header { marker, raw length, codec, shuffle width } followed by the payload.
+        // Codec 0 stores the buffer as is, codec 1 holds an LZ stream. Only DecompressBuffer looks at the header, the marker 
+        // catches a corrupt frame, it is never used to guess whether a buffer is compressed
+        static constexpr int COMPRESSION_MARKER = 0x5A4C454D;
+        static constexpr int COMPRESSION_HEADER = 4 * sizeof(int);
+
+        inline bool IsValidFrame(const char *frame, const int frameLen) {
+            if (frame == nullptr || frameLen < COMPRESSION_HEADER) return false;
+            int header[4];
+            memcpy(header, frame, COMPRESSION_HEADER);
+            if (header[0] != COMPRESSION_MARKER || header[1] < 0) return false;
+            if (header[2] == 0) return frameLen == COMPRESSION_HEADER + header[1];
+            return header[2] == 1 && header[3] >= 0;
+        };
+
+        // Returns a new frame allocated with MEL::MemAlloc holding the compressed buffer
+        inline char* CompressBuffer(const char *buffer, const int len, int &frameLen) {
+            const CompressionConfig &config = GetCompressionConfig();
+            char *frame = MEL::MemAlloc<char>(COMPRESSION_HEADER + len);
+            int header[4] = { COMPRESSION_MARKER, len, 0, 0 };
+
+            if (len >= config.threshold) {
+                const char *src = buffer;
+                char *shuffled = nullptr;
+                if (config.shuffleWidth > 1) {
+                    shuffled = MEL::MemAlloc<char>(len);
+                    Codec::Shuffle(buffer, shuffled, len, config.shuffleWidth);
+                    src = shuffled;
+                }
+
+                const int packed = Codec::Compress(src, len, frame + COMPRESSION_HEADER, len);
+                if (packed >= 0 && packed < len) {
+                    header[2] = 1;
+                    header[3] = (shuffled != nullptr) ? config.shuffleWidth : 0;
+                    frameLen = COMPRESSION_HEADER + packed;
+                }
+                MEL::MemFree(shuffled);
+            }
+
+            if (header[2] == 0) {
+                memcpy(frame + COMPRESSION_HEADER, buffer, len);
+                frameLen = COMPRESSION_HEADER + len;
+            }
+            memcpy(frame, header, COMPRESSION_HEADER);
+
+            if (len >= config.threshold) {
+                CompressionStats &stats = GetCompressionStats();
+                ++stats.messages;
+                stats.rawBytes  += len;
+                stats.wireBytes += frameLen;
+            }
+            return frame;
+        };
+
+        // Returns a new buffer allocated with MEL::MemAlloc holding the decompressed frame
+        inline char* DecompressBuffer(const char *frame, const int frameLen, int &len) {
+            int header[4];
+            if (!IsValidFrame(frame, frameLen)) MEL::Abort(-1, "MEL::Deep::DecompressBuffer : Corrupt frame, all processes must agree on GetCompressionConfig().enabled...");
+            memcpy(header, frame, COMPRESSION_HEADER);
+            len = header[1];
+
+            const char *payload = frame + COMPRESSION_HEADER;
+            const int payloadLen = frameLen - COMPRESSION_HEADER;
+            char *buffer = MEL::MemAlloc<char>(len);
+
+            if (header[2] == 0) {
+                memcpy(buffer, payload, len);
+            }
+            else if (header[3] > 1) {
+                char *shuffled = MEL::MemAlloc<char>(len);
+                if (!Codec::Decompress(payload, payloadLen, shuffled, len)) MEL::Abort(-1, "MEL::Deep::DecompressBuffer : Corrupt frame...");
+                Codec::Unshuffle(shuffled, buffer, len, header[3]);
+                MEL::MemFree(shuffled);
+            }
+            else {
+                if (!Codec::Decompress(payload, payloadLen, buffer, len)) MEL::Abort(-1, "MEL::Deep::DecompressBuffer : Corrupt frame...");
+            }
+            return buffer;
+        };
+
+        // Exchange a packed buffer between processes, passing through the compression stage when enabled.
+        // Defined after the Bcast section, once the char buffer overloads they forward to exist
+        inline void SendBuffer(char *buffer, const int len, const int dst, const int tag, const Comm &comm);
+        inline MEL::Status RecvBuffer(char *&buffer, int &len, const int src, const int tag, const Comm &comm);
+        inline void BcastBuffer(char *&buffer, int const &len, const int root, const Comm &comm);
+        inline void BcastBuffer(char *&buffer, int &len, const int root, const Comm &comm);
+#ifdef MEL_3
+        inline void HierarchicalBcastBuffer(char *&buffer, int const &len, const int root, const Comm &comm);
+        inline void HierarchicalBcastBuffer(char *&buffer, int &len, const int root, const Comm &comm);
+#endif
+
         /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
         // Send
         /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -898,7 +2540,7 @@ namespace MEL {
             msg.packRootVar(len);
             msg.packRootPtr(ptr, len);
 
-            MEL::Deep::Send(buffer, msg.getOffset(), dst, tag, comm);
+            MEL::Deep::SendBuffer(buffer, msg.getOffset(), dst, tag, comm);
 
             MEL::MemFree(buffer);
         };
@@ -912,7 +2554,7 @@ namespace MEL {
             msg.packRootVar(len);
             msg. template packRootPtr<T, F>(ptr, len);
             
-            MEL::Deep::Send(buffer, msg.getOffset(), dst, tag, comm);
+            MEL::Deep::SendBuffer(buffer, msg.getOffset(), dst, tag, comm);
             MEL::MemFree(buffer);
         };
 
@@ -953,7 +2595,7 @@ namespace MEL {
             Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
             msg.packRootPtr(ptr);
 
-            MEL::Deep::Send(buffer, msg.getOffset(), dst, tag, comm);
+            MEL::Deep::SendBuffer(buffer, msg.getOffset(), dst, tag, comm);
 
             MEL::MemFree(buffer);
         };
@@ -965,7 +2607,7 @@ namespace MEL {
             typedef typename std::remove_pointer<P>::type T;
             msg. template packRootPtr<T, F>(ptr);
 
-            MEL::Deep::Send(buffer, msg.getOffset(), dst, tag, comm);
+            MEL::Deep::SendBuffer(buffer, msg.getOffset(), dst, tag, comm);
             MEL::MemFree(buffer);
         };
 
@@ -1001,7 +2643,7 @@ namespace MEL {
             Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
             msg.packRootSTL(obj);
 
-            MEL::Deep::Send(buffer, msg.getOffset(), dst, tag, comm);
+            MEL::Deep::SendBuffer(buffer, msg.getOffset(), dst, tag, comm);
             MEL::MemFree(buffer);
         };
 
@@ -1012,7 +2654,7 @@ namespace MEL {
             Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
             msg. template packRootSTL<T, F>(obj);
 
-            MEL::Deep::Send(buffer, msg.getOffset(), dst, tag, comm);
+            MEL::Deep::SendBuffer(buffer, msg.getOffset(), dst, tag, comm);
             MEL::MemFree(buffer);
         };
 
@@ -1047,7 +2689,7 @@ namespace MEL {
             Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
             msg.packRootVar(obj);
 
-            MEL::Deep::Send(buffer, msg.getOffset(), dst, tag, comm);
+            MEL::Deep::SendBuffer(buffer, msg.getOffset(), dst, tag, comm);
             MEL::MemFree(buffer);
         };
 
@@ -1057,7 +2699,7 @@ namespace MEL {
             Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
             msg. template packRootVar<T, F>(obj);
 
-            MEL::Deep::Send(buffer, msg.getOffset(), dst, tag, comm);
+            MEL::Deep::SendBuffer(buffer, msg.getOffset(), dst, tag, comm);
             MEL::MemFree(buffer);
         };
 
@@ -1116,7 +2758,7 @@ namespace MEL {
         inline enable_if_pointer<P> BufferedRecv(P &ptr, int &len, const int src, const int tag, const Comm &comm) {
             int bufferSize;
             char *buffer = nullptr;
-            MEL::Deep::Recv(buffer, bufferSize, src, tag, comm);
+            MEL::Deep::RecvBuffer(buffer, bufferSize, src, tag, comm);
 
             Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
             msg.packRootVar(len);
@@ -1131,7 +2773,7 @@ namespace MEL {
             
             int bufferSize;
             char *buffer = nullptr;
-            MEL::Deep::Recv(buffer, bufferSize, src, tag, comm);
+            MEL::Deep::RecvBuffer(buffer, bufferSize, src, tag, comm);
 
             Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
             msg.packRootVar(len);
@@ -1144,7 +2786,7 @@ namespace MEL {
         inline enable_if_pointer<P> BufferedRecv(P &ptr, int const &len, const int src, const int tag, const Comm &comm) {
             int bufferSize;
             char *buffer = nullptr;
-            MEL::Deep::Recv(buffer, bufferSize, src, tag, comm);
+            MEL::Deep::RecvBuffer(buffer, bufferSize, src, tag, comm);
 
             Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
             int _len = len;
@@ -1161,7 +2803,7 @@ namespace MEL {
             
             int bufferSize;
             char *buffer = nullptr;
-            MEL::Deep::Recv(buffer, bufferSize, src, tag, comm);
+            MEL::Deep::RecvBuffer(buffer, bufferSize, src, tag, comm);
 
             Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
             int _len = len;
@@ -1193,7 +2835,7 @@ namespace MEL {
         inline enable_if_pointer<P> BufferedRecv(P &ptr, const int src, const int tag, const Comm &comm) {
             int bufferSize;
             char *buffer = nullptr;
-            MEL::Deep::Recv(buffer, bufferSize, src, tag, comm);
+            MEL::Deep::RecvBuffer(buffer, bufferSize, src, tag, comm);
 
             Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
             msg.packRootPtr(ptr);
@@ -1207,7 +2849,7 @@ namespace MEL {
             
             int bufferSize;
             char *buffer = nullptr;
-            MEL::Deep::Recv(buffer, bufferSize, src, tag, comm);
+            MEL::Deep::RecvBuffer(buffer, bufferSize, src, tag, comm);
 
             Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
             msg. template packRootPtr<T, F>(ptr);
@@ -1235,7 +2877,7 @@ namespace MEL {
         inline enable_if_stl<S> BufferedRecv(S &obj, const int src, const int tag, const Comm &comm) {
             int bufferSize;
             char *buffer = nullptr;
-            MEL::Deep::Recv(buffer, bufferSize, src, tag, comm);
+            MEL::Deep::RecvBuffer(buffer, bufferSize, src, tag, comm);
 
             Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
             msg.packRootSTL(obj);
@@ -1248,7 +2890,7 @@ namespace MEL {
             typedef typename S::value_type T;
             int bufferSize;
             char *buffer = nullptr;
-            MEL::Deep::Recv(buffer, bufferSize, src, tag, comm);
+            MEL::Deep::RecvBuffer(buffer, bufferSize, src, tag, comm);
 
             Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
             msg. template packRootSTL<T, F>(obj);
@@ -1275,7 +2917,7 @@ namespace MEL {
         inline enable_if_deep_not_pointer_not_stl<T> BufferedRecv(T &obj, const int src, const int tag, const Comm &comm) {
             int bufferSize;
             char *buffer = nullptr;
-            MEL::Deep::Recv(buffer, bufferSize, src, tag, comm);
+            MEL::Deep::RecvBuffer(buffer, bufferSize, src, tag, comm);
 
             Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
             msg.packRootVar(obj);
@@ -1287,7 +2929,7 @@ namespace MEL {
         inline enable_if_not_pointer_not_stl<T> BufferedRecv(T &obj, const int src, const int tag, const Comm &comm) {
             int bufferSize;
             char *buffer = nullptr;
-            MEL::Deep::Recv(buffer, bufferSize, src, tag, comm);
+            MEL::Deep::RecvBuffer(buffer, bufferSize, src, tag, comm);
 
             Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
             msg. template packRootVar<T, F>(obj);
@@ -1296,499 +2938,2037 @@ namespace MEL {
         };
 
         /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-        // Bcast
-        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Any Source
+        //
+        // Receive a deep message from whichever process sends first. The source (and tag, if MEL::ANY_TAG is given) is pinned on 
+        // the first envelope, so the remaining envelopes of the message are pulled from the same sender. Returns the status of 
+        // the matched sender, e.g. for a task farm: status = RecvAny(result, tag, comm); Send(task, status.MPI_SOURCE, tag, comm);
 
         /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
         // Pointer / Length
 
         TEMPLATE_P
-        inline enable_if_pointer<P> Bcast(P &ptr, int const &len, const int root, const Comm &comm) {
-            if (MEL::CommRank(comm) == root) {
-                Message<TransportBcastRoot, HASH_MAP> msg(root, comm);
-                int _len = len;
-                msg.packRootVar(_len);
-                msg.packRootPtr(ptr, _len);
-            }
-            else {
-                Message<TransportBcast, HASH_MAP> msg(root, comm);
-                
-                int _len = len;
-                msg.packRootVar(_len);
-                if (len != _len) MEL::Exit(-1, "MEL::Deep::Bcast(ptr, len) const int len provided does not match incomming message size.");
-                msg.packRootPtr(ptr, _len);
-            }
+        inline enable_if_pointer<P, MEL::Status> RecvAny(P &ptr, int &len, const int tag, const Comm &comm) {
+            Message<TransportRecv, HASH_MAP> msg(MEL::ANY_SOURCE, tag, comm);
+            msg.packRootVar(len);
+            msg.packRootPtr(ptr, len);
+            return msg.getTransporter().getStatus();
         };
 
-        TEMPLATE_P_F2(TransportBcastRoot, TransportBcast)
-        inline enable_if_pointer<P> Bcast(P &ptr, int const &len, const int root, const Comm &comm) {
+        TEMPLATE_P_F(TransportRecv)
+        inline enable_if_pointer<P, MEL::Status> RecvAny(P &ptr, int &len, const int tag, const Comm &comm) {
             typedef typename std::remove_pointer<P>::type T;
-            if (MEL::CommRank(comm) == root) {
-                Message<TransportBcastRoot, HASH_MAP> msg(root, comm);
-                int _len = len;
-                msg.packRootVar(_len);
-                msg. template packRootPtr<T, F1>(ptr, _len);
-            }
-            else {
-                Message<TransportBcast, HASH_MAP> msg(root, comm);
-                
-                int _len = len;
-                msg.packRootVar(_len);
-                if (len != _len) MEL::Exit(-1, "MEL::Deep::Bcast(ptr, len) const int len provided does not match incomming message size.");
-                msg. template packRootPtr<T, F2>(ptr, _len);
-            }
+            Message<TransportRecv, HASH_MAP> msg(MEL::ANY_SOURCE, tag, comm);
+            msg.packRootVar(len);
+            msg. template packRootPtr<T, F>(ptr, len);
+            return msg.getTransporter().getStatus();
         };
 
         TEMPLATE_P
-        inline enable_if_pointer<P> Bcast(P &ptr, int &len, const int root, const Comm &comm) {
-            if (MEL::CommRank(comm) == root) {
-                Message<TransportBcastRoot, HASH_MAP> msg(root, comm);
-                msg.packRootVar(len);
-                msg.packRootPtr(ptr, len);
-            }
-            else {
-                Message<TransportBcast, HASH_MAP> msg(root, comm);
-                
-                msg.packRootVar(len);
-                msg.packRootPtr(ptr, len);
-            }
+        inline enable_if_pointer<P, MEL::Status> BufferedRecvAny(P &ptr, int &len, const int tag, const Comm &comm) {
+            int bufferSize;
+            char *buffer = nullptr;
+            MEL::Status status = MEL::Deep::RecvBuffer(buffer, bufferSize, MEL::ANY_SOURCE, tag, comm);
+
+            Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
+            msg.packRootVar(len);
+            msg.packRootPtr(ptr, len);
+
+            MEL::MemFree(buffer);
+            return status;
         };
 
-        TEMPLATE_P_F2(TransportBcastRoot, TransportBcast)
-        inline enable_if_pointer<P> Bcast(P &ptr, int &len, const int root, const Comm &comm) {
+        TEMPLATE_P_F(TransportBufferRead)
+        inline enable_if_pointer<P, MEL::Status> BufferedRecvAny(P &ptr, int &len, const int tag, const Comm &comm) {
             typedef typename std::remove_pointer<P>::type T;
-            if (MEL::CommRank(comm) == root) {
-                Message<TransportBcastRoot, HASH_MAP> msg(root, comm);
-                msg.packRootVar(len);
-                msg. template packRootPtr<T, F1>(ptr, len);
-            }
-            else {
-                Message<TransportBcast, HASH_MAP> msg(root, comm);
-                msg.packRootVar(len);
-                msg. template packRootPtr<T, F2>(ptr, len);
-            }
+
+            int bufferSize;
+            char *buffer = nullptr;
+            MEL::Status status = MEL::Deep::RecvBuffer(buffer, bufferSize, MEL::ANY_SOURCE, tag, comm);
+
+            Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
+            msg.packRootVar(len);
+            msg. template packRootPtr<T, F>(ptr, len);
+
+            MEL::MemFree(buffer);
+            return status;
         };
 
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Pointer
+
         TEMPLATE_P
-        inline enable_if_pointer<P> BufferedBcast(P &ptr, int &len, const int root, const Comm &comm, const int bufferSize) {
-            if (MEL::CommRank(comm) == root) {
-                char *buffer = MEL::MemAlloc<char>(bufferSize);
-                Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
-                msg.packRootVar(len); 
-                msg.packRootPtr(ptr);
+        inline enable_if_pointer<P, MEL::Status> RecvAny(P &ptr, const int tag, const Comm &comm) {
+            Message<TransportRecv, HASH_MAP> msg(MEL::ANY_SOURCE, tag, comm);
+            msg.packRootPtr(ptr);
+            return msg.getTransporter().getStatus();
+        };
 
-                MEL::Deep::Bcast(buffer, msg.getOffset(), root, comm);
-                MEL::MemFree(buffer);
-            }
-            else {
-                int _bufferSize;
-                char *buffer = nullptr;
-                MEL::Deep::Bcast(buffer, _bufferSize, root, comm);
+        TEMPLATE_P_F(TransportRecv)
+        inline enable_if_pointer<P, MEL::Status> RecvAny(P &ptr, const int tag, const Comm &comm) {
+            typedef typename std::remove_pointer<P>::type T;
+            Message<TransportRecv, HASH_MAP> msg(MEL::ANY_SOURCE, tag, comm);
+            msg. template packRootPtr<T, F>(ptr);
+            return msg.getTransporter().getStatus();
+        };
 
-                Message<TransportBufferRead, HASH_MAP> msg(buffer, _bufferSize);
-                msg.packRootVar(len); 
-                msg.packRootPtr(ptr);
+        TEMPLATE_P
+        inline enable_if_pointer<P, MEL::Status> BufferedRecvAny(P &ptr, const int tag, const Comm &comm) {
+            int bufferSize;
+            char *buffer = nullptr;
+            MEL::Status status = MEL::Deep::RecvBuffer(buffer, bufferSize, MEL::ANY_SOURCE, tag, comm);
 
-                MEL::MemFree(buffer);
-            }
+            Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
+            msg.packRootPtr(ptr);
+
+            MEL::MemFree(buffer);
+            return status;
         };
 
-        TEMPLATE_P_F2(TransportBufferWrite, TransportBufferRead)
-        inline enable_if_pointer<P> BufferedBcast(P &ptr, int &len, const int root, const Comm &comm, const int bufferSize) {
+        TEMPLATE_P_F(TransportBufferRead)
+        inline enable_if_pointer<P, MEL::Status> BufferedRecvAny(P &ptr, const int tag, const Comm &comm) {
             typedef typename std::remove_pointer<P>::type T;
-            if (MEL::CommRank(comm) == root) {
-                char *buffer = MEL::MemAlloc<char>(bufferSize);
-                Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
-                msg.packRootVar(len); 
-                msg. template packRootPtr<T, F1>(ptr);
 
-                MEL::Deep::Bcast(buffer, msg.getOffset(), root, comm);
-                MEL::MemFree(buffer);
-            }
-            else {
-                int _bufferSize;
-                char *buffer = nullptr;
-                MEL::Deep::Bcast(buffer, _bufferSize, root, comm);
+            int bufferSize;
+            char *buffer = nullptr;
+            MEL::Status status = MEL::Deep::RecvBuffer(buffer, bufferSize, MEL::ANY_SOURCE, tag, comm);
 
-                Message<TransportBufferRead, HASH_MAP> msg(buffer, _bufferSize);
-                msg.packRootVar(len); 
-                msg. template packRootPtr<T, F2>(ptr);
+            Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
+            msg. template packRootPtr<T, F>(ptr);
 
-                MEL::MemFree(buffer);
-            }
+            MEL::MemFree(buffer);
+            return status;
         };
 
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // STL
+
+        TEMPLATE_STL
+        inline enable_if_stl<S, MEL::Status> RecvAny(S &obj, const int tag, const Comm &comm) {
+            Message<TransportRecv, HASH_MAP> msg(MEL::ANY_SOURCE, tag, comm);
+            msg.packRootSTL(obj);
+            return msg.getTransporter().getStatus();
+        };
+
+        TEMPLATE_STL_F(TransportRecv)
+        inline enable_if_stl<S, MEL::Status> RecvAny(S &obj, const int tag, const Comm &comm) {
+            typedef typename S::value_type T;
+            Message<TransportRecv, HASH_MAP> msg(MEL::ANY_SOURCE, tag, comm);
+            msg. template packRootSTL<T, F>(obj);
+            return msg.getTransporter().getStatus();
+        };
+
+        TEMPLATE_STL
+        inline enable_if_stl<S, MEL::Status> BufferedRecvAny(S &obj, const int tag, const Comm &comm) {
+            int bufferSize;
+            char *buffer = nullptr;
+            MEL::Status status = MEL::Deep::RecvBuffer(buffer, bufferSize, MEL::ANY_SOURCE, tag, comm);
+
+            Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
+            msg.packRootSTL(obj);
+
+            MEL::MemFree(buffer);
+            return status;
+        };
+
+        TEMPLATE_STL_F(TransportBufferRead)
+        inline enable_if_stl<S, MEL::Status> BufferedRecvAny(S &obj, const int tag, const Comm &comm) {
+            typedef typename S::value_type T;
+            int bufferSize;
+            char *buffer = nullptr;
+            MEL::Status status = MEL::Deep::RecvBuffer(buffer, bufferSize, MEL::ANY_SOURCE, tag, comm);
+
+            Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
+            msg. template packRootSTL<T, F>(obj);
+
+            MEL::MemFree(buffer);
+            return status;
+        };
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Object
+
+        TEMPLATE_T
+        inline enable_if_not_pointer_not_stl<T, MEL::Status> RecvAny(T &obj, const int tag, const Comm &comm) {
+            Message<TransportRecv, HASH_MAP> msg(MEL::ANY_SOURCE, tag, comm);
+            msg.packRootVar(obj);
+            return msg.getTransporter().getStatus();
+        };
+
+        TEMPLATE_T_F(TransportRecv)
+        inline enable_if_not_pointer_not_stl<T, MEL::Status> RecvAny(T &obj, const int tag, const Comm &comm) {
+            Message<TransportRecv, HASH_MAP> msg(MEL::ANY_SOURCE, tag, comm);
+            msg. template packRootVar<T, F>(obj);
+            return msg.getTransporter().getStatus();
+        };
+
+        TEMPLATE_T
+        inline enable_if_deep_not_pointer_not_stl<T, MEL::Status> BufferedRecvAny(T &obj, const int tag, const Comm &comm) {
+            int bufferSize;
+            char *buffer = nullptr;
+            MEL::Status status = MEL::Deep::RecvBuffer(buffer, bufferSize, MEL::ANY_SOURCE, tag, comm);
+
+            Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
+            msg.packRootVar(obj);
+
+            MEL::MemFree(buffer);
+            return status;
+        };
+
+        TEMPLATE_T_F(TransportBufferRead)
+        inline enable_if_not_pointer_not_stl<T, MEL::Status> BufferedRecvAny(T &obj, const int tag, const Comm &comm) {
+            int bufferSize;
+            char *buffer = nullptr;
+            MEL::Status status = MEL::Deep::RecvBuffer(buffer, bufferSize, MEL::ANY_SOURCE, tag, comm);
+
+            Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
+            msg. template packRootVar<T, F>(obj);
+
+            MEL::MemFree(buffer);
+            return status;
+        };
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Bcast
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        // The collective moving a deep broadcast. The Bcast and HierarchicalBcast entry points share one set of bodies, BcastVia and 
+        // BufferedBcastVia, and differ only in which of these they pass through
+        struct BcastCollective {
+            typedef TransportBcastRoot RootTransport;
+            typedef TransportBcast     Transport;
+
+            static inline void BcastBuffer(char *&buffer, int const &len, const int root, const Comm &comm) {
+                MEL::Deep::BcastBuffer(buffer, len, root, comm);
+            };
+            static inline void BcastBuffer(char *&buffer, int &len, const int root, const Comm &comm) {
+                MEL::Deep::BcastBuffer(buffer, len, root, comm);
+            };
+        };
+
+#ifdef MEL_3
+        struct HierarchicalBcastCollective {
+            typedef TransportHierarchicalBcastRoot RootTransport;
+            typedef TransportHierarchicalBcast     Transport;
+
+            static inline void BcastBuffer(char *&buffer, int const &len, const int root, const Comm &comm) {
+                MEL::Deep::HierarchicalBcastBuffer(buffer, len, root, comm);
+            };
+            static inline void BcastBuffer(char *&buffer, int &len, const int root, const Comm &comm) {
+                MEL::Deep::HierarchicalBcastBuffer(buffer, len, root, comm);
+            };
+        };
+#endif
+
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Pointer / Length
+
+        TEMPLATE_VIA_P
+        inline enable_if_pointer<P> BcastVia(P &ptr, int const &len, const int root, const Comm &comm) {
+            if (MEL::CommRank(comm) == root) {
+                Message<typename COLLECTIVE::RootTransport, HASH_MAP> msg(root, comm);
+                int _len = len;
+                msg.packRootVar(_len);
+                msg.packRootPtr(ptr, _len);
+            }
+            else {
+                Message<typename COLLECTIVE::Transport, HASH_MAP> msg(root, comm);
+                
+                int _len = len;
+                msg.packRootVar(_len);
+                if (len != _len) MEL::Exit(-1, "MEL::Deep::Bcast(ptr, len) const int len provided does not match incomming message size.");
+                msg.packRootPtr(ptr, _len);
+            }
+        };
+
+        TEMPLATE_VIA_P_F2(typename COLLECTIVE::RootTransport, typename COLLECTIVE::Transport)
+        inline enable_if_pointer<P> BcastVia(P &ptr, int const &len, const int root, const Comm &comm) {
+            typedef typename std::remove_pointer<P>::type T;
+            if (MEL::CommRank(comm) == root) {
+                Message<typename COLLECTIVE::RootTransport, HASH_MAP> msg(root, comm);
+                int _len = len;
+                msg.packRootVar(_len);
+                msg. template packRootPtr<T, F1>(ptr, _len);
+            }
+            else {
+                Message<typename COLLECTIVE::Transport, HASH_MAP> msg(root, comm);
+                
+                int _len = len;
+                msg.packRootVar(_len);
+                if (len != _len) MEL::Exit(-1, "MEL::Deep::Bcast(ptr, len) const int len provided does not match incomming message size.");
+                msg. template packRootPtr<T, F2>(ptr, _len);
+            }
+        };
+
+        TEMPLATE_VIA_P
+        inline enable_if_pointer<P> BcastVia(P &ptr, int &len, const int root, const Comm &comm) {
+            if (MEL::CommRank(comm) == root) {
+                Message<typename COLLECTIVE::RootTransport, HASH_MAP> msg(root, comm);
+                msg.packRootVar(len);
+                msg.packRootPtr(ptr, len);
+            }
+            else {
+                Message<typename COLLECTIVE::Transport, HASH_MAP> msg(root, comm);
+                
+                msg.packRootVar(len);
+                msg.packRootPtr(ptr, len);
+            }
+        };
+
+        TEMPLATE_VIA_P_F2(typename COLLECTIVE::RootTransport, typename COLLECTIVE::Transport)
+        inline enable_if_pointer<P> BcastVia(P &ptr, int &len, const int root, const Comm &comm) {
+            typedef typename std::remove_pointer<P>::type T;
+            if (MEL::CommRank(comm) == root) {
+                Message<typename COLLECTIVE::RootTransport, HASH_MAP> msg(root, comm);
+                msg.packRootVar(len);
+                msg. template packRootPtr<T, F1>(ptr, len);
+            }
+            else {
+                Message<typename COLLECTIVE::Transport, HASH_MAP> msg(root, comm);
+                msg.packRootVar(len);
+                msg. template packRootPtr<T, F2>(ptr, len);
+            }
+        };
+
+        TEMPLATE_VIA_P
+        inline enable_if_pointer<P> BufferedBcastVia(P &ptr, int &len, const int root, const Comm &comm, const int bufferSize) {
+            if (MEL::CommRank(comm) == root) {
+                char *buffer = MEL::MemAlloc<char>(bufferSize);
+                Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
+                msg.packRootVar(len); 
+                msg.packRootPtr(ptr, len);
+
+                COLLECTIVE::BcastBuffer(buffer, msg.getOffset(), root, comm);
+                MEL::MemFree(buffer);
+            }
+            else {
+                int _bufferSize;
+                char *buffer = nullptr;
+                COLLECTIVE::BcastBuffer(buffer, _bufferSize, root, comm);
+
+                Message<TransportBufferRead, HASH_MAP> msg(buffer, _bufferSize);
+                msg.packRootVar(len); 
+                msg.packRootPtr(ptr, len);
+
+                MEL::MemFree(buffer);
+            }
+        };
+
+        TEMPLATE_VIA_P_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_pointer<P> BufferedBcastVia(P &ptr, int &len, const int root, const Comm &comm, const int bufferSize) {
+            typedef typename std::remove_pointer<P>::type T;
+            if (MEL::CommRank(comm) == root) {
+                char *buffer = MEL::MemAlloc<char>(bufferSize);
+                Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
+                msg.packRootVar(len); 
+                msg. template packRootPtr<T, F1>(ptr, len);
+
+                COLLECTIVE::BcastBuffer(buffer, msg.getOffset(), root, comm);
+                MEL::MemFree(buffer);
+            }
+            else {
+                int _bufferSize;
+                char *buffer = nullptr;
+                COLLECTIVE::BcastBuffer(buffer, _bufferSize, root, comm);
+
+                Message<TransportBufferRead, HASH_MAP> msg(buffer, _bufferSize);
+                msg.packRootVar(len); 
+                msg. template packRootPtr<T, F2>(ptr, len);
+
+                MEL::MemFree(buffer);
+            }
+        };
+
+        TEMPLATE_VIA_P
+        inline enable_if_pointer<P> BufferedBcastVia(P &ptr, int &len, const int root, const Comm &comm) {
+            if (MEL::CommRank(comm) == root) {
+                BufferedBcastVia<COLLECTIVE, P, HASH_MAP>(ptr, len, root, comm, MEL::Deep::BufferSize<P, HASH_MAP>(ptr, len));
+            }
+            else {
+                BufferedBcastVia<COLLECTIVE, P, HASH_MAP>(ptr, len, root, comm, 0);
+            }
+        };
+
+        TEMPLATE_VIA_P_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_pointer<P> BufferedBcastVia(P &ptr, int &len, const int root, const Comm &comm) {
+            if (MEL::CommRank(comm) == root) {
+                BufferedBcastVia<COLLECTIVE, P, HASH_MAP, F1, F2>(ptr, len, root, comm, MEL::Deep::BufferSize<P, HASH_MAP, F1>(ptr, len));
+            }
+            else {
+                BufferedBcastVia<COLLECTIVE, P, HASH_MAP, F1, F2>(ptr, len, root, comm, 0);
+            }
+        };
+
+        TEMPLATE_VIA_P
+        inline enable_if_pointer<P> BufferedBcastVia(P &ptr, int const &len, const int root, const Comm &comm, const int bufferSize) {
+            if (MEL::CommRank(comm) == root) {
+                char *buffer = MEL::MemAlloc<char>(bufferSize);
+                Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
+                msg.packRootVar(len);
+                msg.packRootPtr(ptr, len);
+
+                COLLECTIVE::BcastBuffer(buffer, msg.getOffset(), root, comm);
+                MEL::MemFree(buffer);
+            }
+            else {
+                int _bufferSize;
+                char *buffer = nullptr;
+                COLLECTIVE::BcastBuffer(buffer, _bufferSize, root, comm);
+
+                Message<TransportBufferRead, HASH_MAP> msg(buffer, _bufferSize);
+                int _len = len;
+                msg.packRootVar(_len);
+                if (len != _len) MEL::Exit(-1, "MEL::Deep::BufferedBcast(ptr, len) const int len provided does not match incomming message size.");
+                msg.packRootPtr(ptr, len);
+
+                MEL::MemFree(buffer);
+            }
+        };
+
+        TEMPLATE_VIA_P_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_pointer<P> BufferedBcastVia(P &ptr, int const &len, const int root, const Comm &comm, const int bufferSize) {
+            typedef typename std::remove_pointer<P>::type T;
+            if (MEL::CommRank(comm) == root) {
+                char *buffer = MEL::MemAlloc<char>(bufferSize);
+                Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
+                msg.packRootVar(len);
+                msg. template packRootPtr<T, F1>(ptr, len);
+
+                COLLECTIVE::BcastBuffer(buffer, msg.getOffset(), root, comm);
+                MEL::MemFree(buffer);
+            }
+            else {
+                int _bufferSize;
+                char *buffer = nullptr;
+                COLLECTIVE::BcastBuffer(buffer, _bufferSize, root, comm);
+
+                Message<TransportBufferRead, HASH_MAP> msg(buffer, _bufferSize);
+                int _len = len;
+                msg.packRootVar(_len);
+                if (len != _len) MEL::Exit(-1, "MEL::Deep::BufferedBcast(ptr, len) const int len provided does not match incomming message size.");
+                msg. template packRootPtr<T, F2>(ptr, len);
+
+                MEL::MemFree(buffer);
+            }
+        };
+
+        TEMPLATE_VIA_P
+        inline enable_if_pointer<P> BufferedBcastVia(P &ptr, int const &len, const int root, const Comm &comm) {
+            if (MEL::CommRank(comm) == root) {
+                BufferedBcastVia<COLLECTIVE, P, HASH_MAP>(ptr, len, root, comm, MEL::Deep::BufferSize<P, HASH_MAP>(ptr, len));
+            }
+            else {
+                BufferedBcastVia<COLLECTIVE, P, HASH_MAP>(ptr, len, root, comm, 0);
+            }
+        };
+
+        TEMPLATE_VIA_P_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_pointer<P> BufferedBcastVia(P &ptr, int const &len, const int root, const Comm &comm) {
+            if (MEL::CommRank(comm) == root) {
+                BufferedBcastVia<COLLECTIVE, P, HASH_MAP, F1, F2>(ptr, len, root, comm, MEL::Deep::BufferSize<P, HASH_MAP, F1>(ptr, len));
+            }
+            else {
+                BufferedBcastVia<COLLECTIVE, P, HASH_MAP, F1, F2>(ptr, len, root, comm, 0);
+            }
+        };
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Pointer
+
+        TEMPLATE_VIA_P
+        inline enable_if_pointer<P> BcastVia(P &ptr, const int root, const Comm &comm) {
+            if (MEL::CommRank(comm) == root) {
+                Message<typename COLLECTIVE::RootTransport, HASH_MAP> msg(root, comm);
+                msg.packRootPtr(ptr);
+            }
+            else {
+                Message<typename COLLECTIVE::Transport, HASH_MAP> msg(root, comm);
+                msg.packRootPtr(ptr);
+            }
+        };
+
+        TEMPLATE_VIA_P_F2(typename COLLECTIVE::RootTransport, typename COLLECTIVE::Transport)
+        inline enable_if_pointer<P> BcastVia(P &ptr, const int root, const Comm &comm) {
+            typedef typename std::remove_pointer<P>::type T;
+            if (MEL::CommRank(comm) == root) {
+                Message<typename COLLECTIVE::RootTransport, HASH_MAP> msg(root, comm);
+                msg. template packRootPtr<T, F1>(ptr);
+            }
+            else {
+                Message<typename COLLECTIVE::Transport, HASH_MAP> msg(root, comm);
+                
+                msg. template packRootPtr<T, F2>(ptr);
+            }
+        };
+
+        TEMPLATE_VIA_P
+        inline enable_if_pointer<P> BufferedBcastVia(P &ptr, const int root, const Comm &comm, const int bufferSize) {
+            if (MEL::CommRank(comm) == root) {
+                char *buffer = MEL::MemAlloc<char>(bufferSize);
+                Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
+                msg.packRootPtr(ptr);
+
+                COLLECTIVE::BcastBuffer(buffer, msg.getOffset(), root, comm);
+                MEL::MemFree(buffer);
+            }
+            else {
+                int _bufferSize;
+                char *buffer = nullptr;
+                COLLECTIVE::BcastBuffer(buffer, _bufferSize, root, comm);
+
+                Message<TransportBufferRead, HASH_MAP> msg(buffer, _bufferSize);
+                msg.packRootPtr(ptr);
+
+                MEL::MemFree(buffer);
+            }
+        };
+
+        TEMPLATE_VIA_P_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_pointer<P> BufferedBcastVia(P &ptr, const int root, const Comm &comm, const int bufferSize) {
+            typedef typename std::remove_pointer<P>::type T;
+            if (MEL::CommRank(comm) == root) {
+                char *buffer = MEL::MemAlloc<char>(bufferSize);
+                Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
+                msg. template packRootPtr<T, F1>(ptr);
+
+                COLLECTIVE::BcastBuffer(buffer, msg.getOffset(), root, comm);
+                MEL::MemFree(buffer);
+            }
+            else {
+                int _bufferSize;
+                char *buffer = nullptr;
+                COLLECTIVE::BcastBuffer(buffer, _bufferSize, root, comm);
+
+                Message<TransportBufferRead, HASH_MAP> msg(buffer, _bufferSize);
+                msg. template packRootPtr<T, F2>(ptr);
+
+                MEL::MemFree(buffer);
+            }
+        };
+
+        TEMPLATE_VIA_P
+        inline enable_if_pointer<P> BufferedBcastVia(P &ptr, const int root, const Comm &comm) {
+            if (MEL::CommRank(comm) == root) {
+                BufferedBcastVia<COLLECTIVE, P, HASH_MAP>(ptr, root, comm, MEL::Deep::BufferSize<P, HASH_MAP>(ptr));
+            }
+            else {
+                BufferedBcastVia<COLLECTIVE, P, HASH_MAP>(ptr, root, comm, 0);
+            }
+        };
+
+        TEMPLATE_VIA_P_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_pointer<P> BufferedBcastVia(P &ptr, const int root, const Comm &comm) {
+            if (MEL::CommRank(comm) == root) {
+                BufferedBcastVia<COLLECTIVE, P, HASH_MAP, F1, F2>(ptr, root, comm, MEL::Deep::BufferSize<P, HASH_MAP, F1>(ptr));
+            }
+            else {
+                BufferedBcastVia<COLLECTIVE, P, HASH_MAP, F1, F2>(ptr, root, comm, 0);
+            }
+        };
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // STL
+
+        TEMPLATE_VIA_STL
+        inline enable_if_stl<S> BcastVia(S &obj, const int root, const Comm &comm) {
+            if (MEL::CommRank(comm) == root) {
+                Message<typename COLLECTIVE::RootTransport, HASH_MAP> msg(root, comm);
+                msg.packRootSTL(obj);
+            }
+            else {
+                Message<typename COLLECTIVE::Transport, HASH_MAP> msg(root, comm);
+                msg.packRootSTL(obj);
+            }
+        };
+
+        TEMPLATE_VIA_STL_F2(typename COLLECTIVE::RootTransport, typename COLLECTIVE::Transport)
+        inline enable_if_stl<S> BcastVia(S &obj, const int root, const Comm &comm) {
+            typedef typename S::value_type T;
+            if (MEL::CommRank(comm) == root) {
+                Message<typename COLLECTIVE::RootTransport, HASH_MAP> msg(root, comm);
+                msg. template packRootSTL<T, F1>(obj);
+            }
+            else {
+                Message<typename COLLECTIVE::Transport, HASH_MAP> msg(root, comm);
+                msg. template packRootSTL<T, F2>(obj);
+            }
+        };
+
+        TEMPLATE_VIA_STL
+        inline enable_if_stl<S> BufferedBcastVia(S &obj, const int root, const Comm &comm, const int bufferSize) {
+            if (MEL::CommRank(comm) == root) {
+                char *buffer = MEL::MemAlloc<char>(bufferSize);
+                Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
+                msg.packRootSTL(obj);
+
+                COLLECTIVE::BcastBuffer(buffer, msg.getOffset(), root, comm);
+                MEL::MemFree(buffer);
+            }
+            else {
+                int _bufferSize;
+                char *buffer = nullptr;
+                COLLECTIVE::BcastBuffer(buffer, _bufferSize, root, comm);
+
+                Message<TransportBufferRead, HASH_MAP> msg(buffer, _bufferSize);
+                msg.packRootSTL(obj);
+
+                MEL::MemFree(buffer);
+            }
+        };
+
+        TEMPLATE_VIA_STL_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_stl<S> BufferedBcastVia(S &obj, const int root, const Comm &comm, const int bufferSize) {
+            typedef typename S::value_type T;
+            if (MEL::CommRank(comm) == root) {
+                char *buffer = MEL::MemAlloc<char>(bufferSize);
+                Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
+                msg. template packRootSTL<T, F1>(obj);
+
+                COLLECTIVE::BcastBuffer(buffer, msg.getOffset(), root, comm);
+                MEL::MemFree(buffer);
+            }
+            else {
+                int _bufferSize;
+                char *buffer = nullptr;
+                COLLECTIVE::BcastBuffer(buffer, _bufferSize, root, comm);
+
+                Message<TransportBufferRead, HASH_MAP> msg(buffer, _bufferSize);
+                msg. template packRootSTL<T, F2>(obj);
+
+                MEL::MemFree(buffer);
+            }
+        };
+
+        TEMPLATE_VIA_STL
+        inline enable_if_stl<S> BufferedBcastVia(S &obj, const int root, const Comm &comm) {
+            if (MEL::CommRank(comm) == root) {
+                BufferedBcastVia<COLLECTIVE, S, HASH_MAP>(obj, root, comm, MEL::Deep::BufferSize<S, HASH_MAP>(obj));
+            }
+            else {
+                BufferedBcastVia<COLLECTIVE, S, HASH_MAP>(obj, root, comm, 0);
+            }
+        };
+
+        TEMPLATE_VIA_STL_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_stl<S> BufferedBcastVia(S &obj, const int root, const Comm &comm) {
+            if (MEL::CommRank(comm) == root) {
+                BufferedBcastVia<COLLECTIVE, S, HASH_MAP, F1, F2>(obj, root, comm, MEL::Deep::BufferSize<S, HASH_MAP, F1>(obj));
+            }
+            else {
+                BufferedBcastVia<COLLECTIVE, S, HASH_MAP, F1, F2>(obj, root, comm, 0);
+            }
+        };
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Object
+
+        TEMPLATE_VIA_T
+        inline enable_if_not_pointer_not_stl<T> BcastVia(T &obj, const int root, const Comm &comm) {
+            if (MEL::CommRank(comm) == root) {
+                Message<typename COLLECTIVE::RootTransport, HASH_MAP> msg(root, comm);
+                msg.packRootVar(obj);
+            }
+            else {
+                Message<typename COLLECTIVE::Transport, HASH_MAP> msg(root, comm);
+                msg.packRootVar(obj);
+            }
+        };
+
+        TEMPLATE_VIA_T_F2(typename COLLECTIVE::RootTransport, typename COLLECTIVE::Transport)
+        inline enable_if_not_pointer_not_stl<T> BcastVia(T &obj, const int root, const Comm &comm) {
+            if (MEL::CommRank(comm) == root) {
+                Message<typename COLLECTIVE::RootTransport, HASH_MAP> msg(root, comm);
+                msg. template packRootVar<T, F1>(obj);
+            }
+            else {
+                Message<typename COLLECTIVE::Transport, HASH_MAP> msg(root, comm);
+                msg. template packRootVar<T, F2>(obj);
+            }
+        };
+
+        TEMPLATE_VIA_T
+        inline enable_if_deep_not_pointer_not_stl<T> BufferedBcastVia(T &obj, const int root, const Comm &comm, const int bufferSize) {
+            if (MEL::CommRank(comm) == root) {
+                char *buffer = MEL::MemAlloc<char>(bufferSize);
+                Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
+                msg.packRootVar(obj);
+
+                COLLECTIVE::BcastBuffer(buffer, msg.getOffset(), root, comm);
+                MEL::MemFree(buffer);
+            }
+            else {
+                int _bufferSize;
+                char *buffer = nullptr;
+                COLLECTIVE::BcastBuffer(buffer, _bufferSize, root, comm);
+
+                Message<TransportBufferRead, HASH_MAP> msg(buffer, _bufferSize);
+                msg.packRootVar(obj);
+
+                MEL::MemFree(buffer);
+            }
+        };
+
+        TEMPLATE_VIA_T_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_not_pointer_not_stl<T> BufferedBcastVia(T &obj, const int root, const Comm &comm, const int bufferSize) {
+            if (MEL::CommRank(comm) == root) {
+                char *buffer = MEL::MemAlloc<char>(bufferSize);
+                Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
+                msg. template packRootVar<T, F1>(obj);
+
+                COLLECTIVE::BcastBuffer(buffer, msg.getOffset(), root, comm);
+                MEL::MemFree(buffer);
+            }
+            else {
+                int _bufferSize;
+                char *buffer = nullptr;
+                COLLECTIVE::BcastBuffer(buffer, _bufferSize, root, comm);
+
+                Message<TransportBufferRead, HASH_MAP> msg(buffer, _bufferSize);
+                msg. template packRootVar<T, F2>(obj);
+
+                MEL::MemFree(buffer);
+            }
+        };
+
+        TEMPLATE_VIA_T
+        inline enable_if_deep_not_pointer_not_stl<T> BufferedBcastVia(T &obj, const int root, const Comm &comm) {
+            if (MEL::CommRank(comm) == root) {
+                BufferedBcastVia<COLLECTIVE, T, HASH_MAP>(obj, root, comm, MEL::Deep::BufferSize<T, HASH_MAP>(obj));
+            }
+            else {
+                BufferedBcastVia<COLLECTIVE, T, HASH_MAP>(obj, root, comm, 0);
+            }
+        };
+
+        TEMPLATE_VIA_T_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_not_pointer_not_stl<T> BufferedBcastVia(T &obj, const int root, const Comm &comm) {
+            if (MEL::CommRank(comm) == root) {
+                BufferedBcastVia<COLLECTIVE, T, HASH_MAP, F1, F2>(obj, root, comm, MEL::Deep::BufferSize<T, HASH_MAP, F1>(obj));
+            }
+            else {
+                BufferedBcastVia<COLLECTIVE, T, HASH_MAP, F1, F2>(obj, root, comm, 0);
+            }
+        };
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Bcast Entry Points
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> Bcast(P &ptr, int const &len, const int root, const Comm &comm) {
+            BcastVia<BcastCollective, P, HASH_MAP>(ptr, len, root, comm);
+        };
+
+        TEMPLATE_P_F2(TransportBcastRoot, TransportBcast)
+        inline enable_if_pointer<P> Bcast(P &ptr, int const &len, const int root, const Comm &comm) {
+            BcastVia<BcastCollective, P, HASH_MAP, F1, F2>(ptr, len, root, comm);
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> Bcast(P &ptr, int &len, const int root, const Comm &comm) {
+            BcastVia<BcastCollective, P, HASH_MAP>(ptr, len, root, comm);
+        };
+
+        TEMPLATE_P_F2(TransportBcastRoot, TransportBcast)
+        inline enable_if_pointer<P> Bcast(P &ptr, int &len, const int root, const Comm &comm) {
+            BcastVia<BcastCollective, P, HASH_MAP, F1, F2>(ptr, len, root, comm);
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> BufferedBcast(P &ptr, int &len, const int root, const Comm &comm, const int bufferSize) {
+            BufferedBcastVia<BcastCollective, P, HASH_MAP>(ptr, len, root, comm, bufferSize);
+        };
+
+        TEMPLATE_P_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_pointer<P> BufferedBcast(P &ptr, int &len, const int root, const Comm &comm, const int bufferSize) {
+            BufferedBcastVia<BcastCollective, P, HASH_MAP, F1, F2>(ptr, len, root, comm, bufferSize);
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> BufferedBcast(P &ptr, int &len, const int root, const Comm &comm) {
+            BufferedBcastVia<BcastCollective, P, HASH_MAP>(ptr, len, root, comm);
+        };
+
+        TEMPLATE_P_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_pointer<P> BufferedBcast(P &ptr, int &len, const int root, const Comm &comm) {
+            BufferedBcastVia<BcastCollective, P, HASH_MAP, F1, F2>(ptr, len, root, comm);
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> BufferedBcast(P &ptr, int const &len, const int root, const Comm &comm, const int bufferSize) {
+            BufferedBcastVia<BcastCollective, P, HASH_MAP>(ptr, len, root, comm, bufferSize);
+        };
+
+        TEMPLATE_P_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_pointer<P> BufferedBcast(P &ptr, int const &len, const int root, const Comm &comm, const int bufferSize) {
+            BufferedBcastVia<BcastCollective, P, HASH_MAP, F1, F2>(ptr, len, root, comm, bufferSize);
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> BufferedBcast(P &ptr, int const &len, const int root, const Comm &comm) {
+            BufferedBcastVia<BcastCollective, P, HASH_MAP>(ptr, len, root, comm);
+        };
+
+        TEMPLATE_P_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_pointer<P> BufferedBcast(P &ptr, int const &len, const int root, const Comm &comm) {
+            BufferedBcastVia<BcastCollective, P, HASH_MAP, F1, F2>(ptr, len, root, comm);
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> Bcast(P &ptr, const int root, const Comm &comm) {
+            BcastVia<BcastCollective, P, HASH_MAP>(ptr, root, comm);
+        };
+
+        TEMPLATE_P_F2(TransportBcastRoot, TransportBcast)
+        inline enable_if_pointer<P> Bcast(P &ptr, const int root, const Comm &comm) {
+            BcastVia<BcastCollective, P, HASH_MAP, F1, F2>(ptr, root, comm);
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> BufferedBcast(P &ptr, const int root, const Comm &comm, const int bufferSize) {
+            BufferedBcastVia<BcastCollective, P, HASH_MAP>(ptr, root, comm, bufferSize);
+        };
+
+        TEMPLATE_P_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_pointer<P> BufferedBcast(P &ptr, const int root, const Comm &comm, const int bufferSize) {
+            BufferedBcastVia<BcastCollective, P, HASH_MAP, F1, F2>(ptr, root, comm, bufferSize);
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> BufferedBcast(P &ptr, const int root, const Comm &comm) {
+            BufferedBcastVia<BcastCollective, P, HASH_MAP>(ptr, root, comm);
+        };
+
+        TEMPLATE_P_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_pointer<P> BufferedBcast(P &ptr, const int root, const Comm &comm) {
+            BufferedBcastVia<BcastCollective, P, HASH_MAP, F1, F2>(ptr, root, comm);
+        };
+
+        TEMPLATE_STL
+        inline enable_if_stl<S> Bcast(S &obj, const int root, const Comm &comm) {
+            BcastVia<BcastCollective, S, HASH_MAP>(obj, root, comm);
+        };
+
+        TEMPLATE_STL_F2(TransportBcastRoot, TransportBcast)
+        inline enable_if_stl<S> Bcast(S &obj, const int root, const Comm &comm) {
+            BcastVia<BcastCollective, S, HASH_MAP, F1, F2>(obj, root, comm);
+        };
+
+        TEMPLATE_STL
+        inline enable_if_stl<S> BufferedBcast(S &obj, const int root, const Comm &comm, const int bufferSize) {
+            BufferedBcastVia<BcastCollective, S, HASH_MAP>(obj, root, comm, bufferSize);
+        };
+
+        TEMPLATE_STL_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_stl<S> BufferedBcast(S &obj, const int root, const Comm &comm, const int bufferSize) {
+            BufferedBcastVia<BcastCollective, S, HASH_MAP, F1, F2>(obj, root, comm, bufferSize);
+        };
+
+        TEMPLATE_STL
+        inline enable_if_stl<S> BufferedBcast(S &obj, const int root, const Comm &comm) {
+            BufferedBcastVia<BcastCollective, S, HASH_MAP>(obj, root, comm);
+        };
+
+        TEMPLATE_STL_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_stl<S> BufferedBcast(S &obj, const int root, const Comm &comm) {
+            BufferedBcastVia<BcastCollective, S, HASH_MAP, F1, F2>(obj, root, comm);
+        };
+
+        TEMPLATE_T
+        inline enable_if_not_pointer_not_stl<T> Bcast(T &obj, const int root, const Comm &comm) {
+            BcastVia<BcastCollective, T, HASH_MAP>(obj, root, comm);
+        };
+
+        TEMPLATE_T_F2(TransportBcastRoot, TransportBcast)
+        inline enable_if_not_pointer_not_stl<T> Bcast(T &obj, const int root, const Comm &comm) {
+            BcastVia<BcastCollective, T, HASH_MAP, F1, F2>(obj, root, comm);
+        };
+
+        TEMPLATE_T
+        inline enable_if_deep_not_pointer_not_stl<T> BufferedBcast(T &obj, const int root, const Comm &comm, const int bufferSize) {
+            BufferedBcastVia<BcastCollective, T, HASH_MAP>(obj, root, comm, bufferSize);
+        };
+
+        TEMPLATE_T_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_not_pointer_not_stl<T> BufferedBcast(T &obj, const int root, const Comm &comm, const int bufferSize) {
+            BufferedBcastVia<BcastCollective, T, HASH_MAP, F1, F2>(obj, root, comm, bufferSize);
+        };
+
+        TEMPLATE_T
+        inline enable_if_deep_not_pointer_not_stl<T> BufferedBcast(T &obj, const int root, const Comm &comm) {
+            BufferedBcastVia<BcastCollective, T, HASH_MAP>(obj, root, comm);
+        };
+
+        TEMPLATE_T_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_not_pointer_not_stl<T> BufferedBcast(T &obj, const int root, const Comm &comm) {
+            BufferedBcastVia<BcastCollective, T, HASH_MAP, F1, F2>(obj, root, comm);
+        };
+
+#ifdef MEL_3
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Hierarchical Bcast
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> HierarchicalBcast(P &ptr, int const &len, const int root, const Comm &comm) {
+            BcastVia<HierarchicalBcastCollective, P, HASH_MAP>(ptr, len, root, comm);
+        };
+
+        TEMPLATE_P_F2(TransportHierarchicalBcastRoot, TransportHierarchicalBcast)
+        inline enable_if_pointer<P> HierarchicalBcast(P &ptr, int const &len, const int root, const Comm &comm) {
+            BcastVia<HierarchicalBcastCollective, P, HASH_MAP, F1, F2>(ptr, len, root, comm);
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> HierarchicalBcast(P &ptr, int &len, const int root, const Comm &comm) {
+            BcastVia<HierarchicalBcastCollective, P, HASH_MAP>(ptr, len, root, comm);
+        };
+
+        TEMPLATE_P_F2(TransportHierarchicalBcastRoot, TransportHierarchicalBcast)
+        inline enable_if_pointer<P> HierarchicalBcast(P &ptr, int &len, const int root, const Comm &comm) {
+            BcastVia<HierarchicalBcastCollective, P, HASH_MAP, F1, F2>(ptr, len, root, comm);
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> BufferedHierarchicalBcast(P &ptr, int &len, const int root, const Comm &comm, const int bufferSize) {
+            BufferedBcastVia<HierarchicalBcastCollective, P, HASH_MAP>(ptr, len, root, comm, bufferSize);
+        };
+
+        TEMPLATE_P_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_pointer<P> BufferedHierarchicalBcast(P &ptr, int &len, const int root, const Comm &comm, const int bufferSize) {
+            BufferedBcastVia<HierarchicalBcastCollective, P, HASH_MAP, F1, F2>(ptr, len, root, comm, bufferSize);
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> BufferedHierarchicalBcast(P &ptr, int &len, const int root, const Comm &comm) {
+            BufferedBcastVia<HierarchicalBcastCollective, P, HASH_MAP>(ptr, len, root, comm);
+        };
+
+        TEMPLATE_P_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_pointer<P> BufferedHierarchicalBcast(P &ptr, int &len, const int root, const Comm &comm) {
+            BufferedBcastVia<HierarchicalBcastCollective, P, HASH_MAP, F1, F2>(ptr, len, root, comm);
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> BufferedHierarchicalBcast(P &ptr, int const &len, const int root, const Comm &comm, const int bufferSize) {
+            BufferedBcastVia<HierarchicalBcastCollective, P, HASH_MAP>(ptr, len, root, comm, bufferSize);
+        };
+
+        TEMPLATE_P_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_pointer<P> BufferedHierarchicalBcast(P &ptr, int const &len, const int root, const Comm &comm, const int bufferSize) {
+            BufferedBcastVia<HierarchicalBcastCollective, P, HASH_MAP, F1, F2>(ptr, len, root, comm, bufferSize);
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> BufferedHierarchicalBcast(P &ptr, int const &len, const int root, const Comm &comm) {
+            BufferedBcastVia<HierarchicalBcastCollective, P, HASH_MAP>(ptr, len, root, comm);
+        };
+
+        TEMPLATE_P_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_pointer<P> BufferedHierarchicalBcast(P &ptr, int const &len, const int root, const Comm &comm) {
+            BufferedBcastVia<HierarchicalBcastCollective, P, HASH_MAP, F1, F2>(ptr, len, root, comm);
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> HierarchicalBcast(P &ptr, const int root, const Comm &comm) {
+            BcastVia<HierarchicalBcastCollective, P, HASH_MAP>(ptr, root, comm);
+        };
+
+        TEMPLATE_P_F2(TransportHierarchicalBcastRoot, TransportHierarchicalBcast)
+        inline enable_if_pointer<P> HierarchicalBcast(P &ptr, const int root, const Comm &comm) {
+            BcastVia<HierarchicalBcastCollective, P, HASH_MAP, F1, F2>(ptr, root, comm);
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> BufferedHierarchicalBcast(P &ptr, const int root, const Comm &comm, const int bufferSize) {
+            BufferedBcastVia<HierarchicalBcastCollective, P, HASH_MAP>(ptr, root, comm, bufferSize);
+        };
+
+        TEMPLATE_P_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_pointer<P> BufferedHierarchicalBcast(P &ptr, const int root, const Comm &comm, const int bufferSize) {
+            BufferedBcastVia<HierarchicalBcastCollective, P, HASH_MAP, F1, F2>(ptr, root, comm, bufferSize);
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> BufferedHierarchicalBcast(P &ptr, const int root, const Comm &comm) {
+            BufferedBcastVia<HierarchicalBcastCollective, P, HASH_MAP>(ptr, root, comm);
+        };
+
+        TEMPLATE_P_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_pointer<P> BufferedHierarchicalBcast(P &ptr, const int root, const Comm &comm) {
+            BufferedBcastVia<HierarchicalBcastCollective, P, HASH_MAP, F1, F2>(ptr, root, comm);
+        };
+
+        TEMPLATE_STL
+        inline enable_if_stl<S> HierarchicalBcast(S &obj, const int root, const Comm &comm) {
+            BcastVia<HierarchicalBcastCollective, S, HASH_MAP>(obj, root, comm);
+        };
+
+        TEMPLATE_STL_F2(TransportHierarchicalBcastRoot, TransportHierarchicalBcast)
+        inline enable_if_stl<S> HierarchicalBcast(S &obj, const int root, const Comm &comm) {
+            BcastVia<HierarchicalBcastCollective, S, HASH_MAP, F1, F2>(obj, root, comm);
+        };
+
+        TEMPLATE_STL
+        inline enable_if_stl<S> BufferedHierarchicalBcast(S &obj, const int root, const Comm &comm, const int bufferSize) {
+            BufferedBcastVia<HierarchicalBcastCollective, S, HASH_MAP>(obj, root, comm, bufferSize);
+        };
+
+        TEMPLATE_STL_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_stl<S> BufferedHierarchicalBcast(S &obj, const int root, const Comm &comm, const int bufferSize) {
+            BufferedBcastVia<HierarchicalBcastCollective, S, HASH_MAP, F1, F2>(obj, root, comm, bufferSize);
+        };
+
+        TEMPLATE_STL
+        inline enable_if_stl<S> BufferedHierarchicalBcast(S &obj, const int root, const Comm &comm) {
+            BufferedBcastVia<HierarchicalBcastCollective, S, HASH_MAP>(obj, root, comm);
+        };
+
+        TEMPLATE_STL_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_stl<S> BufferedHierarchicalBcast(S &obj, const int root, const Comm &comm) {
+            BufferedBcastVia<HierarchicalBcastCollective, S, HASH_MAP, F1, F2>(obj, root, comm);
+        };
+
+        TEMPLATE_T
+        inline enable_if_not_pointer_not_stl<T> HierarchicalBcast(T &obj, const int root, const Comm &comm) {
+            BcastVia<HierarchicalBcastCollective, T, HASH_MAP>(obj, root, comm);
+        };
+
+        TEMPLATE_T_F2(TransportHierarchicalBcastRoot, TransportHierarchicalBcast)
+        inline enable_if_not_pointer_not_stl<T> HierarchicalBcast(T &obj, const int root, const Comm &comm) {
+            BcastVia<HierarchicalBcastCollective, T, HASH_MAP, F1, F2>(obj, root, comm);
+        };
+
+        TEMPLATE_T
+        inline enable_if_deep_not_pointer_not_stl<T> BufferedHierarchicalBcast(T &obj, const int root, const Comm &comm, const int bufferSize) {
+            BufferedBcastVia<HierarchicalBcastCollective, T, HASH_MAP>(obj, root, comm, bufferSize);
+        };
+
+        TEMPLATE_T_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_not_pointer_not_stl<T> BufferedHierarchicalBcast(T &obj, const int root, const Comm &comm, const int bufferSize) {
+            BufferedBcastVia<HierarchicalBcastCollective, T, HASH_MAP, F1, F2>(obj, root, comm, bufferSize);
+        };
+
+        TEMPLATE_T
+        inline enable_if_deep_not_pointer_not_stl<T> BufferedHierarchicalBcast(T &obj, const int root, const Comm &comm) {
+            BufferedBcastVia<HierarchicalBcastCollective, T, HASH_MAP>(obj, root, comm);
+        };
+
+        TEMPLATE_T_F2(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_not_pointer_not_stl<T> BufferedHierarchicalBcast(T &obj, const int root, const Comm &comm) {
+            BufferedBcastVia<HierarchicalBcastCollective, T, HASH_MAP, F1, F2>(obj, root, comm);
+        };
+#endif
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Buffer Exchange
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        inline void SendBuffer(char *buffer, const int len, const int dst, const int tag, const Comm &comm) {
+            if (!GetCompressionConfig().enabled) {
+                MEL::Deep::Send(buffer, len, dst, tag, comm);
+                return;
+            }
+            int frameLen;
+            char *frame = CompressBuffer(buffer, len, frameLen);
+            MEL::Deep::Send(frame, frameLen, dst, tag, comm);
+            MEL::MemFree(frame);
+        };
+
+        // Returns the status of the matched sender, so src / tag may be MEL::ANY_SOURCE / MEL::ANY_TAG
+        inline MEL::Status RecvBuffer(char *&buffer, int &len, const int src, const int tag, const Comm &comm) {
+            if (!GetCompressionConfig().enabled) {
+                Message<TransportRecv> msg(src, tag, comm);
+                msg.packRootVar(len);
+                msg.packRootPtr(buffer, len);
+                return msg.getTransporter().getStatus();
+            }
+            int frameLen;
+            char *frame = nullptr;
+            Message<TransportRecv> msg(src, tag, comm);
+            msg.packRootVar(frameLen);
+            msg.packRootPtr(frame, frameLen);
+            buffer = DecompressBuffer(frame, frameLen, len);
+            MEL::MemFree(frame);
+            return msg.getTransporter().getStatus();
+        };
+
+        inline void BcastBuffer(char *&buffer, int const &len, const int root, const Comm &comm) {
+            if (!GetCompressionConfig().enabled) {
+                MEL::Deep::Bcast(buffer, len, root, comm);
+                return;
+            }
+            int frameLen;
+            char *frame = CompressBuffer(buffer, len, frameLen);
+            MEL::Deep::Bcast(frame, frameLen, root, comm);
+            MEL::MemFree(frame);
+        };
+
+        inline void BcastBuffer(char *&buffer, int &len, const int root, const Comm &comm) {
+            if (MEL::CommRank(comm) == root) {
+                BcastBuffer(buffer, (int const &) len, root, comm);
+                return;
+            }
+            if (!GetCompressionConfig().enabled) {
+                MEL::Deep::Bcast(buffer, len, root, comm);
+                return;
+            }
+            int frameLen;
+            char *frame = nullptr;
+            MEL::Deep::Bcast(frame, frameLen, root, comm);
+            buffer = DecompressBuffer(frame, frameLen, len);
+            MEL::MemFree(frame);
+        };
+
+#ifdef MEL_3
+        inline void HierarchicalBcastBuffer(char *&buffer, int const &len, const int root, const Comm &comm) {
+            if (!GetCompressionConfig().enabled) {
+                MEL::Deep::HierarchicalBcast(buffer, len, root, comm);
+                return;
+            }
+            int frameLen;
+            char *frame = CompressBuffer(buffer, len, frameLen);
+            MEL::Deep::HierarchicalBcast(frame, frameLen, root, comm);
+            MEL::MemFree(frame);
+        };
+
+        inline void HierarchicalBcastBuffer(char *&buffer, int &len, const int root, const Comm &comm) {
+            if (MEL::CommRank(comm) == root) {
+                HierarchicalBcastBuffer(buffer, (int const &) len, root, comm);
+                return;
+            }
+            if (!GetCompressionConfig().enabled) {
+                MEL::Deep::HierarchicalBcast(buffer, len, root, comm);
+                return;
+            }
+            int frameLen;
+            char *frame = nullptr;
+            MEL::Deep::HierarchicalBcast(frame, frameLen, root, comm);
+            buffer = DecompressBuffer(frame, frameLen, len);
+            MEL::MemFree(frame);
+        };
+#endif
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Delta
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        // State for one incremental channel, reused every step. The sending side keeps a hash of each chunk of the last packed image, 
+        // receiving sides keep the last image itself and patch it with the chunks that changed. Use one DeltaState per object and peer
+        // (or per object for DeltaBcast) and keep chunkSize the same on every side
+        struct DeltaState {
+            int chunkSize;
+            std::vector<unsigned long long> hashes;
+            std::vector<char> image;
+            long long rawBytes, wireBytes;
+
+            explicit DeltaState(const int _chunkSize = 4096) : chunkSize(_chunkSize), rawBytes(0), wireBytes(0) {};
+
+            inline void reset() {
+                hashes.clear();
+                image.clear();
+            };
+        };
+
+        // A word at a time multiply / xor-shift hash, strong enough to detect changed chunks
+        inline unsigned long long DeltaHash(const char *ptr, const int len) {
+            unsigned long long h = 0x9E3779B97F4A7C15ull ^ (unsigned long long) len, w;
+            int i = 0;
+            for (; (i + 8) <= len; i += 8) {
+                memcpy(&w, ptr + i, 8);
+                h = (h ^ (w * 0xFF51AFD7ED558CCDull)) * 0xC4CEB9FE1A85EC53ull;
+                h ^= h >> 29;
+            }
+            for (; i < len; ++i) h = (h ^ (unsigned char) ptr[i]) * 0x100000001B3ull;
+            return h ^ (h >> 32);
+        };
+
+        // A delta frame is a three int header { image length, chunk size, changed chunks } followed by a bitmap with one bit 
+        // per chunk and then the changed chunks in order.
+        //
+        // TransportDeltaWrite builds the frame while the object is packed. Each chunk is hashed as soon as it is complete and 
+        // copied out only if it changed, so the sender never holds the whole packed image. Call finish() once packing is done
+        class TransportDeltaWrite {
+        private:
+            /// Members
+            DeltaState                 &state;
+            const int                  chunkSize, oldChunks;
+            int                        fill, numChunks, numChanged, len;
+            std::vector<char>          chunk, data;
+            std::vector<unsigned char> bitmap;
+
+            inline void endChunk(const char *ptr, const int size) {
+                const unsigned long long h = DeltaHash(ptr, size);
+                if (numChunks >= (int) state.hashes.size()) state.hashes.push_back(h ^ 1);
+                if (numChunks >= oldChunks || state.hashes[numChunks] != h) {
+                    state.hashes[numChunks] = h;
+                    if ((numChunks / 8) >= (int) bitmap.size()) bitmap.push_back(0);
+                    bitmap[numChunks / 8] |= (unsigned char) (1 << (numChunks % 8));
+                    data.insert(data.end(), ptr, ptr + size);
+                    ++numChanged;
+                }
+                else if ((numChunks / 8) >= (int) bitmap.size()) {
+                    bitmap.push_back(0);
+                }
+                ++numChunks;
+            };
+
+        public:
+            static constexpr bool SOURCE = true;
+
+            explicit TransportDeltaWrite(DeltaState &_state) : state(_state), chunkSize(_state.chunkSize), oldChunks((int) _state.hashes.size()), 
+                                                               fill(0), numChunks(0), numChanged(0), len(0), chunk(_state.chunkSize) {};
+
+            template<typename T>
+            inline void transport(T *&ptr, const int num) {
+                const char *src = (const char*) ptr;
+                int bytes = num * sizeof(T);
+                len += bytes;
+                while (bytes > 0) {
+                    /// Whole chunks are hashed straight from the object
+                    if (fill == 0 && bytes >= chunkSize) {
+                        endChunk(src, chunkSize);
+                        src += chunkSize;
+                        bytes -= chunkSize;
+                        continue;
+                    }
+                    const int take = std::min(chunkSize - fill, bytes);
+                    memcpy(&chunk[fill], src, take);
+                    fill  += take;
+                    src   += take;
+                    bytes -= take;
+                    if (fill == chunkSize) {
+                        endChunk(&chunk[0], chunkSize);
+                        fill = 0;
+                    }
+                }
+            };
+
+            // Returns a new frame allocated with MEL::MemAlloc
+            inline char* finish(int &frameLen) {
+                if (fill > 0) endChunk(&chunk[0], fill);
+                fill = 0;
+                state.hashes.resize(numChunks);
+
+                int header[3] = { len, chunkSize, numChanged };
+                const int bitmapLen = (int) bitmap.size(), dataLen = (int) data.size();
+                frameLen = (int) sizeof(header) + bitmapLen + dataLen;
+                char *frame = MEL::MemAlloc<char>(frameLen);
+                memcpy(frame, header, sizeof(header));
+                if (bitmapLen > 0) memcpy(frame + sizeof(header), &bitmap[0], bitmapLen);
+                if (dataLen > 0)   memcpy(frame + sizeof(header) + bitmapLen, &data[0], dataLen);
+
+                state.rawBytes  += len;
+                state.wireBytes += frameLen;
+                return frame;
+            };
+        };
+
+        // Patches state.image in place. Returns true if any chunk changed
+        inline bool DeltaDecode(const char *frame, const int frameLen, DeltaState &state) {
+            int header[3];
+            if (frameLen < (int) sizeof(header)) MEL::Abort(-1, "MEL::Deep::DeltaDecode : Frame shorter than header...");
+            memcpy(header, frame, sizeof(header));
+
+            const int len = header[0], chunkSize = header[1], numChunks = (len + chunkSize - 1) / chunkSize, bitmapLen = (numChunks + 7) / 8;
+            if (chunkSize != state.chunkSize) MEL::Abort(-1, "MEL::Deep::DeltaDecode : Chunk size does not match the sender...");
+
+            const unsigned char *bitmap = (const unsigned char*) frame + sizeof(header);
+            const char *in = frame + sizeof(header) + bitmapLen, *end = frame + frameLen;
+
+            const int oldLen = (int) state.image.size();
+            state.image.resize(len);
+            for (int i = 0; i < numChunks; ++i) {
+                const int begin = i * chunkSize, size = std::min(chunkSize, len - begin);
+                if (bitmap[i / 8] & (1 << (i % 8))) {
+                    if ((end - in) < size) MEL::Abort(-1, "MEL::Deep::DeltaDecode : Frame shorter than changed chunks...");
+                    memcpy(&state.image[begin], in, size);
+                    in += size;
+                }
+                else if ((begin + size) > oldLen) {
+                    MEL::Abort(-1, "MEL::Deep::DeltaDecode : Unchanged chunk missing from previous image...");
+                }
+            }
+
+            state.rawBytes  += len;
+            state.wireBytes += frameLen;
+            return header[2] > 0 || len != oldLen;
+        };
+
+        // Incremental Send / Recv / Bcast of an object. Only chunks of the packed image that changed since the last transfer 
+        // on the same DeltaState are sent. The receiver patches its copy of the image and then updates obj in place, reusing 
+        // the allocations obj already holds (see TraversalConfig::inPlace), and leaves obj untouched when nothing changed
+
+        TEMPLATE_T
+        inline enable_if_deep_not_pointer_not_stl<T> DeltaSend(T &obj, const int dst, const int tag, const Comm &comm, DeltaState &state) {
+            Message<TransportDeltaWrite, HASH_MAP> msg(state);
+            msg.packRootVar(obj);
+
+            int frameLen;
+            char *frame = msg.getTransporter().finish(frameLen);
+            MEL::Deep::SendBuffer(frame, frameLen, dst, tag, comm);
+            MEL::MemFree(frame);
+        };
+
+        TEMPLATE_T_F(TransportDeltaWrite)
+        inline enable_if_not_pointer_not_stl<T> DeltaSend(T &obj, const int dst, const int tag, const Comm &comm, DeltaState &state) {
+            Message<TransportDeltaWrite, HASH_MAP> msg(state);
+            msg. template packRootVar<T, F>(obj);
+
+            int frameLen;
+            char *frame = msg.getTransporter().finish(frameLen);
+            MEL::Deep::SendBuffer(frame, frameLen, dst, tag, comm);
+            MEL::MemFree(frame);
+        };
+
+        TEMPLATE_T
+        inline enable_if_deep_not_pointer_not_stl<T> DeltaRecv(T &obj, const int src, const int tag, const Comm &comm, DeltaState &state) {
+            int frameLen;
+            char *frame = nullptr;
+            MEL::Deep::RecvBuffer(frame, frameLen, src, tag, comm);
+            const bool changed = DeltaDecode(frame, frameLen, state);
+            MEL::MemFree(frame);
+
+            if (changed) {
+                Message<TransportBufferRead, HASH_MAP> msg(&state.image[0], (int) state.image.size());
+                msg.setInPlace(true);
+                msg.packRootVar(obj);
+            }
+        };
+
+        TEMPLATE_T_F(TransportBufferRead)
+        inline enable_if_not_pointer_not_stl<T> DeltaRecv(T &obj, const int src, const int tag, const Comm &comm, DeltaState &state) {
+            int frameLen;
+            char *frame = nullptr;
+            MEL::Deep::RecvBuffer(frame, frameLen, src, tag, comm);
+            const bool changed = DeltaDecode(frame, frameLen, state);
+            MEL::MemFree(frame);
+
+            if (changed) {
+                Message<TransportBufferRead, HASH_MAP> msg(&state.image[0], (int) state.image.size());
+                msg.setInPlace(true);
+                msg. template packRootVar<T, F>(obj);
+            }
+        };
+
+        TEMPLATE_T
+        inline enable_if_deep_not_pointer_not_stl<T> DeltaBcast(T &obj, const int root, const Comm &comm, DeltaState &state) {
+            if (MEL::CommRank(comm) == root) {
+                Message<TransportDeltaWrite, HASH_MAP> msg(state);
+                msg.packRootVar(obj);
+
+                int frameLen;
+                char *frame = msg.getTransporter().finish(frameLen);
+                MEL::Deep::BcastBuffer(frame, (int const &) frameLen, root, comm);
+                MEL::MemFree(frame);
+            }
+            else {
+                int frameLen;
+                char *frame = nullptr;
+                MEL::Deep::BcastBuffer(frame, frameLen, root, comm);
+                const bool changed = DeltaDecode(frame, frameLen, state);
+                MEL::MemFree(frame);
+
+                if (changed) {
+                    Message<TransportBufferRead, HASH_MAP> msg(&state.image[0], (int) state.image.size());
+                    msg.setInPlace(true);
+                    msg.packRootVar(obj);
+                }
+            }
+        };
+
+        TEMPLATE_T_F2(TransportDeltaWrite, TransportBufferRead)
+        inline enable_if_not_pointer_not_stl<T> DeltaBcast(T &obj, const int root, const Comm &comm, DeltaState &state) {
+            if (MEL::CommRank(comm) == root) {
+                Message<TransportDeltaWrite, HASH_MAP> msg(state);
+                msg. template packRootVar<T, F1>(obj);
+
+                int frameLen;
+                char *frame = msg.getTransporter().finish(frameLen);
+                MEL::Deep::BcastBuffer(frame, (int const &) frameLen, root, comm);
+                MEL::MemFree(frame);
+            }
+            else {
+                int frameLen;
+                char *frame = nullptr;
+                MEL::Deep::BcastBuffer(frame, frameLen, root, comm);
+                const bool changed = DeltaDecode(frame, frameLen, state);
+                MEL::MemFree(frame);
+
+                if (changed) {
+                    Message<TransportBufferRead, HASH_MAP> msg(&state.image[0], (int) state.image.size());
+                    msg.setInPlace(true);
+                    msg. template packRootVar<T, F2>(obj);
+                }
+            }
+        };
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Arena
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        // Receive variants that allocate every received pointer from arena rather than with one MEL::MemAlloc each. 
+        // Buffered variants reserve room for the whole graph up front from the packed size. Free the whole 
+        // graph with arena.release(). Functors for the receiving side take a Message<..., ArenaAllocator>, and the buffered 
+        // broadcast functor variants take the root's bufferSize explicitly
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Pointer / Length
+
         TEMPLATE_P
-        inline enable_if_pointer<P> BufferedBcast(P &ptr, int &len, const int root, const Comm &comm) {
+        inline enable_if_pointer<P> Recv(P &ptr, int &len, const int src, const int tag, const Comm &comm, Arena &arena) {
+            Message<TransportRecv, HASH_MAP, ArenaAllocator> msg(src, tag, comm);
+            msg.getAllocator().bind(arena);
+            msg.packRootVar(len);
+            msg.packRootPtr(ptr, len);
+        };
+
+        TEMPLATE_P_F_ARENA(TransportRecv)
+        inline enable_if_pointer<P> Recv(P &ptr, int &len, const int src, const int tag, const Comm &comm, Arena &arena) {
+            typedef typename std::remove_pointer<P>::type T;
+            Message<TransportRecv, HASH_MAP, ArenaAllocator> msg(src, tag, comm);
+            msg.getAllocator().bind(arena);
+            msg.packRootVar(len);
+            msg. template packRootPtr<T, F>(ptr, len);
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> Recv(P &ptr, int const &len, const int src, const int tag, const Comm &comm, Arena &arena) {
+            Message<TransportRecv, HASH_MAP, ArenaAllocator> msg(src, tag, comm);
+            msg.getAllocator().bind(arena);
+            int _len = len;
+            msg.packRootVar(_len);
+            if (len != _len) MEL::Exit(-1, "MEL::Deep::Recv(ptr, len) const int len provided does not match incomming message size.");
+            msg.packRootPtr(ptr, _len);
+        };
+
+        TEMPLATE_P_F_ARENA(TransportRecv)
+        inline enable_if_pointer<P> Recv(P &ptr, int const &len, const int src, const int tag, const Comm &comm, Arena &arena) {
+            typedef typename std::remove_pointer<P>::type T;
+            Message<TransportRecv, HASH_MAP, ArenaAllocator> msg(src, tag, comm);
+            msg.getAllocator().bind(arena);
+            int _len = len;
+            msg.packRootVar(_len);
+            if (len != _len) MEL::Exit(-1, "MEL::Deep::Recv(ptr, len) const int len provided does not match incomming message size.");
+            msg. template packRootPtr<T, F>(ptr, _len);
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> BufferedRecv(P &ptr, int &len, const int src, const int tag, const Comm &comm, Arena &arena) {
+            int bufferSize;
+            char *buffer = nullptr;
+            MEL::Deep::RecvBuffer(buffer, bufferSize, src, tag, comm);
+            arena.reservePacked(bufferSize);
+
+            Message<TransportBufferRead, HASH_MAP, ArenaAllocator> msg(buffer, bufferSize);
+            msg.getAllocator().bind(arena);
+            msg.packRootVar(len);
+            msg.packRootPtr(ptr, len);
+
+            MEL::MemFree(buffer);
+        };
+
+        TEMPLATE_P_F_ARENA(TransportBufferRead)
+        inline enable_if_pointer<P> BufferedRecv(P &ptr, int &len, const int src, const int tag, const Comm &comm, Arena &arena) {
+            typedef typename std::remove_pointer<P>::type T;
+
+            int bufferSize;
+            char *buffer = nullptr;
+            MEL::Deep::RecvBuffer(buffer, bufferSize, src, tag, comm);
+            arena.reservePacked(bufferSize);
+
+            Message<TransportBufferRead, HASH_MAP, ArenaAllocator> msg(buffer, bufferSize);
+            msg.getAllocator().bind(arena);
+            msg.packRootVar(len);
+            msg. template packRootPtr<T, F>(ptr, len);
+
+            MEL::MemFree(buffer);
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> BufferedRecv(P &ptr, int const &len, const int src, const int tag, const Comm &comm, Arena &arena) {
+            int bufferSize;
+            char *buffer = nullptr;
+            MEL::Deep::RecvBuffer(buffer, bufferSize, src, tag, comm);
+            arena.reservePacked(bufferSize);
+
+            Message<TransportBufferRead, HASH_MAP, ArenaAllocator> msg(buffer, bufferSize);
+            msg.getAllocator().bind(arena);
+            int _len = len;
+            msg.packRootVar(_len);
+            if (len != _len) MEL::Exit(-1, "MEL::Deep::BufferedRecv(ptr, len) const int len provided does not match incomming message size.");
+            msg.packRootPtr(ptr, _len);
+
+            MEL::MemFree(buffer);
+        };
+
+        TEMPLATE_P_F_ARENA(TransportBufferRead)
+        inline enable_if_pointer<P> BufferedRecv(P &ptr, int const &len, const int src, const int tag, const Comm &comm, Arena &arena) {
+            typedef typename std::remove_pointer<P>::type T;
+
+            int bufferSize;
+            char *buffer = nullptr;
+            MEL::Deep::RecvBuffer(buffer, bufferSize, src, tag, comm);
+            arena.reservePacked(bufferSize);
+
+            Message<TransportBufferRead, HASH_MAP, ArenaAllocator> msg(buffer, bufferSize);
+            msg.getAllocator().bind(arena);
+            int _len = len;
+            msg.packRootVar(_len);
+            if (len != _len) MEL::Exit(-1, "MEL::Deep::BufferedRecv(ptr, len) const int len provided does not match incomming message size.");
+            msg. template packRootPtr<T, F>(ptr, _len);
+
+            MEL::MemFree(buffer);
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> Bcast(P &ptr, int &len, const int root, const Comm &comm, Arena &arena) {
+            if (MEL::CommRank(comm) == root) {
+                Message<TransportBcastRoot, HASH_MAP> msg(root, comm);
+                msg.packRootVar(len);
+                msg.packRootPtr(ptr, len);
+            }
+            else {
+                Message<TransportBcast, HASH_MAP, ArenaAllocator> msg(root, comm);
+                msg.getAllocator().bind(arena);
+                msg.packRootVar(len);
+                msg.packRootPtr(ptr, len);
+            }
+        };
+
+        TEMPLATE_P_F2_ARENA(TransportBcastRoot, TransportBcast)
+        inline enable_if_pointer<P> Bcast(P &ptr, int &len, const int root, const Comm &comm, Arena &arena) {
+            typedef typename std::remove_pointer<P>::type T;
             if (MEL::CommRank(comm) == root) {
-                MEL::Deep::BufferedBcast(ptr, len, root, comm, MEL::Deep::BufferSize(ptr, len));
+                Message<TransportBcastRoot, HASH_MAP> msg(root, comm);
+                msg.packRootVar(len);
+                msg. template packRootPtr<T, F1>(ptr, len);
             }
             else {
-                MEL::Deep::BufferedBcast(ptr, len, root, comm, 0);
+                Message<TransportBcast, HASH_MAP, ArenaAllocator> msg(root, comm);
+                msg.getAllocator().bind(arena);
+                msg.packRootVar(len);
+                msg. template packRootPtr<T, F2>(ptr, len);
             }
         };
 
-        TEMPLATE_P_F2(TransportBufferWrite, TransportBufferRead)
-        inline enable_if_pointer<P> BufferedBcast(P &ptr, int &len, const int root, const Comm &comm) {
+        TEMPLATE_P
+        inline enable_if_pointer<P> Bcast(P &ptr, int const &len, const int root, const Comm &comm, Arena &arena) {
+            int _len = len;
+            if (MEL::CommRank(comm) == root) {
+                Message<TransportBcastRoot, HASH_MAP> msg(root, comm);
+                msg.packRootVar(_len);
+                msg.packRootPtr(ptr, _len);
+            }
+            else {
+                Message<TransportBcast, HASH_MAP, ArenaAllocator> msg(root, comm);
+                msg.getAllocator().bind(arena);
+                msg.packRootVar(_len);
+                if (len != _len) MEL::Exit(-1, "MEL::Deep::Bcast(ptr, len) const int len provided does not match incomming message size.");
+                msg.packRootPtr(ptr, _len);
+            }
+        };
+
+        TEMPLATE_P_F2_ARENA(TransportBcastRoot, TransportBcast)
+        inline enable_if_pointer<P> Bcast(P &ptr, int const &len, const int root, const Comm &comm, Arena &arena) {
+            typedef typename std::remove_pointer<P>::type T;
+            int _len = len;
+            if (MEL::CommRank(comm) == root) {
+                Message<TransportBcastRoot, HASH_MAP> msg(root, comm);
+                msg.packRootVar(_len);
+                msg. template packRootPtr<T, F1>(ptr, _len);
+            }
+            else {
+                Message<TransportBcast, HASH_MAP, ArenaAllocator> msg(root, comm);
+                msg.getAllocator().bind(arena);
+                msg.packRootVar(_len);
+                if (len != _len) MEL::Exit(-1, "MEL::Deep::Bcast(ptr, len) const int len provided does not match incomming message size.");
+                msg. template packRootPtr<T, F2>(ptr, _len);
+            }
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> BufferedBcast(P &ptr, int &len, const int root, const Comm &comm, Arena &arena) {
+            if (MEL::CommRank(comm) == root) {
+                const int bufferSize = MEL::Deep::BufferSize<P, HASH_MAP>(ptr, len);
+                char *buffer = MEL::MemAlloc<char>(bufferSize);
+                Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
+                msg.packRootVar(len);
+                msg.packRootPtr(ptr, len);
+
+                MEL::Deep::BcastBuffer(buffer, msg.getOffset(), root, comm);
+                MEL::MemFree(buffer);
+            }
+            else {
+                int bufferSize;
+                char *buffer = nullptr;
+                MEL::Deep::BcastBuffer(buffer, bufferSize, root, comm);
+                arena.reservePacked(bufferSize);
+
+                Message<TransportBufferRead, HASH_MAP, ArenaAllocator> msg(buffer, bufferSize);
+                msg.getAllocator().bind(arena);
+                msg.packRootVar(len);
+                msg.packRootPtr(ptr, len);
+
+                MEL::MemFree(buffer);
+            }
+        };
+
+        TEMPLATE_P_F2_ARENA(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_pointer<P> BufferedBcast(P &ptr, int &len, const int root, const Comm &comm, const int bufferSize, Arena &arena) {
+            typedef typename std::remove_pointer<P>::type T;
             if (MEL::CommRank(comm) == root) {
-                MEL::Deep::BufferedBcast<P, HASH_MAP, F1>(ptr, len, root, comm, MEL::Deep::BufferSize<P, HASH_MAP, F1>(ptr, len));
+                char *buffer = MEL::MemAlloc<char>(bufferSize);
+                Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
+                msg.packRootVar(len);
+                msg. template packRootPtr<T, F1>(ptr, len);
+
+                MEL::Deep::BcastBuffer(buffer, msg.getOffset(), root, comm);
+                MEL::MemFree(buffer);
             }
             else {
-                MEL::Deep::BufferedBcast<P, HASH_MAP, F2>(ptr, len, root, comm, 0);
+                int _bufferSize;
+                char *buffer = nullptr;
+                MEL::Deep::BcastBuffer(buffer, _bufferSize, root, comm);
+                arena.reservePacked(_bufferSize);
+
+                Message<TransportBufferRead, HASH_MAP, ArenaAllocator> msg(buffer, _bufferSize);
+                msg.getAllocator().bind(arena);
+                msg.packRootVar(len);
+                msg. template packRootPtr<T, F2>(ptr, len);
+
+                MEL::MemFree(buffer);
             }
         };
 
         TEMPLATE_P
-        inline enable_if_pointer<P> BufferedBcast(P &ptr, int const &len, const int root, const Comm &comm, const int bufferSize) {
+        inline enable_if_pointer<P> BufferedBcast(P &ptr, int const &len, const int root, const Comm &comm, Arena &arena) {
+            int _len = len;
             if (MEL::CommRank(comm) == root) {
+                const int bufferSize = MEL::Deep::BufferSize<P, HASH_MAP>(ptr, len);
                 char *buffer = MEL::MemAlloc<char>(bufferSize);
                 Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
-                msg.packRootVar(len);
-                msg.packRootPtr(ptr);
+                msg.packRootVar(_len);
+                msg.packRootPtr(ptr, _len);
 
-                MEL::Deep::Bcast(buffer, msg.getOffset(), root, comm);
+                MEL::Deep::BcastBuffer(buffer, msg.getOffset(), root, comm);
                 MEL::MemFree(buffer);
             }
             else {
-                int _bufferSize;
+                int bufferSize;
                 char *buffer = nullptr;
-                MEL::Deep::Bcast(buffer, _bufferSize, root, comm);
+                MEL::Deep::BcastBuffer(buffer, bufferSize, root, comm);
+                arena.reservePacked(bufferSize);
 
-                Message<TransportBufferRead, HASH_MAP> msg(buffer, _bufferSize);
-                int _len = len;
+                Message<TransportBufferRead, HASH_MAP, ArenaAllocator> msg(buffer, bufferSize);
+                msg.getAllocator().bind(arena);
                 msg.packRootVar(_len);
                 if (len != _len) MEL::Exit(-1, "MEL::Deep::BufferedBcast(ptr, len) const int len provided does not match incomming message size.");
-                msg.packRootPtr(ptr);
+                msg.packRootPtr(ptr, _len);
 
                 MEL::MemFree(buffer);
             }
         };
 
-        TEMPLATE_P_F2(TransportBufferWrite, TransportBufferRead)
-        inline enable_if_pointer<P> BufferedBcast(P &ptr, int const &len, const int root, const Comm &comm, const int bufferSize) {
+        TEMPLATE_P_F2_ARENA(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_pointer<P> BufferedBcast(P &ptr, int const &len, const int root, const Comm &comm, const int bufferSize, Arena &arena) {
             typedef typename std::remove_pointer<P>::type T;
+            int _len = len;
             if (MEL::CommRank(comm) == root) {
                 char *buffer = MEL::MemAlloc<char>(bufferSize);
                 Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
-                msg.packRootVar(len);
-                msg. template packRootPtr<T, F1>(ptr);
+                msg.packRootVar(_len);
+                msg. template packRootPtr<T, F1>(ptr, _len);
 
-                MEL::Deep::Bcast(buffer, msg.getOffset(), root, comm);
+                MEL::Deep::BcastBuffer(buffer, msg.getOffset(), root, comm);
                 MEL::MemFree(buffer);
             }
             else {
                 int _bufferSize;
                 char *buffer = nullptr;
-                MEL::Deep::Bcast(buffer, _bufferSize, root, comm);
+                MEL::Deep::BcastBuffer(buffer, _bufferSize, root, comm);
+                arena.reservePacked(_bufferSize);
 
-                Message<TransportBufferRead, HASH_MAP> msg(buffer, _bufferSize);
-                int _len = len;
+                Message<TransportBufferRead, HASH_MAP, ArenaAllocator> msg(buffer, _bufferSize);
+                msg.getAllocator().bind(arena);
                 msg.packRootVar(_len);
                 if (len != _len) MEL::Exit(-1, "MEL::Deep::BufferedBcast(ptr, len) const int len provided does not match incomming message size.");
-                msg. template packRootPtr<T, F2>(ptr);
+                msg. template packRootPtr<T, F2>(ptr, _len);
 
                 MEL::MemFree(buffer);
             }
         };
 
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Pointer
+
         TEMPLATE_P
-        inline enable_if_pointer<P> BufferedBcast(P &ptr, int const &len, const int root, const Comm &comm) {
-            if (MEL::CommRank(comm) == root) {
-                MEL::Deep::BufferedBcast(ptr, len, root, comm, MEL::Deep::BufferSize(ptr, len));
-            }
-            else {
-                MEL::Deep::BufferedBcast(ptr, len, root, comm, 0);
-            }
+        inline enable_if_pointer<P> Recv(P &ptr, const int src, const int tag, const Comm &comm, Arena &arena) {
+            Message<TransportRecv, HASH_MAP, ArenaAllocator> msg(src, tag, comm);
+            msg.getAllocator().bind(arena);
+            msg.packRootPtr(ptr);
         };
 
-        TEMPLATE_P_F2(TransportBufferWrite, TransportBufferRead)
-        inline enable_if_pointer<P> BufferedBcast(P &ptr, int const &len, const int root, const Comm &comm) {
-            if (MEL::CommRank(comm) == root) {
-                MEL::Deep::BufferedBcast<P, HASH_MAP, F1>(ptr, len, root, comm, MEL::Deep::BufferSize<P, HASH_MAP, F1>(ptr, len));
-            }
-            else {
-                MEL::Deep::BufferedBcast<P, HASH_MAP, F2>(ptr, len, root, comm, 0);
-            }
+        TEMPLATE_P_F_ARENA(TransportRecv)
+        inline enable_if_pointer<P> Recv(P &ptr, const int src, const int tag, const Comm &comm, Arena &arena) {
+            typedef typename std::remove_pointer<P>::type T;
+            Message<TransportRecv, HASH_MAP, ArenaAllocator> msg(src, tag, comm);
+            msg.getAllocator().bind(arena);
+            msg. template packRootPtr<T, F>(ptr);
         };
 
-        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-        // Pointer
+        TEMPLATE_P
+        inline enable_if_pointer<P> BufferedRecv(P &ptr, const int src, const int tag, const Comm &comm, Arena &arena) {
+            int bufferSize;
+            char *buffer = nullptr;
+            MEL::Deep::RecvBuffer(buffer, bufferSize, src, tag, comm);
+            arena.reservePacked(bufferSize);
+
+            Message<TransportBufferRead, HASH_MAP, ArenaAllocator> msg(buffer, bufferSize);
+            msg.getAllocator().bind(arena);
+            msg.packRootPtr(ptr);
+
+            MEL::MemFree(buffer);
+        };
+
+        TEMPLATE_P_F_ARENA(TransportBufferRead)
+        inline enable_if_pointer<P> BufferedRecv(P &ptr, const int src, const int tag, const Comm &comm, Arena &arena) {
+            typedef typename std::remove_pointer<P>::type T;
+
+            int bufferSize;
+            char *buffer = nullptr;
+            MEL::Deep::RecvBuffer(buffer, bufferSize, src, tag, comm);
+            arena.reservePacked(bufferSize);
+
+            Message<TransportBufferRead, HASH_MAP, ArenaAllocator> msg(buffer, bufferSize);
+            msg.getAllocator().bind(arena);
+            msg. template packRootPtr<T, F>(ptr);
+
+            MEL::MemFree(buffer);
+        };
 
         TEMPLATE_P
-        inline enable_if_pointer<P> Bcast(P &ptr, const int root, const Comm &comm) {
+        inline enable_if_pointer<P> Bcast(P &ptr, const int root, const Comm &comm, Arena &arena) {
             if (MEL::CommRank(comm) == root) {
                 Message<TransportBcastRoot, HASH_MAP> msg(root, comm);
                 msg.packRootPtr(ptr);
             }
             else {
-                Message<TransportBcast, HASH_MAP> msg(root, comm);
+                Message<TransportBcast, HASH_MAP, ArenaAllocator> msg(root, comm);
+                msg.getAllocator().bind(arena);
                 msg.packRootPtr(ptr);
             }
         };
 
-        TEMPLATE_P_F2(TransportBcastRoot, TransportBcast)
-        inline enable_if_pointer<P> Bcast(P &ptr, const int root, const Comm &comm) {
+        TEMPLATE_P_F2_ARENA(TransportBcastRoot, TransportBcast)
+        inline enable_if_pointer<P> Bcast(P &ptr, const int root, const Comm &comm, Arena &arena) {
             typedef typename std::remove_pointer<P>::type T;
             if (MEL::CommRank(comm) == root) {
                 Message<TransportBcastRoot, HASH_MAP> msg(root, comm);
                 msg. template packRootPtr<T, F1>(ptr);
             }
             else {
-                Message<TransportBcast, HASH_MAP> msg(root, comm);
-                
+                Message<TransportBcast, HASH_MAP, ArenaAllocator> msg(root, comm);
+                msg.getAllocator().bind(arena);
                 msg. template packRootPtr<T, F2>(ptr);
             }
         };
 
         TEMPLATE_P
-        inline enable_if_pointer<P> BufferedBcast(P &ptr, const int root, const Comm &comm, const int bufferSize) {
+        inline enable_if_pointer<P> BufferedBcast(P &ptr, const int root, const Comm &comm, Arena &arena) {
             if (MEL::CommRank(comm) == root) {
+                const int bufferSize = MEL::Deep::BufferSize(ptr);
                 char *buffer = MEL::MemAlloc<char>(bufferSize);
                 Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
                 msg.packRootPtr(ptr);
 
-                MEL::Deep::Bcast(buffer, msg.getOffset(), root, comm);
+                MEL::Deep::BcastBuffer(buffer, msg.getOffset(), root, comm);
                 MEL::MemFree(buffer);
             }
             else {
-                int _bufferSize;
+                int bufferSize;
                 char *buffer = nullptr;
-                MEL::Deep::Bcast(buffer, _bufferSize, root, comm);
+                MEL::Deep::BcastBuffer(buffer, bufferSize, root, comm);
+                arena.reservePacked(bufferSize);
 
-                Message<TransportBufferRead, HASH_MAP> msg(buffer, _bufferSize);
+                Message<TransportBufferRead, HASH_MAP, ArenaAllocator> msg(buffer, bufferSize);
+                msg.getAllocator().bind(arena);
                 msg.packRootPtr(ptr);
 
                 MEL::MemFree(buffer);
             }
         };
 
-        TEMPLATE_P_F2(TransportBufferWrite, TransportBufferRead)
-        inline enable_if_pointer<P> BufferedBcast(P &ptr, const int root, const Comm &comm, const int bufferSize) {
+        TEMPLATE_P_F2_ARENA(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_pointer<P> BufferedBcast(P &ptr, const int root, const Comm &comm, const int bufferSize, Arena &arena) {
             typedef typename std::remove_pointer<P>::type T;
             if (MEL::CommRank(comm) == root) {
                 char *buffer = MEL::MemAlloc<char>(bufferSize);
                 Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
                 msg. template packRootPtr<T, F1>(ptr);
 
-                MEL::Deep::Bcast(buffer, msg.getOffset(), root, comm);
+                MEL::Deep::BcastBuffer(buffer, msg.getOffset(), root, comm);
                 MEL::MemFree(buffer);
             }
             else {
                 int _bufferSize;
                 char *buffer = nullptr;
-                MEL::Deep::Bcast(buffer, _bufferSize, root, comm);
+                MEL::Deep::BcastBuffer(buffer, _bufferSize, root, comm);
+                arena.reservePacked(_bufferSize);
 
-                Message<TransportBufferRead, HASH_MAP> msg(buffer, _bufferSize);
+                Message<TransportBufferRead, HASH_MAP, ArenaAllocator> msg(buffer, _bufferSize);
+                msg.getAllocator().bind(arena);
                 msg. template packRootPtr<T, F2>(ptr);
 
                 MEL::MemFree(buffer);
             }
         };
 
-        TEMPLATE_P
-        inline enable_if_pointer<P> BufferedBcast(P &ptr, const int root, const Comm &comm) {
-            if (MEL::CommRank(comm) == root) {
-                MEL::Deep::BufferedBcast(ptr, root, comm, MEL::Deep::BufferSize(ptr));
-            }
-            else {
-                MEL::Deep::BufferedBcast(ptr, root, comm, 0);
-            }
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // STL
+
+        TEMPLATE_STL
+        inline enable_if_stl<S> Recv(S &obj, const int src, const int tag, const Comm &comm, Arena &arena) {
+            Message<TransportRecv, HASH_MAP, ArenaAllocator> msg(src, tag, comm);
+            msg.getAllocator().bind(arena);
+            msg.packRootSTL(obj);
         };
 
-        TEMPLATE_P_F2(TransportBufferWrite, TransportBufferRead)
-        inline enable_if_pointer<P> BufferedBcast(P &ptr, const int root, const Comm &comm) {
-            if (MEL::CommRank(comm) == root) {
-                MEL::Deep::BufferedBcast<P, HASH_MAP, F1>(ptr, root, comm, MEL::Deep::BufferSize<P, HASH_MAP, F1>(ptr));
-            }
-            else {
-                MEL::Deep::BufferedBcast<P, HASH_MAP, F2>(ptr, root, comm, 0);
-            }
+        TEMPLATE_STL_F_ARENA(TransportRecv)
+        inline enable_if_stl<S> Recv(S &obj, const int src, const int tag, const Comm &comm, Arena &arena) {
+            typedef typename S::value_type T;
+            Message<TransportRecv, HASH_MAP, ArenaAllocator> msg(src, tag, comm);
+            msg.getAllocator().bind(arena);
+            msg. template packRootSTL<T, F>(obj);
         };
 
-        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-        // STL
+        TEMPLATE_STL
+        inline enable_if_stl<S> BufferedRecv(S &obj, const int src, const int tag, const Comm &comm, Arena &arena) {
+            int bufferSize;
+            char *buffer = nullptr;
+            MEL::Deep::RecvBuffer(buffer, bufferSize, src, tag, comm);
+            arena.reservePacked(bufferSize);
+
+            Message<TransportBufferRead, HASH_MAP, ArenaAllocator> msg(buffer, bufferSize);
+            msg.getAllocator().bind(arena);
+            msg.packRootSTL(obj);
+
+            MEL::MemFree(buffer);
+        };
+
+        TEMPLATE_STL_F_ARENA(TransportBufferRead)
+        inline enable_if_stl<S> BufferedRecv(S &obj, const int src, const int tag, const Comm &comm, Arena &arena) {
+            typedef typename S::value_type T;
+            int bufferSize;
+            char *buffer = nullptr;
+            MEL::Deep::RecvBuffer(buffer, bufferSize, src, tag, comm);
+            arena.reservePacked(bufferSize);
+
+            Message<TransportBufferRead, HASH_MAP, ArenaAllocator> msg(buffer, bufferSize);
+            msg.getAllocator().bind(arena);
+            msg. template packRootSTL<T, F>(obj);
+
+            MEL::MemFree(buffer);
+        };
 
         TEMPLATE_STL
-        inline enable_if_stl<S> Bcast(S &obj, const int root, const Comm &comm) {
+        inline enable_if_stl<S> Bcast(S &obj, const int root, const Comm &comm, Arena &arena) {
             if (MEL::CommRank(comm) == root) {
                 Message<TransportBcastRoot, HASH_MAP> msg(root, comm);
                 msg.packRootSTL(obj);
             }
             else {
-                Message<TransportBcast, HASH_MAP> msg(root, comm);
+                Message<TransportBcast, HASH_MAP, ArenaAllocator> msg(root, comm);
+                msg.getAllocator().bind(arena);
                 msg.packRootSTL(obj);
             }
         };
 
-        TEMPLATE_STL_F2(TransportBcastRoot, TransportBcast)
-        inline enable_if_stl<S> Bcast(S &obj, const int root, const Comm &comm) {
+        TEMPLATE_STL_F2_ARENA(TransportBcastRoot, TransportBcast)
+        inline enable_if_stl<S> Bcast(S &obj, const int root, const Comm &comm, Arena &arena) {
             typedef typename S::value_type T;
             if (MEL::CommRank(comm) == root) {
                 Message<TransportBcastRoot, HASH_MAP> msg(root, comm);
                 msg. template packRootSTL<T, F1>(obj);
             }
             else {
-                Message<TransportBcast, HASH_MAP> msg(root, comm);
+                Message<TransportBcast, HASH_MAP, ArenaAllocator> msg(root, comm);
+                msg.getAllocator().bind(arena);
                 msg. template packRootSTL<T, F2>(obj);
             }
         };
 
         TEMPLATE_STL
-        inline enable_if_stl<S> BufferedBcast(S &obj, const int root, const Comm &comm, const int bufferSize) {
+        inline enable_if_stl<S> BufferedBcast(S &obj, const int root, const Comm &comm, Arena &arena) {
             if (MEL::CommRank(comm) == root) {
+                const int bufferSize = MEL::Deep::BufferSize<S, HASH_MAP>(obj);
                 char *buffer = MEL::MemAlloc<char>(bufferSize);
                 Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
                 msg.packRootSTL(obj);
 
-                MEL::Deep::Bcast(buffer, msg.getOffset(), root, comm);
+                MEL::Deep::BcastBuffer(buffer, msg.getOffset(), root, comm);
                 MEL::MemFree(buffer);
             }
             else {
-                int _bufferSize;
+                int bufferSize;
                 char *buffer = nullptr;
-                MEL::Deep::Bcast(buffer, _bufferSize, root, comm);
+                MEL::Deep::BcastBuffer(buffer, bufferSize, root, comm);
+                arena.reservePacked(bufferSize);
 
-                Message<TransportBufferRead, HASH_MAP> msg(buffer, _bufferSize);
+                Message<TransportBufferRead, HASH_MAP, ArenaAllocator> msg(buffer, bufferSize);
+                msg.getAllocator().bind(arena);
                 msg.packRootSTL(obj);
 
                 MEL::MemFree(buffer);
             }
         };
 
-        TEMPLATE_STL_F2(TransportBufferWrite, TransportBufferRead)
-        inline enable_if_stl<S> BufferedBcast(S &obj, const int root, const Comm &comm, const int bufferSize) {
+        TEMPLATE_STL_F2_ARENA(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_stl<S> BufferedBcast(S &obj, const int root, const Comm &comm, const int bufferSize, Arena &arena) {
             typedef typename S::value_type T;
             if (MEL::CommRank(comm) == root) {
                 char *buffer = MEL::MemAlloc<char>(bufferSize);
                 Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
                 msg. template packRootSTL<T, F1>(obj);
 
-                MEL::Deep::Bcast(buffer, msg.getOffset(), root, comm);
+                MEL::Deep::BcastBuffer(buffer, msg.getOffset(), root, comm);
                 MEL::MemFree(buffer);
             }
             else {
                 int _bufferSize;
                 char *buffer = nullptr;
-                MEL::Deep::Bcast(buffer, _bufferSize, root, comm);
+                MEL::Deep::BcastBuffer(buffer, _bufferSize, root, comm);
+                arena.reservePacked(_bufferSize);
 
-                Message<TransportBufferRead, HASH_MAP> msg(buffer, _bufferSize);
+                Message<TransportBufferRead, HASH_MAP, ArenaAllocator> msg(buffer, _bufferSize);
+                msg.getAllocator().bind(arena);
                 msg. template packRootSTL<T, F2>(obj);
 
                 MEL::MemFree(buffer);
             }
         };
 
-        TEMPLATE_STL
-        inline enable_if_stl<S> BufferedBcast(S &obj, const int root, const Comm &comm) {
-            if (MEL::CommRank(comm) == root) {
-                MEL::Deep::BufferedBcast(obj, root, comm, MEL::Deep::BufferSize(obj));
-            }
-            else {
-                MEL::Deep::BufferedBcast(obj, root, comm, 0);
-            }
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Object
+
+        TEMPLATE_T
+        inline enable_if_not_pointer_not_stl<T> Recv(T &obj, const int src, const int tag, const Comm &comm, Arena &arena) {
+            Message<TransportRecv, HASH_MAP, ArenaAllocator> msg(src, tag, comm);
+            msg.getAllocator().bind(arena);
+            msg.packRootVar(obj);
         };
 
-        TEMPLATE_STL_F2(TransportBufferWrite, TransportBufferRead)
-        inline enable_if_stl<S> BufferedBcast(S &obj, const int root, const Comm &comm) {
-            if (MEL::CommRank(comm) == root) {
-                MEL::Deep::BufferedBcast<S, HASH_MAP, F1>(obj, root, comm, MEL::Deep::BufferSize<S, HASH_MAP, F1>(obj));
-            }
-            else {
-                MEL::Deep::BufferedBcast<S, HASH_MAP, F2>(obj, root, comm, 0);
-            }
+        TEMPLATE_T_F_ARENA(TransportRecv)
+        inline enable_if_not_pointer_not_stl<T> Recv(T &obj, const int src, const int tag, const Comm &comm, Arena &arena) {
+            Message<TransportRecv, HASH_MAP, ArenaAllocator> msg(src, tag, comm);
+            msg.getAllocator().bind(arena);
+            msg. template packRootVar<T, F>(obj);
         };
 
-        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-        // Object
+        TEMPLATE_T
+        inline enable_if_deep_not_pointer_not_stl<T> BufferedRecv(T &obj, const int src, const int tag, const Comm &comm, Arena &arena) {
+            int bufferSize;
+            char *buffer = nullptr;
+            MEL::Deep::RecvBuffer(buffer, bufferSize, src, tag, comm);
+            arena.reservePacked(bufferSize);
+
+            Message<TransportBufferRead, HASH_MAP, ArenaAllocator> msg(buffer, bufferSize);
+            msg.getAllocator().bind(arena);
+            msg.packRootVar(obj);
+
+            MEL::MemFree(buffer);
+        };
+
+        TEMPLATE_T_F_ARENA(TransportBufferRead)
+        inline enable_if_not_pointer_not_stl<T> BufferedRecv(T &obj, const int src, const int tag, const Comm &comm, Arena &arena) {
+            int bufferSize;
+            char *buffer = nullptr;
+            MEL::Deep::RecvBuffer(buffer, bufferSize, src, tag, comm);
+            arena.reservePacked(bufferSize);
+
+            Message<TransportBufferRead, HASH_MAP, ArenaAllocator> msg(buffer, bufferSize);
+            msg.getAllocator().bind(arena);
+            msg. template packRootVar<T, F>(obj);
+
+            MEL::MemFree(buffer);
+        };
 
         TEMPLATE_T
-        inline enable_if_not_pointer_not_stl<T> Bcast(T &obj, const int root, const Comm &comm) {
+        inline enable_if_not_pointer_not_stl<T> Bcast(T &obj, const int root, const Comm &comm, Arena &arena) {
             if (MEL::CommRank(comm) == root) {
                 Message<TransportBcastRoot, HASH_MAP> msg(root, comm);
                 msg.packRootVar(obj);
             }
             else {
-                Message<TransportBcast, HASH_MAP> msg(root, comm);
+                Message<TransportBcast, HASH_MAP, ArenaAllocator> msg(root, comm);
+                msg.getAllocator().bind(arena);
                 msg.packRootVar(obj);
             }
         };
 
-        TEMPLATE_T_F2(TransportBcastRoot, TransportBcast)
-        inline enable_if_not_pointer_not_stl<T> Bcast(T &obj, const int root, const Comm &comm) {
+        TEMPLATE_T_F2_ARENA(TransportBcastRoot, TransportBcast)
+        inline enable_if_not_pointer_not_stl<T> Bcast(T &obj, const int root, const Comm &comm, Arena &arena) {
             if (MEL::CommRank(comm) == root) {
                 Message<TransportBcastRoot, HASH_MAP> msg(root, comm);
                 msg. template packRootVar<T, F1>(obj);
             }
             else {
-                Message<TransportBcast, HASH_MAP> msg(root, comm);
+                Message<TransportBcast, HASH_MAP, ArenaAllocator> msg(root, comm);
+                msg.getAllocator().bind(arena);
                 msg. template packRootVar<T, F2>(obj);
             }
         };
 
         TEMPLATE_T
-        inline enable_if_deep_not_pointer_not_stl<T> BufferedBcast(T &obj, const int root, const Comm &comm, const int bufferSize) {
+        inline enable_if_deep_not_pointer_not_stl<T> BufferedBcast(T &obj, const int root, const Comm &comm, Arena &arena) {
             if (MEL::CommRank(comm) == root) {
+                const int bufferSize = MEL::Deep::BufferSize(obj);
                 char *buffer = MEL::MemAlloc<char>(bufferSize);
                 Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
                 msg.packRootVar(obj);
 
-                MEL::Deep::Bcast(buffer, msg.getOffset(), root, comm);
+                MEL::Deep::BcastBuffer(buffer, msg.getOffset(), root, comm);
                 MEL::MemFree(buffer);
             }
             else {
-                int _bufferSize;
+                int bufferSize;
                 char *buffer = nullptr;
-                MEL::Deep::Bcast(buffer, _bufferSize, root, comm);
+                MEL::Deep::BcastBuffer(buffer, bufferSize, root, comm);
+                arena.reservePacked(bufferSize);
 
-                Message<TransportBufferRead, HASH_MAP> msg(buffer, _bufferSize);
+                Message<TransportBufferRead, HASH_MAP, ArenaAllocator> msg(buffer, bufferSize);
+                msg.getAllocator().bind(arena);
                 msg.packRootVar(obj);
 
                 MEL::MemFree(buffer);
             }
         };
 
-        TEMPLATE_T_F2(TransportBufferWrite, TransportBufferRead)
-        inline enable_if_not_pointer_not_stl<T> BufferedBcast(T &obj, const int root, const Comm &comm, const int bufferSize) {
+        TEMPLATE_T_F2_ARENA(TransportBufferWrite, TransportBufferRead)
+        inline enable_if_not_pointer_not_stl<T> BufferedBcast(T &obj, const int root, const Comm &comm, const int bufferSize, Arena &arena) {
             if (MEL::CommRank(comm) == root) {
                 char *buffer = MEL::MemAlloc<char>(bufferSize);
                 Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
                 msg. template packRootVar<T, F1>(obj);
 
-                MEL::Deep::Bcast(buffer, msg.getOffset(), root, comm);
+                MEL::Deep::BcastBuffer(buffer, msg.getOffset(), root, comm);
                 MEL::MemFree(buffer);
             }
             else {
                 int _bufferSize;
                 char *buffer = nullptr;
-                MEL::Deep::Bcast(buffer, _bufferSize, root, comm);
+                MEL::Deep::BcastBuffer(buffer, _bufferSize, root, comm);
+                arena.reservePacked(_bufferSize);
 
-                Message<TransportBufferRead, HASH_MAP> msg(buffer, _bufferSize);
+                Message<TransportBufferRead, HASH_MAP, ArenaAllocator> msg(buffer, _bufferSize);
+                msg.getAllocator().bind(arena);
                 msg. template packRootVar<T, F2>(obj);
 
                 MEL::MemFree(buffer);
             }
         };
 
-        TEMPLATE_T
-        inline enable_if_deep_not_pointer_not_stl<T> BufferedBcast(T &obj, const int root, const Comm &comm) {
-            if (MEL::CommRank(comm) == root) {
-                MEL::Deep::BufferedBcast(obj, root, comm, MEL::Deep::BufferSize(obj));
-            }
-            else {
-                MEL::Deep::BufferedBcast(obj, root, comm, 0);
-            }
-        };
-
-        TEMPLATE_T_F2(TransportBufferWrite, TransportBufferRead)
-        inline enable_if_not_pointer_not_stl<T> BufferedBcast(T &obj, const int root, const Comm &comm) {
-            if (MEL::CommRank(comm) == root) {
-                MEL::Deep::BufferedBcast<T, HASH_MAP, F1>(obj, root, comm, MEL::Deep::BufferSize<T, HASH_MAP, F1>(obj));
-            }
-            else {
-                MEL::Deep::BufferedBcast<T, HASH_MAP, F2>(obj, root, comm, 0);
-            }
-        };
-
         /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
         // MPI_File Write
         /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -2123,61 +5303,222 @@ namespace MEL {
             char *buffer = nullptr;
             MEL::Deep::FileRead(buffer, bufferSize, file);
 
-            Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
-            msg.packRootSTL(obj);
+            Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
+            msg.packRootSTL(obj);
+
+            MEL::MemFree(buffer);
+        };
+
+        TEMPLATE_STL_F(TransportBufferRead)
+        inline enable_if_stl<S> BufferedFileRead(S &obj, MEL::File &file) {
+            typedef typename S::value_type T;
+            int bufferSize;
+            char *buffer = nullptr;
+            MEL::Deep::FileRead(buffer, bufferSize, file);
+
+            Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
+            msg. template packRootSTL<T, F>(obj);
+
+            MEL::MemFree(buffer);
+        };
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Object
+
+        TEMPLATE_T
+        inline enable_if_not_pointer_not_stl<T> FileRead(T &obj, MEL::File &file) {
+            Message<TransportFileRead, HASH_MAP> msg(file);
+            msg.packRootVar(obj);
+        };
+
+        TEMPLATE_T_F(TransportFileRead)
+        inline enable_if_not_pointer_not_stl<T> FileRead(T &obj, MEL::File &file) {
+            Message<TransportFileRead, HASH_MAP> msg(file);
+            msg. template packRootVar<T, F>(obj);
+        };
+
+        TEMPLATE_T
+        inline enable_if_deep_not_pointer_not_stl<T> BufferedFileRead(T &obj, MEL::File &file) {
+            int bufferSize;
+            char *buffer = nullptr;
+            MEL::Deep::FileRead(buffer, bufferSize, file);
+
+            Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
+            msg.packRootVar(obj);
+
+            MEL::MemFree(buffer);
+        };
+
+        TEMPLATE_T_F(TransportBufferRead)
+        inline enable_if_not_pointer_not_stl<T> BufferedFileRead(T &obj, MEL::File &file) {
+            int bufferSize;
+            char *buffer = nullptr;
+            MEL::Deep::FileRead(buffer, bufferSize, file);
+
+            Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
+            msg. template packRootVar<T, F>(obj);
+
+            MEL::MemFree(buffer);
+        };
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // MPI_File Collective
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        // Every process in comm packs its object locally and all of them are written into one shared file with MPI_File_write_at_all.
+        // The layout at offset is a header { "MELDEEPA", number of pieces } and an index with one { offset, size } entry per writing
+        // process, followed by the packed pieces in rank order. Piece offsets come from an exclusive scan of the packed sizes
+
+        struct FileCollectiveEntry {
+            long long offset, size;
+        };
+
+        static constexpr int FILE_COLLECTIVE_HEADER = 16;
+
+        // Collective reads move at most this many bytes per MPI_File_read_at_all, as the count is an int
+        static constexpr long long FILE_COLLECTIVE_CHUNK = 1 << 30;
+
+        // Writes the header, the index and the packed pieces. Returns the number of bytes written from offset
+        inline MEL::Offset FileWriteAllPieces(const char *buffer, const int len, MEL::File &file, const Comm &comm, const MEL::Offset offset) {
+            const int rank = MEL::CommRank(comm), size = MEL::CommSize(comm);
+            long long bytes = len, start = 0, total = 0;
+            MEL::Exscan(&bytes, &start, 1, MEL::Datatype::LONG_LONG, MEL::Op::SUM, comm);
+            MEL::Allreduce(&bytes, &total, 1, MEL::Datatype::LONG_LONG, MEL::Op::SUM, comm);
+            if (rank == 0) start = 0;
 
-            MEL::MemFree(buffer);
+            const MEL::Offset dataOffset = offset + FILE_COLLECTIVE_HEADER + (MEL::Offset) size * sizeof(FileCollectiveEntry);
+
+            // Rank 0 writes the header together with its own index entry
+            char index[FILE_COLLECTIVE_HEADER + sizeof(FileCollectiveEntry)];
+            FileCollectiveEntry entry = { dataOffset + start, bytes };
+            long long numPieces = size;
+            memcpy(index, "MELDEEPA", 8);
+            memcpy(index + 8, &numPieces, sizeof(long long));
+            memcpy(index + FILE_COLLECTIVE_HEADER, &entry, sizeof(entry));
+
+            if (rank == 0) MEL::FileWriteAtAll(file, offset, index, sizeof(index), MEL::Datatype::CHAR);
+            else           MEL::FileWriteAtAll(file, offset + FILE_COLLECTIVE_HEADER + (MEL::Offset) rank * sizeof(entry), index + FILE_COLLECTIVE_HEADER, sizeof(entry), MEL::Datatype::CHAR);
+
+            MEL::FileWriteAtAll(file, dataOffset + start, buffer, len, MEL::Datatype::CHAR);
+            return (dataOffset - offset) + total;
         };
 
-        TEMPLATE_STL_F(TransportBufferRead)
-        inline enable_if_stl<S> BufferedFileRead(S &obj, MEL::File &file) {
-            typedef typename S::value_type T;
-            int bufferSize;
-            char *buffer = nullptr;
-            MEL::Deep::FileRead(buffer, bufferSize, file);
+        // Reads the header and returns the number of pieces stored at offset
+        inline int FileNumPieces(MEL::File &file, const MEL::Offset offset) {
+            char header[FILE_COLLECTIVE_HEADER];
+            MEL::FileReadAtAll(file, offset, header, FILE_COLLECTIVE_HEADER, MEL::Datatype::CHAR);
+            if (memcmp(header, "MELDEEPA", 8) != 0) MEL::Exit(-1, "MEL::Deep::FileReadAll : No collective deep file header at offset.");
+            long long numPieces;
+            memcpy(&numPieces, header + 8, sizeof(long long));
+            return (int) numPieces;
+        };
 
-            Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
-            msg. template packRootSTL<T, F>(obj);
+        // Reads pieces [begin, end), returns a buffer allocated with MEL::MemAlloc and fills the index entries. A process's run of 
+        // pieces may exceed 2 GiB in total, so it is read in FILE_COLLECTIVE_CHUNK sized collective reads, as many as comm needs
+        inline char* FileReadAllPieces(MEL::File &file, const MEL::Offset offset, const int begin, const int end, std::vector<FileCollectiveEntry> &entries, const Comm &comm) {
+            entries.resize(std::max(1, end - begin));
+            const int num = end - begin;
+            MEL::FileReadAtAll(file, offset + FILE_COLLECTIVE_HEADER + (MEL::Offset) begin * sizeof(FileCollectiveEntry), &entries[0], num * sizeof(FileCollectiveEntry), MEL::Datatype::CHAR);
+            entries.resize(num);
+            for (const auto &entry : entries) {
+                if (entry.size < 0 || entry.size > INT_MAX) MEL::Exit(-1, "MEL::Deep::FileReadAll : Piece size in the index is not a valid packed size.");
+            }
 
-            MEL::MemFree(buffer);
+            const long long bytes = (num > 0) ? ((entries[num - 1].offset + entries[num - 1].size) - entries[0].offset) : 0;
+            const MEL::Offset start = (num > 0) ? entries[0].offset : offset;
+            char *buffer = MEL::MemAlloc<char>(std::max(1ll, bytes));
+
+            long long chunks = (bytes + FILE_COLLECTIVE_CHUNK - 1) / FILE_COLLECTIVE_CHUNK, rounds = 0;
+            MEL::Allreduce(&chunks, &rounds, 1, MEL::Datatype::LONG_LONG, MEL::Op::MAX, comm);
+            for (long long i = 0; i < std::max(1ll, rounds); ++i) {
+                const long long done = std::min(bytes, i * FILE_COLLECTIVE_CHUNK), 
+                                len  = std::min(bytes - done, FILE_COLLECTIVE_CHUNK);
+                MEL::FileReadAtAll(file, start + done, buffer + done, (int) len, MEL::Datatype::CHAR);
+            }
+            return buffer;
         };
 
         /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
         // Object
 
         TEMPLATE_T
-        inline enable_if_not_pointer_not_stl<T> FileRead(T &obj, MEL::File &file) {
-            Message<TransportFileRead, HASH_MAP> msg(file);
+        inline enable_if_deep_not_pointer_not_stl<T, MEL::Offset> FileWriteAll(T &obj, MEL::File &file, const Comm &comm, const MEL::Offset offset = 0) {
+            const int bufferSize = MEL::Deep::BufferSize(obj);
+            char *buffer = MEL::MemAlloc<char>(bufferSize);
+            Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
             msg.packRootVar(obj);
+
+            const MEL::Offset written = FileWriteAllPieces(buffer, msg.getOffset(), file, comm, offset);
+            MEL::MemFree(buffer);
+            return written;
         };
 
-        TEMPLATE_T_F(TransportFileRead)
-        inline enable_if_not_pointer_not_stl<T> FileRead(T &obj, MEL::File &file) {
-            Message<TransportFileRead, HASH_MAP> msg(file);
+        TEMPLATE_T_F(TransportBufferWrite)
+        inline enable_if_not_pointer_not_stl<T, MEL::Offset> FileWriteAll(T &obj, MEL::File &file, const Comm &comm, const MEL::Offset offset = 0) {
+            const int bufferSize = MEL::Deep::BufferSize<T, HASH_MAP, F>(obj);
+            char *buffer = MEL::MemAlloc<char>(bufferSize);
+            Message<TransportBufferWrite, HASH_MAP> msg(buffer, bufferSize);
             msg. template packRootVar<T, F>(obj);
+
+            const MEL::Offset written = FileWriteAllPieces(buffer, msg.getOffset(), file, comm, offset);
+            MEL::MemFree(buffer);
+            return written;
         };
 
+        // Read back the piece written by the process with the same rank. The file must have been written by as many processes as comm holds
         TEMPLATE_T
-        inline enable_if_deep_not_pointer_not_stl<T> BufferedFileRead(T &obj, MEL::File &file) {
-            int bufferSize;
-            char *buffer = nullptr;
-            MEL::Deep::FileRead(buffer, bufferSize, file);
+        inline enable_if_deep_not_pointer_not_stl<T> FileReadAll(T &obj, MEL::File &file, const Comm &comm, const MEL::Offset offset = 0) {
+            const int rank = MEL::CommRank(comm);
+            if (FileNumPieces(file, offset) != MEL::CommSize(comm)) MEL::Exit(-1, "MEL::Deep::FileReadAll(obj) number of pieces does not match comm size, read into a std::vector instead.");
 
-            Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
+            std::vector<FileCollectiveEntry> entries;
+            char *buffer = FileReadAllPieces(file, offset, rank, rank + 1, entries, comm);
+            Message<TransportBufferRead, HASH_MAP> msg(buffer, (int) entries[0].size);
             msg.packRootVar(obj);
-
             MEL::MemFree(buffer);
         };
 
         TEMPLATE_T_F(TransportBufferRead)
-        inline enable_if_not_pointer_not_stl<T> BufferedFileRead(T &obj, MEL::File &file) {
-            int bufferSize;
-            char *buffer = nullptr;
-            MEL::Deep::FileRead(buffer, bufferSize, file);
+        inline enable_if_not_pointer_not_stl<T> FileReadAll(T &obj, MEL::File &file, const Comm &comm, const MEL::Offset offset = 0) {
+            const int rank = MEL::CommRank(comm);
+            if (FileNumPieces(file, offset) != MEL::CommSize(comm)) MEL::Exit(-1, "MEL::Deep::FileReadAll(obj) number of pieces does not match comm size, read into a std::vector instead.");
 
-            Message<TransportBufferRead, HASH_MAP> msg(buffer, bufferSize);
+            std::vector<FileCollectiveEntry> entries;
+            char *buffer = FileReadAllPieces(file, offset, rank, rank + 1, entries, comm);
+            Message<TransportBufferRead, HASH_MAP> msg(buffer, (int) entries[0].size);
             msg. template packRootVar<T, F>(obj);
+            MEL::MemFree(buffer);
+        };
+
+        // Read the pieces of a file written by any number of processes. The pieces are block distributed over comm in rank order,
+        // so each process receives a contiguous run of zero or more objects
+        TEMPLATE_T
+        inline enable_if_deep_not_pointer_not_stl<T> FileReadAll(std::vector<T> &objs, MEL::File &file, const Comm &comm, const MEL::Offset offset = 0) {
+            const int rank = MEL::CommRank(comm), size = MEL::CommSize(comm), numPieces = FileNumPieces(file, offset);
+            const int begin = (int) (((long long) numPieces * rank) / size), end = (int) (((long long) numPieces * (rank + 1)) / size);
+
+            std::vector<FileCollectiveEntry> entries;
+            char *buffer = FileReadAllPieces(file, offset, begin, end, entries, comm);
+            objs.resize(end - begin);
+            for (int i = 0; i < (end - begin); ++i) {
+                Message<TransportBufferRead, HASH_MAP> msg(buffer + (entries[i].offset - entries[0].offset), (int) entries[i].size);
+                msg.packRootVar(objs[i]);
+            }
+            MEL::MemFree(buffer);
+        };
 
+        TEMPLATE_T_F(TransportBufferRead)
+        inline enable_if_not_pointer_not_stl<T> FileReadAll(std::vector<T> &objs, MEL::File &file, const Comm &comm, const MEL::Offset offset = 0) {
+            const int rank = MEL::CommRank(comm), size = MEL::CommSize(comm), numPieces = FileNumPieces(file, offset);
+            const int begin = (int) (((long long) numPieces * rank) / size), end = (int) (((long long) numPieces * (rank + 1)) / size);
+
+            std::vector<FileCollectiveEntry> entries;
+            char *buffer = FileReadAllPieces(file, offset, begin, end, entries, comm);
+            objs.resize(end - begin);
+            for (int i = 0; i < (end - begin); ++i) {
+                Message<TransportBufferRead, HASH_MAP> msg(buffer + (entries[i].offset - entries[0].offset), (int) entries[i].size);
+                msg. template packRootVar<T, F>(objs[i]);
+            }
             MEL::MemFree(buffer);
         };
 
@@ -2600,6 +5941,432 @@ namespace MEL {
             MEL::MemFree(buffer);
         };
 
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Packed Messages
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        // The packed bytes of one deep object. Pack walks the object once, after which the same bytes can be sent, broadcast or 
+        // written to file any number of times, and Unpack rebuilds the object from them. They are the bytes a buffered transfer 
+        // carries, so a PackedMessage can be received with BufferedRecv / BufferedBcast / BufferedFileRead, and one received 
+        // with Recv / Bcast / FileRead can come from the buffered sending functions. When compression is enabled the compressed 
+        // frame is made on first use and kept until the message is packed again
+        class PackedMessage {
+        private:
+            /// Members
+            char *buffer, *frame;
+            int  size, capacity, frameSize;
+
+            inline void releaseFrame() {
+                MEL::MemFree(frame);
+                frame     = nullptr;
+                frameSize = 0;
+            };
+
+        public:
+            PackedMessage() : buffer(nullptr), frame(nullptr), size(0), capacity(0), frameSize(0) {};
+            ~PackedMessage() {
+                release();
+            };
+
+            PackedMessage(const PackedMessage &)            = delete;
+            PackedMessage& operator=(const PackedMessage &) = delete;
+
+            PackedMessage(PackedMessage &&old) : buffer(old.buffer), frame(old.frame), size(old.size), capacity(old.capacity), frameSize(old.frameSize) {
+                old.buffer = old.frame = nullptr;
+                old.size   = old.capacity = old.frameSize = 0;
+            };
+
+            PackedMessage& operator=(PackedMessage &&old) {
+                if (this != &old) {
+                    release();
+                    std::swap(buffer, old.buffer);
+                    std::swap(frame, old.frame);
+                    std::swap(size, old.size);
+                    std::swap(capacity, old.capacity);
+                    std::swap(frameSize, old.frameSize);
+                }
+                return *this;
+            };
+
+            inline char* data() {
+                return buffer;
+            };
+
+            inline int getSize() const {
+                return size;
+            };
+
+            inline bool empty() const {
+                return size == 0;
+            };
+
+            // Make room for len bytes, keeping the current allocation when it is already large enough. Contents are not kept
+            inline char* resize(const int len) {
+                releaseFrame();
+                if (len > capacity) {
+                    MEL::MemFree(buffer);
+                    buffer   = MEL::MemAlloc<char>(len);
+                    capacity = len;
+                }
+                size = len;
+                return buffer;
+            };
+
+            // Take ownership of len bytes allocated with MEL::MemAlloc
+            inline void adopt(char *_buffer, const int len) {
+                release();
+                buffer = _buffer;
+                size   = capacity = len;
+            };
+
+            // The bytes to put on the wire, the compressed frame when compression is enabled
+            inline char* wire(int &len) {
+                if (!GetCompressionConfig().enabled) {
+                    len = size;
+                    return buffer;
+                }
+                if (frame == nullptr) frame = CompressBuffer(buffer, size, frameSize);
+                len = frameSize;
+                return frame;
+            };
+
+            inline void release() {
+                releaseFrame();
+                MEL::MemFree(buffer);
+                buffer = nullptr;
+                size   = capacity = 0;
+            };
+        };
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Pointer / Length
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> Pack(P &ptr, int const &len, PackedMessage &packed) {
+            const int bufferSize = MEL::Deep::BufferSize(ptr, len);
+            Message<TransportBufferWrite, HASH_MAP> msg(packed.resize(bufferSize), bufferSize);
+            msg.packRootVar(len);
+            msg.packRootPtr(ptr, len);
+        };
+
+        TEMPLATE_P_F(TransportBufferWrite)
+        inline enable_if_pointer<P> Pack(P &ptr, int const &len, PackedMessage &packed) {
+            typedef typename std::remove_pointer<P>::type T;
+            const int bufferSize = MEL::Deep::BufferSize<P, HASH_MAP, F>(ptr, len);
+            Message<TransportBufferWrite, HASH_MAP> msg(packed.resize(bufferSize), bufferSize);
+            msg.packRootVar(len);
+            msg. template packRootPtr<T, F>(ptr, len);
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> Unpack(P &ptr, int &len, PackedMessage &packed) {
+            Message<TransportBufferRead, HASH_MAP> msg(packed.data(), packed.getSize());
+            msg.packRootVar(len);
+            msg.packRootPtr(ptr, len);
+        };
+
+        TEMPLATE_P_F(TransportBufferRead)
+        inline enable_if_pointer<P> Unpack(P &ptr, int &len, PackedMessage &packed) {
+            typedef typename std::remove_pointer<P>::type T;
+            Message<TransportBufferRead, HASH_MAP> msg(packed.data(), packed.getSize());
+            msg.packRootVar(len);
+            msg. template packRootPtr<T, F>(ptr, len);
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> Unpack(P &ptr, int const &len, PackedMessage &packed) {
+            Message<TransportBufferRead, HASH_MAP> msg(packed.data(), packed.getSize());
+            int _len = len;
+            msg.packRootVar(_len);
+            if (len != _len) MEL::Exit(-1, "MEL::Deep::Unpack(ptr, len) const int len provided does not match packed message size.");
+            msg.packRootPtr(ptr, _len);
+        };
+
+        TEMPLATE_P_F(TransportBufferRead)
+        inline enable_if_pointer<P> Unpack(P &ptr, int const &len, PackedMessage &packed) {
+            typedef typename std::remove_pointer<P>::type T;
+            Message<TransportBufferRead, HASH_MAP> msg(packed.data(), packed.getSize());
+            int _len = len;
+            msg.packRootVar(_len);
+            if (len != _len) MEL::Exit(-1, "MEL::Deep::Unpack(ptr, len) const int len provided does not match packed message size.");
+            msg. template packRootPtr<T, F>(ptr, _len);
+        };
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Pointer
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> Pack(P &ptr, PackedMessage &packed) {
+            const int bufferSize = MEL::Deep::BufferSize(ptr);
+            Message<TransportBufferWrite, HASH_MAP> msg(packed.resize(bufferSize), bufferSize);
+            msg.packRootPtr(ptr);
+        };
+
+        TEMPLATE_P_F(TransportBufferWrite)
+        inline enable_if_pointer<P> Pack(P &ptr, PackedMessage &packed) {
+            typedef typename std::remove_pointer<P>::type T;
+            const int bufferSize = MEL::Deep::BufferSize<P, HASH_MAP, F>(ptr);
+            Message<TransportBufferWrite, HASH_MAP> msg(packed.resize(bufferSize), bufferSize);
+            msg. template packRootPtr<T, F>(ptr);
+        };
+
+        TEMPLATE_P
+        inline enable_if_pointer<P> Unpack(P &ptr, PackedMessage &packed) {
+            Message<TransportBufferRead, HASH_MAP> msg(packed.data(), packed.getSize());
+            msg.packRootPtr(ptr);
+        };
+
+        TEMPLATE_P_F(TransportBufferRead)
+        inline enable_if_pointer<P> Unpack(P &ptr, PackedMessage &packed) {
+            typedef typename std::remove_pointer<P>::type T;
+            Message<TransportBufferRead, HASH_MAP> msg(packed.data(), packed.getSize());
+            msg. template packRootPtr<T, F>(ptr);
+        };
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // STL
+
+        TEMPLATE_STL
+        inline enable_if_stl<S> Pack(S &obj, PackedMessage &packed) {
+            const int bufferSize = MEL::Deep::BufferSize(obj);
+            Message<TransportBufferWrite, HASH_MAP> msg(packed.resize(bufferSize), bufferSize);
+            msg.packRootSTL(obj);
+        };
+
+        TEMPLATE_STL_F(TransportBufferWrite)
+        inline enable_if_stl<S> Pack(S &obj, PackedMessage &packed) {
+            typedef typename S::value_type T;
+            const int bufferSize = MEL::Deep::BufferSize<S, HASH_MAP, F>(obj);
+            Message<TransportBufferWrite, HASH_MAP> msg(packed.resize(bufferSize), bufferSize);
+            msg. template packRootSTL<T, F>(obj);
+        };
+
+        TEMPLATE_STL
+        inline enable_if_stl<S> Unpack(S &obj, PackedMessage &packed) {
+            Message<TransportBufferRead, HASH_MAP> msg(packed.data(), packed.getSize());
+            msg.packRootSTL(obj);
+        };
+
+        TEMPLATE_STL_F(TransportBufferRead)
+        inline enable_if_stl<S> Unpack(S &obj, PackedMessage &packed) {
+            typedef typename S::value_type T;
+            Message<TransportBufferRead, HASH_MAP> msg(packed.data(), packed.getSize());
+            msg. template packRootSTL<T, F>(obj);
+        };
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Object
+
+        TEMPLATE_T
+        inline enable_if_deep_not_pointer_not_stl<T> Pack(T &obj, PackedMessage &packed) {
+            const int bufferSize = MEL::Deep::BufferSize(obj);
+            Message<TransportBufferWrite, HASH_MAP> msg(packed.resize(bufferSize), bufferSize);
+            msg.packRootVar(obj);
+        };
+
+        TEMPLATE_T_F(TransportBufferWrite)
+        inline enable_if_not_pointer_not_stl<T> Pack(T &obj, PackedMessage &packed) {
+            const int bufferSize = MEL::Deep::BufferSize<T, HASH_MAP, F>(obj);
+            Message<TransportBufferWrite, HASH_MAP> msg(packed.resize(bufferSize), bufferSize);
+            msg. template packRootVar<T, F>(obj);
+        };
+
+        TEMPLATE_T
+        inline enable_if_deep_not_pointer_not_stl<T> Unpack(T &obj, PackedMessage &packed) {
+            Message<TransportBufferRead, HASH_MAP> msg(packed.data(), packed.getSize());
+            msg.packRootVar(obj);
+        };
+
+        TEMPLATE_T_F(TransportBufferRead)
+        inline enable_if_not_pointer_not_stl<T> Unpack(T &obj, PackedMessage &packed) {
+            Message<TransportBufferRead, HASH_MAP> msg(packed.data(), packed.getSize());
+            msg. template packRootVar<T, F>(obj);
+        };
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Transfers
+
+        inline void Send(PackedMessage &packed, const int dst, const int tag, const Comm &comm) {
+            int len;
+            char *ptr = packed.wire(len);
+            MEL::Deep::Send(ptr, (int const &) len, dst, tag, comm);
+        };
+
+        inline void Recv(PackedMessage &packed, const int src, const int tag, const Comm &comm) {
+            int len;
+            char *buffer = nullptr;
+            MEL::Deep::RecvBuffer(buffer, len, src, tag, comm);
+            packed.adopt(buffer, len);
+        };
+
+        inline MEL::Status RecvAny(PackedMessage &packed, const int tag, const Comm &comm) {
+            int len;
+            char *buffer = nullptr;
+            MEL::Status status = MEL::Deep::RecvBuffer(buffer, len, MEL::ANY_SOURCE, tag, comm);
+            packed.adopt(buffer, len);
+            return status;
+        };
+
+        // The root broadcasts the message it holds, every other process receives into packed
+        inline void Bcast(PackedMessage &packed, const int root, const Comm &comm) {
+            if (MEL::CommRank(comm) == root) {
+                int len;
+                char *ptr = packed.wire(len);
+                MEL::Deep::Bcast(ptr, (int const &) len, root, comm);
+            }
+            else {
+                int len;
+                char *buffer = nullptr;
+                MEL::Deep::BcastBuffer(buffer, len, root, comm);
+                packed.adopt(buffer, len);
+            }
+        };
+
+#ifdef MEL_3
+        inline void HierarchicalBcast(PackedMessage &packed, const int root, const Comm &comm) {
+            if (MEL::CommRank(comm) == root) {
+                int len;
+                char *ptr = packed.wire(len);
+                MEL::Deep::HierarchicalBcast(ptr, (int const &) len, root, comm);
+            }
+            else {
+                int len;
+                char *buffer = nullptr;
+                MEL::Deep::HierarchicalBcastBuffer(buffer, len, root, comm);
+                packed.adopt(buffer, len);
+            }
+        };
+#endif
+
+        // Files always hold the uncompressed bytes, as BufferedFileWrite writes them
+        inline void FileWrite(PackedMessage &packed, MEL::File &file) {
+            char *ptr = packed.data();
+            MEL::Deep::FileWrite(ptr, (int const &) packed.getSize(), file);
+        };
+
+        inline void FileRead(PackedMessage &packed, MEL::File &file) {
+            int len;
+            char *buffer = nullptr;
+            MEL::Deep::FileRead(buffer, len, file);
+            packed.adopt(buffer, len);
+        };
+
+        inline void FileWrite(PackedMessage &packed, std::ofstream &file) {
+            char *ptr = packed.data();
+            MEL::Deep::FileWrite(ptr, (int const &) packed.getSize(), file);
+        };
+
+        inline void FileRead(PackedMessage &packed, std::ifstream &file) {
+            int len;
+            char *buffer = nullptr;
+            MEL::Deep::FileRead(buffer, len, file);
+            packed.adopt(buffer, len);
+        };
+
+        // Writes packed as this process's piece of a collective file, read back with FileReadAll
+        inline MEL::Offset FileWriteAll(PackedMessage &packed, MEL::File &file, const Comm &comm, const MEL::Offset offset = 0) {
+            return FileWriteAllPieces(packed.data(), packed.getSize(), file, comm, offset);
+        };
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Reduce
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        // Reductions of deep objects or STL containers with a user merge function, called as merge(T &into, T &from) to fold from 
+        // into into. Partial results travel as buffered deep messages with tag, so no other message with that tag may be in flight 
+        // on comm. Every process packs, sends and merges O(log P) partials rather than root merging all P. from is a freshly 
+        // received object that merge may move from, memory it owns through raw pointers is not freed after the call
+
+        static constexpr int DEEP_REDUCE_TAG = 32767;
+
+        template<typename T, typename R = void>
+        using enable_if_reducible = typename std::enable_if<(HasDeepCopyMethod<T>::Has || is_stl<T>::value) && !std::is_pointer<T>::value, R>::type;
+
+        // Swap packed messages with partner. Both sides send before they wait, so neither blocks on the other
+        inline void ExchangeBuffer(PackedMessage &out, PackedMessage &in, const int partner, const int tag, const Comm &comm) {
+            int sendLen, recvLen;
+            char *wire = out.wire(sendLen);
+
+            MEL::Request rqs[2];
+            rqs[0] = MEL::Isend(&sendLen, 1, partner, tag, comm);
+            MEL::Recv(&recvLen, 1, partner, tag, comm);
+            rqs[1] = MEL::Isend(wire, sendLen, partner, tag, comm);
+
+            char *frame = MEL::MemAlloc<char>(std::max(1, recvLen));
+            MEL::Recv(frame, recvLen, partner, tag, comm);
+            MEL::Waitall(rqs, 2);
+
+            if (!GetCompressionConfig().enabled) {
+                in.adopt(frame, recvLen);
+                return;
+            }
+            int len;
+            char *buffer = DecompressBuffer(frame, recvLen, len);
+            MEL::MemFree(frame);
+            in.adopt(buffer, len);
+        };
+
+        // Binomial tree reduction onto root. Partials are merged in rank order relative to root, so merge need not commute. 
+        // obj holds the result on root, other processes are left with a partial result
+        template<typename T, typename MERGE>
+        inline enable_if_reducible<T> Reduce(T &obj, MERGE merge, const int root, const Comm &comm, const int tag = DEEP_REDUCE_TAG) {
+            const int rank = MEL::CommRank(comm), size = MEL::CommSize(comm), rel = (rank - root + size) % size;
+
+            PackedMessage packed;
+            for (int mask = 1; mask < size; mask <<= 1) {
+                if (rel & mask) {
+                    MEL::Deep::Pack(obj, packed);
+                    MEL::Deep::Send(packed, (rel - mask + root) % size, tag, comm);
+                    return;
+                }
+                if ((rel + mask) < size) {
+                    MEL::Deep::Recv(packed, (rel + mask + root) % size, tag, comm);
+                    T partial;
+                    MEL::Deep::Unpack(partial, packed);
+                    merge(obj, partial);
+                }
+            }
+        };
+
+        // Recursive doubling, every process finishes with the result in obj after log2(P) exchanges. When P is not a power of two 
+        // the processes beyond the largest power of two first fold into a partner and are sent the result at the end. merge must 
+        // be commutative as well as associative, partners merge each other's partials in opposite order
+        template<typename T, typename MERGE>
+        inline enable_if_reducible<T> Allreduce(T &obj, MERGE merge, const Comm &comm, const int tag = DEEP_REDUCE_TAG) {
+            const int rank = MEL::CommRank(comm), size = MEL::CommSize(comm);
+            int pow2 = 1;
+            while ((pow2 << 1) <= size) pow2 <<= 1;
+
+            PackedMessage packed, partialPacked;
+            if (rank >= pow2) {
+                MEL::Deep::Pack(obj, packed);
+                MEL::Deep::Send(packed, rank - pow2, tag, comm);
+                MEL::Deep::Recv(packed, rank - pow2, tag, comm);
+                MEL::Deep::Unpack(obj, packed);
+                return;
+            }
+
+            if ((rank + pow2) < size) {
+                MEL::Deep::Recv(partialPacked, rank + pow2, tag, comm);
+                T partial;
+                MEL::Deep::Unpack(partial, partialPacked);
+                merge(obj, partial);
+            }
+
+            for (int mask = 1; mask < pow2; mask <<= 1) {
+                MEL::Deep::Pack(obj, packed);
+                ExchangeBuffer(packed, partialPacked, rank ^ mask, tag, comm);
+                T partial;
+                MEL::Deep::Unpack(partial, partialPacked);
+                merge(obj, partial);
+            }
+
+            if ((rank + pow2) < size) {
+                MEL::Deep::Pack(obj, packed);
+                MEL::Deep::Send(packed, rank + pow2, tag, comm);
+            }
+        };
+
 #undef TEMPLATE_STL
 #undef TEMPLATE_T
 #undef TEMPLATE_P
@@ -2611,5 +6378,20 @@ namespace MEL {
 #undef TEMPLATE_STL_F2
 #undef TEMPLATE_T_F2
 #undef TEMPLATE_P_F2
+
+#undef TEMPLATE_STL_F_ARENA
+#undef TEMPLATE_T_F_ARENA
+#undef TEMPLATE_P_F_ARENA
+#undef TEMPLATE_STL_F2_ARENA
+#undef TEMPLATE_T_F2_ARENA
+#undef TEMPLATE_P_F2_ARENA
+
+#undef TEMPLATE_VIA_STL
+#undef TEMPLATE_VIA_T
+#undef TEMPLATE_VIA_P
+
+#undef TEMPLATE_VIA_STL_F2
+#undef TEMPLATE_VIA_T_F2
+#undef TEMPLATE_VIA_P_F2
     };
 };
\ No newline at end of file
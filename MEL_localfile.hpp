@@ -0,0 +1,508 @@
+/*
+The MIT License(MIT)
+
+Copyright(c) 2016 Joss Whittle
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "MEL.hpp"
+#include "MEL_deepcopy.hpp"
+
+#if !defined(__unix__) && !defined(__APPLE__)
+#error "MEL_localfile.hpp requires a POSIX system"
+#endif
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace MEL {
+    namespace Deep {
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Local File
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        // Settings for LocalFile. Data is staged in queueDepth blocks of blockSize bytes, aligned in memory and in the file so the
+        // file can be opened with O_DIRECT (bypassing the page cache) where the file system supports it. Writes are issued by a
+        // background thread while the caller keeps packing, and runs of queued blocks go out in one pwritev. Reads fetch up to
+        // queueDepth blocks per preadv. blockSize is rounded up to a multiple of alignment
+        struct LocalFileConfig {
+            int  blockSize, queueDepth, alignment;
+            bool direct;
+
+            LocalFileConfig() : blockSize(1 << 20), queueDepth(8), alignment(4096), direct(true) {};
+        };
+
+        inline LocalFileConfig& GetLocalFileConfig() {
+            static LocalFileConfig config;
+            return config;
+        };
+
+        // A node-local file written or read sequentially by one process, used in place of std::ofstream / std::ifstream for
+        // large deep dumps to local scratch. Not thread safe, and a file is either written or read for its whole lifetime
+        class LocalFile {
+        public:
+            enum class Mode { WRITE, READ };
+
+        private:
+            struct Block {
+                char      *data;
+                long long offset;
+                int       size;
+                bool      queued;
+            };
+
+            /// Members
+            Mode               mode;
+            int                fd;
+            bool               direct;
+            int                blockSize, alignment;
+            long long          position, fileSize;
+            std::vector<Block> blocks;
+            int                current;
+
+            /// Write behind
+            std::thread             worker;
+            std::mutex              mutex;
+            std::condition_variable cond;
+            std::deque<int>         queue;
+            bool                    stop;
+            int                     error;
+
+            /// Read ahead
+            int       readBegin, readEnd, readCount;
+            long long readOffset;
+
+            inline void fail(const char *what, const int err) {
+                MEL::Abort(err, std::string("LocalFile : ") + what + " failed with errno " + std::to_string(err) + "...");
+            };
+
+            inline int padded(const int size) const {
+                return direct ? ((size + alignment - 1) / alignment) * alignment : size;
+            };
+
+            // Write the blocks in q to the file, one pwritev per run of consecutive offsets
+            inline int writeBlocks(const std::vector<int> &q) {
+                std::vector<struct iovec> iov;
+                size_t i = 0;
+                while (i < q.size()) {
+                    const long long offset = blocks[q[i]].offset;
+                    long long bytes = 0;
+                    iov.clear();
+                    while (i < q.size() && (int) iov.size() < IOV_MAX && blocks[q[i]].offset == offset + bytes) {
+                        const int size = padded(blocks[q[i]].size);
+                        iov.push_back({ blocks[q[i]].data, (size_t) size });
+                        bytes += size;
+                        ++i;
+                    }
+
+                    size_t done = 0, first = 0;
+                    while (done < (size_t) bytes) {
+                        const ssize_t n = pwritev(fd, &iov[first], (int) (iov.size() - first), offset + done);
+                        if (n < 0) {
+                            if (errno == EINTR) continue;
+                            return errno;
+                        }
+                        done += n;
+                        /// Resume a short write from the first partly written block
+                        size_t skip = n;
+                        while (first < iov.size() && skip >= iov[first].iov_len) skip -= iov[first++].iov_len;
+                        if (first < iov.size()) {
+                            iov[first].iov_base = (char*) iov[first].iov_base + skip;
+                            iov[first].iov_len -= skip;
+                        }
+                    }
+                }
+                return 0;
+            };
+
+            inline void run() {
+                std::vector<int> q;
+                while (true) {
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        cond.wait(lock, [this] { return stop || !queue.empty(); });
+                        if (queue.empty()) return;
+                        q.assign(queue.begin(), queue.end());
+                        queue.clear();
+                    }
+                    const int err = writeBlocks(q);
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        for (const int b : q) blocks[b].queued = false;
+                        if (err != 0 && error == 0) error = err;
+                    }
+                    cond.notify_all();
+                }
+            };
+
+            // Hand the current block to the writer and wait for the next one in the ring to be free
+            inline void submit() {
+                std::unique_lock<std::mutex> lock(mutex);
+                blocks[current].queued = true;
+                queue.push_back(current);
+                cond.notify_all();
+
+                current = (current + 1) % (int) blocks.size();
+                cond.wait(lock, [this] { return !blocks[current].queued; });
+                if (error != 0) fail("pwritev", error);
+                blocks[current].offset = position;
+                blocks[current].size   = 0;
+            };
+
+            inline void drain() {
+                std::unique_lock<std::mutex> lock(mutex);
+                cond.wait(lock, [this] { return queue.empty() && std::none_of(blocks.begin(), blocks.end(), [](const Block &b) { return b.queued; }); });
+                if (error != 0) fail("pwritev", error);
+            };
+
+            // Fetch the blocks following the read-ahead window in one preadv
+            inline void fill() {
+                const long long offset = readOffset + readCount;
+                /// At the end of the file the offset is no longer aligned for O_DIRECT, there is nothing left to fetch
+                if (offset >= fileSize) {
+                    readOffset = offset;
+                    readCount  = readBegin = readEnd = 0;
+                    return;
+                }
+                const int numBlocks = (int) blocks.size();
+                std::vector<struct iovec> iov(numBlocks);
+                for (int i = 0; i < numBlocks; ++i) iov[i] = { blocks[i].data, (size_t) blockSize };
+
+                ssize_t n;
+                do { n = preadv(fd, &iov[0], numBlocks, offset); } while (n < 0 && errno == EINTR);
+                if (n < 0) fail("preadv", errno);
+
+                readOffset = offset;
+                readCount  = (int) std::min<long long>(n, fileSize - offset);
+                readBegin  = 0;
+                readEnd    = readCount;
+            };
+
+            inline void open(const std::string &path) {
+                int flags = (mode == Mode::WRITE) ? (O_WRONLY | O_CREAT | O_TRUNC) : O_RDONLY;
+#ifdef O_DIRECT
+                if (direct) {
+                    fd = ::open(path.c_str(), flags | O_DIRECT, 0644);
+                    if (fd >= 0) return;
+                    /// File systems such as tmpfs reject O_DIRECT, fall back to buffered IO
+                    if (errno != EINVAL) fail(("open " + path).c_str(), errno);
+                }
+#endif
+                direct = false;
+                fd = ::open(path.c_str(), flags, 0644);
+                if (fd < 0) fail(("open " + path).c_str(), errno);
+            };
+
+        public:
+            LocalFile(const std::string &path, const Mode _mode) : mode(_mode), fd(-1), position(0), fileSize(0), current(0), stop(false), error(0),
+                                                                   readBegin(0), readEnd(0), readCount(0), readOffset(0) {
+                const LocalFileConfig &config = GetLocalFileConfig();
+                alignment = std::max(1, config.alignment);
+                blockSize = ((std::max(1, config.blockSize) + alignment - 1) / alignment) * alignment;
+                direct    = config.direct;
+                open(path);
+
+                blocks.resize(std::max(1, config.queueDepth));
+                for (auto &block : blocks) {
+                    void *data = nullptr;
+                    if (posix_memalign(&data, alignment, blockSize) != 0) fail("posix_memalign", ENOMEM);
+                    block = { (char*) data, 0, 0, false };
+                }
+
+                if (mode == Mode::WRITE) {
+                    worker = std::thread(&LocalFile::run, this);
+                }
+                else {
+                    struct stat st;
+                    if (fstat(fd, &st) != 0) fail("fstat", errno);
+                    fileSize = st.st_size;
+                }
+            };
+
+            ~LocalFile() {
+                close();
+            };
+
+            LocalFile(const LocalFile &)            = delete;
+            LocalFile& operator=(const LocalFile &) = delete;
+
+            inline void write(const void *ptr, const long long bytes) {
+                const char *src = (const char*) ptr;
+                long long num = bytes;
+                while (num > 0) {
+                    Block &block = blocks[current];
+                    const int n = (int) std::min<long long>(num, blockSize - block.size);
+                    memcpy(block.data + block.size, src, n);
+                    block.size += n;
+                    position   += n;
+                    src        += n;
+                    num        -= n;
+                    if (block.size == blockSize) submit();
+                }
+            };
+
+            // Returns the number of bytes read, less than bytes only at the end of the file
+            inline long long read(void *ptr, const long long bytes) {
+                char *dst = (char*) ptr;
+                long long num = bytes;
+                while (num > 0) {
+                    if (readBegin == readEnd) {
+                        fill();
+                        if (readCount == 0) break;
+                    }
+                    const int n = (int) std::min<long long>(num, readEnd - readBegin);
+                    /// The ring is not contiguous in memory, copy block by block
+                    int copied = 0;
+                    while (copied < n) {
+                        const int b = readBegin / blockSize, o = readBegin % blockSize;
+                        const int m = std::min(n - copied, blockSize - o);
+                        memcpy(dst + copied, blocks[b].data + o, m);
+                        copied    += m;
+                        readBegin += m;
+                    }
+                    position += n;
+                    dst      += n;
+                    num      -= n;
+                }
+                return bytes - num;
+            };
+
+            // Wait for every queued block, then write the partly filled block so the file holds everything written so far.
+            // The partial block stays in memory and is rewritten in full once it fills
+            inline void sync() {
+                if (fd < 0 || mode != Mode::WRITE) return;
+                drain();
+                Block &block = blocks[current];
+                if (block.size > 0) {
+                    /// O_DIRECT lengths must be aligned, the padding is truncated away below
+                    memset(block.data + block.size, 0, padded(block.size) - block.size);
+                    const int err = writeBlocks(std::vector<int>(1, current));
+                    if (err != 0) fail("pwritev", err);
+                }
+                if (direct && ftruncate(fd, position) != 0) fail("ftruncate", errno);
+            };
+
+            inline void close() {
+                if (fd < 0) return;
+                if (mode == Mode::WRITE) {
+                    sync();
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        stop = true;
+                    }
+                    cond.notify_all();
+                    worker.join();
+                }
+                ::close(fd);
+                fd = -1;
+                for (auto &block : blocks) free(block.data);
+                blocks.clear();
+            };
+
+            inline bool isDirect() const {
+                return direct;
+            };
+
+            // Number of bytes written or read so far
+            inline long long getPosition() const {
+                return position;
+            };
+        };
+
+        class TransportLocalFileWrite {
+        private:
+            /// Members
+            LocalFile *file;
+
+        public:
+            static constexpr bool SOURCE = true;
+
+            TransportLocalFileWrite(LocalFile &_file) : file(&_file) {};
+
+            template<typename T>
+            inline void transport(T *&ptr, const int len) {
+                file->write(ptr, (long long) len * sizeof(T));
+            };
+        };
+
+        class TransportLocalFileRead {
+        private:
+            /// Members
+            LocalFile *file;
+
+        public:
+            static constexpr bool SOURCE = false;
+
+            TransportLocalFileRead(LocalFile &_file) : file(&_file) {};
+
+            template<typename T>
+            inline void transport(T *&ptr, const int len) {
+                const long long num = (long long) len * sizeof(T);
+                if (file->read(ptr, num) != num) MEL::Abort(-1, "TransportLocalFileRead : Unexpected end of file...");
+            };
+        };
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Local File Write
+
+        template<typename P, typename HASH_MAP = MEL::Deep::PointerHashMap>
+        inline enable_if_pointer<P> FileWrite(P &ptr, int const &len, LocalFile &file) {
+            Message<TransportLocalFileWrite, HASH_MAP> msg(file);
+            msg.packRootVar(len);
+            msg.packRootPtr(ptr, len);
+        };
+
+        template<typename P, typename HASH_MAP, DEEP_FUNCTOR<typename std::remove_pointer<P>::type, TransportLocalFileWrite, HASH_MAP> F>
+        inline enable_if_pointer<P> FileWrite(P &ptr, int const &len, LocalFile &file) {
+            typedef typename std::remove_pointer<P>::type T;
+            Message<TransportLocalFileWrite, HASH_MAP> msg(file);
+            msg.packRootVar(len);
+            msg. template packRootPtr<T, F>(ptr, len);
+        };
+
+        template<typename P, typename HASH_MAP = MEL::Deep::PointerHashMap>
+        inline enable_if_pointer<P> FileWrite(P &ptr, LocalFile &file) {
+            Message<TransportLocalFileWrite, HASH_MAP> msg(file);
+            msg.packRootPtr(ptr);
+        };
+
+        template<typename P, typename HASH_MAP, DEEP_FUNCTOR<typename std::remove_pointer<P>::type, TransportLocalFileWrite, HASH_MAP> F>
+        inline enable_if_pointer<P> FileWrite(P &ptr, LocalFile &file) {
+            typedef typename std::remove_pointer<P>::type T;
+            Message<TransportLocalFileWrite, HASH_MAP> msg(file);
+            msg. template packRootPtr<T, F>(ptr);
+        };
+
+        template<typename S, typename HASH_MAP = MEL::Deep::PointerHashMap>
+        inline enable_if_stl<S> FileWrite(S &obj, LocalFile &file) {
+            Message<TransportLocalFileWrite, HASH_MAP> msg(file);
+            msg.packRootSTL(obj);
+        };
+
+        template<typename S, typename HASH_MAP, DEEP_FUNCTOR<typename S::value_type, TransportLocalFileWrite, HASH_MAP> F>
+        inline enable_if_stl<S> FileWrite(S &obj, LocalFile &file) {
+            typedef typename S::value_type T;
+            Message<TransportLocalFileWrite, HASH_MAP> msg(file);
+            msg. template packRootSTL<T, F>(obj);
+        };
+
+        template<typename T, typename HASH_MAP = MEL::Deep::PointerHashMap>
+        inline enable_if_not_pointer_not_stl<T> FileWrite(T &obj, LocalFile &file) {
+            Message<TransportLocalFileWrite, HASH_MAP> msg(file);
+            msg.packRootVar(obj);
+        };
+
+        template<typename T, typename HASH_MAP, DEEP_FUNCTOR<T, TransportLocalFileWrite, HASH_MAP> F>
+        inline enable_if_not_pointer_not_stl<T> FileWrite(T &obj, LocalFile &file) {
+            Message<TransportLocalFileWrite, HASH_MAP> msg(file);
+            msg. template packRootVar<T, F>(obj);
+        };
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Local File Read
+
+        template<typename P, typename HASH_MAP = MEL::Deep::PointerHashMap>
+        inline enable_if_pointer<P> FileRead(P &ptr, int const &len, LocalFile &file) {
+            Message<TransportLocalFileRead, HASH_MAP> msg(file);
+            int _len = len;
+            msg.packRootVar(_len);
+            if (len != _len) MEL::Exit(-1, "MEL::Deep::FileRead(ptr, len) const int len provided does not match incomming message size.");
+            msg.packRootPtr(ptr, _len);
+        };
+
+        template<typename P, typename HASH_MAP, DEEP_FUNCTOR<typename std::remove_pointer<P>::type, TransportLocalFileRead, HASH_MAP> F>
+        inline enable_if_pointer<P> FileRead(P &ptr, int const &len, LocalFile &file) {
+            typedef typename std::remove_pointer<P>::type T;
+            Message<TransportLocalFileRead, HASH_MAP> msg(file);
+            int _len = len;
+            msg.packRootVar(_len);
+            if (len != _len) MEL::Exit(-1, "MEL::Deep::FileRead(ptr, len) const int len provided does not match incomming message size.");
+            msg. template packRootPtr<T, F>(ptr, _len);
+        };
+
+        template<typename P, typename HASH_MAP = MEL::Deep::PointerHashMap>
+        inline enable_if_pointer<P> FileRead(P &ptr, int &len, LocalFile &file) {
+            Message<TransportLocalFileRead, HASH_MAP> msg(file);
+            msg.packRootVar(len);
+            msg.packRootPtr(ptr, len);
+        };
+
+        template<typename P, typename HASH_MAP, DEEP_FUNCTOR<typename std::remove_pointer<P>::type, TransportLocalFileRead, HASH_MAP> F>
+        inline enable_if_pointer<P> FileRead(P &ptr, int &len, LocalFile &file) {
+            typedef typename std::remove_pointer<P>::type T;
+            Message<TransportLocalFileRead, HASH_MAP> msg(file);
+            msg.packRootVar(len);
+            msg. template packRootPtr<T, F>(ptr, len);
+        };
+
+        template<typename P, typename HASH_MAP = MEL::Deep::PointerHashMap>
+        inline enable_if_pointer<P> FileRead(P &ptr, LocalFile &file) {
+            Message<TransportLocalFileRead, HASH_MAP> msg(file);
+            msg.packRootPtr(ptr);
+        };
+
+        template<typename P, typename HASH_MAP, DEEP_FUNCTOR<typename std::remove_pointer<P>::type, TransportLocalFileRead, HASH_MAP> F>
+        inline enable_if_pointer<P> FileRead(P &ptr, LocalFile &file) {
+            typedef typename std::remove_pointer<P>::type T;
+            Message<TransportLocalFileRead, HASH_MAP> msg(file);
+            msg. template packRootPtr<T, F>(ptr);
+        };
+
+        template<typename S, typename HASH_MAP = MEL::Deep::PointerHashMap>
+        inline enable_if_stl<S> FileRead(S &obj, LocalFile &file) {
+            Message<TransportLocalFileRead, HASH_MAP> msg(file);
+            msg.packRootSTL(obj);
+        };
+
+        template<typename S, typename HASH_MAP, DEEP_FUNCTOR<typename S::value_type, TransportLocalFileRead, HASH_MAP> F>
+        inline enable_if_stl<S> FileRead(S &obj, LocalFile &file) {
+            typedef typename S::value_type T;
+            Message<TransportLocalFileRead, HASH_MAP> msg(file);
+            msg. template packRootSTL<T, F>(obj);
+        };
+
+        template<typename T, typename HASH_MAP = MEL::Deep::PointerHashMap>
+        inline enable_if_not_pointer_not_stl<T> FileRead(T &obj, LocalFile &file) {
+            Message<TransportLocalFileRead, HASH_MAP> msg(file);
+            msg.packRootVar(obj);
+        };
+
+        template<typename T, typename HASH_MAP, DEEP_FUNCTOR<T, TransportLocalFileRead, HASH_MAP> F>
+        inline enable_if_not_pointer_not_stl<T> FileRead(T &obj, LocalFile &file) {
+            Message<TransportLocalFileRead, HASH_MAP> msg(file);
+            msg. template packRootVar<T, F>(obj);
+        };
+    };
+};
@@ -25,6 +25,13 @@ SOFTWARE.
 
 #include <omp.h>
 #include "MEL.hpp"
+#include "MEL_deepcopy.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
 
 /**
 * \file MEL_omp.hpp
@@ -38,11 +45,75 @@ namespace MEL {
          * Extensions to MEL that leverage OpenMP for within node paralellism
          */
 
+        /**
+         * \ingroup  OMP
+         * Thresholds used to pick how the local part of a reduction is executed. Arrays shorter than simdElements are 
+         * processed with a plain loop, arrays smaller than threadBytes with a single-threaded SIMD loop, and larger arrays 
+         * are split across the OpenMP thread team with at least chunkBytes per thread. The team is the OpenMP runtime's 
+         * persistent thread pool, it is only woken for arrays large enough to amortise the fork / join
+         */
+        struct ReduceConfig {
+            int simdElements;
+            int threadBytes;
+            int chunkBytes;
+            int maxThreads;
+
+            ReduceConfig() : simdElements(8), threadBytes(1 << 18), chunkBytes(1 << 16), maxThreads(omp_get_max_threads()) {};
+        };
+
+        /**
+         * \ingroup  OMP
+         * Access the process wide reduction thresholds. Modify the returned reference to tune them
+         *
+         * \return			Returns a reference to the ReduceConfig in use
+         */
+        inline ReduceConfig& GetReduceConfig() {
+            static ReduceConfig config;
+            return config;
+        };
+
+        /// \cond HIDE
+        enum class ReduceMode { SERIAL, SIMD, THREADED };
+
+        /// Never starts a nested team, callers already inside a parallel region reduce on their own thread
+        inline ReduceMode SelectReduceMode(const int len, const int elementSize, int &threads) {
+            const ReduceConfig &config = GetReduceConfig();
+            const long long bytes = (long long) len * elementSize;
+            threads = 1;
+
+            if (len < config.simdElements) return ReduceMode::SERIAL;
+            if (bytes < config.threadBytes || config.maxThreads < 2 || omp_in_parallel()) return ReduceMode::SIMD;
+
+            threads = (int) std::min<long long>(config.maxThreads, bytes / std::max(1, config.chunkBytes));
+            return (threads > 1) ? ReduceMode::THREADED : ReduceMode::SIMD;
+        };
+
+        /// Runs kernel(begin, end) over [0, len) with the selected execution mode
+        template<typename T, typename K>
+        inline void AdaptiveMap(const int len, K kernel) {
+            int threads;
+            switch (SelectReduceMode(len, sizeof(T), threads)) {
+            case ReduceMode::THREADED:
+                #pragma omp parallel num_threads(threads)
+                {
+                    const int tid = omp_get_thread_num(), nt = omp_get_num_threads();
+                    const int chunk = (len + nt - 1) / nt, begin = std::min(len, tid * chunk), end = std::min(len, begin + chunk);
+                    kernel(begin, end);
+                }
+                break;
+            default:
+                kernel(0, len);
+                break;
+            }
+        };
+        /// \endcond
+
         namespace Functor {
 
             /**
              * \ingroup  OMP
-             * Maps the given binary functor to the local array of a reduction / accumulate operation, using OpenMP for parallelism
+             * Maps the given binary functor to the local array of a reduction / accumulate operation. Small arrays are 
+             * processed serially, medium arrays with a SIMD loop, and large arrays across the OpenMP thread team
              *
              * \param[in] in		The left hand array for the reduction
              * \param[in] inout		The right hand array for the reduction. This array is modified to reflect the result of the functor on each element
@@ -51,14 +122,23 @@ namespace MEL {
              */
             template<typename T, T(*F)(T&, T&)>
             void ARRAY_OP_FUNC(T *in, T *inout, int *len, MPI_Datatype *dptr) {
-                #pragma omp parallel for
-                for (int i = 0; i < *len; ++i) 
-                    inout[i] = F(in[i], inout[i]);
+                const int n = *len;
+                if (n < GetReduceConfig().simdElements) {
+                    for (int i = 0; i < n; ++i) inout[i] = F(in[i], inout[i]);
+                    return;
+                }
+                AdaptiveMap<T>(n, [in, inout](const int begin, const int end) {
+                    T * __restrict a = in;
+                    T * __restrict b = inout;
+                    #pragma omp simd
+                    for (int i = begin; i < end; ++i) b[i] = F(a[i], b[i]);
+                });
             };
     
             /**
              * \ingroup  OMP
-             * Maps the given binary functor to the local array of a reduction / accumulate operation, using OpenMP for parallelism
+             * Maps the given binary functor to the local array of a reduction / accumulate operation. Small arrays are 
+             * processed serially, medium arrays with a SIMD loop, and large arrays across the OpenMP thread team
              *
              * \param[in] in		The left hand array for the reduction
              * \param[in] inout		The right hand array for the reduction. This array is modified to reflect the result of the functor on each element
@@ -67,9 +147,18 @@ namespace MEL {
              */
             template<typename T, T(*F)(T&, T&, MEL::Datatype)>
             void ARRAY_OP_FUNC(T *in, T *inout, int *len, MPI_Datatype *dptr) {
-                #pragma omp parallel for
-                for (int i = 0; i < *len; ++i) 
-                    inout[i] = F(in[i], inout[i], dt);
+                const MEL::Datatype dt(*dptr);
+                const int n = *len;
+                if (n < GetReduceConfig().simdElements) {
+                    for (int i = 0; i < n; ++i) inout[i] = F(in[i], inout[i], dt);
+                    return;
+                }
+                AdaptiveMap<T>(n, [in, inout, &dt](const int begin, const int end) {
+                    T * __restrict a = in;
+                    T * __restrict b = inout;
+                    #pragma omp simd
+                    for (int i = begin; i < end; ++i) b[i] = F(a[i], b[i], dt);
+                });
             };
         };
 
@@ -104,5 +193,397 @@ namespace MEL {
             MEL_THROW( MPI_Op_create((void(*)(void*, void*, int*, MPI_Datatype*)) MEL::OMP::Functor::ARRAY_OP_FUNC<T, F>, commute, (MPI_Op*) &op), "OMP::Op::CreatOp" );
             return MEL::Op(op);
         };
+
+        /**
+         * \ingroup  OMP
+         * Combines one partial array per thread into rptr with the thread team, then reduces rptr across the comm world in-place. 
+         * Hybrid codes that accumulate into per-thread buffers pay for a single MPI_Allreduce per process rather than one per thread
+         *
+         * \see MPI_Allreduce
+         *
+         * \param[in] partials		Array of numPartials pointers, each to num elements
+         * \param[in] numPartials	The number of partial arrays, typically the number of threads
+         * \param[out] rptr			Pointer to num elements to receive the result. May be one of the partials
+         * \param[in] num			The number of elements in each array
+         * \param[in] datatype		The derived datatype of the elements
+         * \param[in] op			The operation to reduce across processes. Should compute the same function as F
+         * \param[in] comm			The comm world to reduce across
+         */
+        template<typename T, T(*F)(T&, T&)>
+        inline void Allreduce(T **partials, const int numPartials, T *rptr, const int num, const MEL::Datatype &datatype, const MEL::Op &op, const MEL::Comm &comm) {
+            if (numPartials > 0) {
+                AdaptiveMap<T>(num, [=](const int begin, const int end) {
+                    for (int i = begin; i < end; ++i) {
+                        T acc = partials[0][i];
+                        for (int p = 1; p < numPartials; ++p) acc = F(partials[p][i], acc);
+                        rptr[i] = acc;
+                    }
+                });
+            }
+            MEL::Allreduce(MPI_IN_PLACE, rptr, num, datatype, op, comm);
+        };
+
+        /**
+         * \ingroup  OMP
+         * Combines one partial array per thread into rptr with the thread team, then reduces rptr across the comm world in-place
+         *
+         * \see MPI_Allreduce
+         *
+         * \param[in] partials		One pointer to num elements per thread
+         * \param[out] rptr			Pointer to num elements to receive the result. May be one of the partials
+         * \param[in] num			The number of elements in each array
+         * \param[in] datatype		The derived datatype of the elements
+         * \param[in] op			The operation to reduce across processes. Should compute the same function as F
+         * \param[in] comm			The comm world to reduce across
+         */
+        template<typename T, T(*F)(T&, T&)>
+        inline void Allreduce(std::vector<T*> &partials, T *rptr, const int num, const MEL::Datatype &datatype, const MEL::Op &op, const MEL::Comm &comm) {
+            MEL::OMP::Allreduce<T, F>(partials.data(), (int) partials.size(), rptr, num, datatype, op, comm);
+        };
+
+        /**
+         * \ingroup  OMP
+         * Combines one partial array per thread into rptr with the thread team, then reduces across the comm world onto root
+         *
+         * \see MPI_Reduce
+         *
+         * \param[in] partials		Array of numPartials pointers, each to num elements
+         * \param[in] numPartials	The number of partial arrays, typically the number of threads
+         * \param[in,out] rptr		Pointer to num elements. Holds the local pre-reduction on every rank and the result on root
+         * \param[in] num			The number of elements in each array
+         * \param[in] datatype		The derived datatype of the elements
+         * \param[in] op			The operation to reduce across processes. Should compute the same function as F
+         * \param[in] root			The rank to reduce onto
+         * \param[in] comm			The comm world to reduce across
+         */
+        template<typename T, T(*F)(T&, T&)>
+        inline void Reduce(T **partials, const int numPartials, T *rptr, const int num, const MEL::Datatype &datatype, const MEL::Op &op, const int root, const MEL::Comm &comm) {
+            if (numPartials > 0) {
+                AdaptiveMap<T>(num, [=](const int begin, const int end) {
+                    for (int i = begin; i < end; ++i) {
+                        T acc = partials[0][i];
+                        for (int p = 1; p < numPartials; ++p) acc = F(partials[p][i], acc);
+                        rptr[i] = acc;
+                    }
+                });
+            }
+            if (MEL::CommRank(comm) == root) MEL::Reduce(MPI_IN_PLACE, rptr, num, datatype, op, root, comm);
+            else                             MEL::Reduce(rptr, nullptr, num, datatype, op, root, comm);
+        };
+
+        namespace Deep {
+
+            /**
+             * \ingroup  OMP
+             * Settings for the parallel deep pack / unpack of vectors. Vectors shorter than minElements are packed serially with 
+             * MEL::Deep::Pack. Longer vectors are split into up to chunksPerThread chunks per thread, which are sized, packed 
+             * and unpacked concurrently by up to maxThreads threads
+             */
+            struct PackConfig {
+                int minElements;
+                int chunksPerThread;
+                int maxThreads;
+
+                PackConfig() : minElements(64), chunksPerThread(4), maxThreads(omp_get_max_threads()) {};
+            };
+
+            /**
+             * \ingroup  OMP
+             * Access the process wide parallel pack settings. Modify the returned reference to tune them
+             *
+             * \return			Returns a reference to the PackConfig in use
+             */
+            inline PackConfig& GetPackConfig() {
+                static PackConfig config;
+                return config;
+            };
+
+            /// \cond HIDE
+            /// Pointer map for one chunk, which can list the pointers it holds and be seeded with pointers packed by earlier chunks
+            class ChunkPointerMap {
+            private:
+                std::unordered_map<void*, void*> pointerMap;
+
+            public:
+                template<typename T>
+                inline bool find(T* oldPtr, T* &ptr) {
+                    const auto it = pointerMap.find((void*) oldPtr);
+                    if (it != pointerMap.end()) {
+                        ptr = (T*) it->second;
+                        return true;
+                    }
+                    return false;
+                };
+
+                template<typename T>
+                inline void insert(T* oldPtr, T* ptr) {
+                    pointerMap.insert(std::make_pair((void*) oldPtr, (void*) ptr));
+                };
+
+                inline void seed(void *ptr) {
+                    pointerMap.insert(std::make_pair(ptr, ptr));
+                };
+
+                inline void keys(std::vector<void*> &ptrs) const {
+                    ptrs.clear();
+                    for (const auto &e : pointerMap) ptrs.push_back(e.first);
+                };
+            };
+
+            /// MPI_Alloc_mem may only be called from several threads at once under MPI_THREAD_MULTIPLE
+            class ThreadSafeAllocator {
+            public:
+                static constexpr bool CONTIGUOUS = false;
+
+                template<typename T>
+                inline T* alloc(const int len) {
+                    static const bool multiple = [] { int provided; MPI_Query_thread(&provided); return provided == MPI_THREAD_MULTIPLE; }();
+                    if (multiple) return MEL::MemAlloc<T>(len);
+                    T *ptr;
+                    #pragma omp critical(MEL_OMP_Deep_Alloc)
+                    ptr = MEL::MemAlloc<T>(len);
+                    return ptr;
+                };
+            };
+
+            /// A parallel packed vector starts with the negated size of its chunk table, where a serial packing starts with the 
+            /// vector length, which is never negative. The table holds the number of chunks, a flag set when pointers are shared 
+            /// between chunks, and one { first element, byte offset } entry per chunk plus an end entry. The serial byte stream of 
+            /// MEL::Deep::Pack in depth-first order follows, so serial readers skip the table and read the rest as usual
+            struct PackChunk {
+                int first, offset;
+            };
+
+            inline int ChunkTableBytes(const int numChunks) {
+                return (int) (2 * sizeof(int) + (numChunks + 1) * sizeof(PackChunk));
+            };
+
+            inline int SplitChunks(const int len, std::vector<PackChunk> &chunks) {
+                const PackConfig &config = GetPackConfig();
+                const int threads = omp_in_parallel() ? 1 : std::max(1, config.maxThreads);
+                const int numChunks = std::max(1, std::min(len, threads * std::max(1, config.chunksPerThread)));
+                chunks.resize(numChunks + 1);
+                for (int c = 0; c <= numChunks; ++c) {
+                    chunks[c].first  = (int) (((long long) len * c) / numChunks);
+                    chunks[c].offset = 0;
+                }
+                return std::min(threads, numChunks);
+            };
+
+            /// Leaves each chunk with the keys it shares with earlier chunks, which a serial pack would already have sent
+            template<typename K>
+            inline bool KeepShared(std::vector<std::vector<K>> &keys) {
+                std::unordered_set<K> seen;
+                bool any = false;
+                for (auto &chunk : keys) {
+                    std::vector<K> earlier;
+                    for (const K &key : chunk) if (!seen.insert(key).second) earlier.push_back(key);
+                    chunk.swap(earlier);
+                    any |= !chunk.empty();
+                }
+                return any;
+            };
+
+            template<typename MSG>
+            inline void Seed(MSG &msg, const std::vector<void*> &ptrs, const std::vector<size_t> &shared) {
+                for (void *ptr : ptrs)     msg.getPointerMap().seed(ptr);
+                for (size_t addr : shared) msg.markShared(addr);
+            };
+
+            template<typename MSG, typename D>
+            inline void VisitChunk(MSG &msg, std::vector<D> &obj, const PackChunk &begin, const PackChunk &end) {
+                msg.setBreadthFirst(false);
+                msg.setInPlace(false);
+                for (int i = begin.first; i < end.first; ++i) msg.packVar(obj[i]);
+            };
+
+            /// Reads the chunk table of a parallel packed vector, returns false for buffers packed serially
+            template<typename D>
+            inline bool ReadChunks(char *buffer, const int size, std::vector<PackChunk> &chunks, int &shared) {
+                int tableBytes;
+                std::memcpy(&tableBytes, buffer, sizeof(int));
+                if (tableBytes >= 0) return false;
+                tableBytes = -tableBytes;
+
+                int head[2];
+                if ((long long) tableBytes + (long long) (2 * sizeof(int)) > size || tableBytes < (int) sizeof(head)) MEL::Abort(-1, "MEL::OMP::Deep::Unpack : Corrupt chunk table...");
+                std::memcpy(head, buffer + sizeof(int), sizeof(head));
+                const int numChunks = head[0];
+                shared = head[1];
+                if (numChunks < 1 || ChunkTableBytes(numChunks) != tableBytes) MEL::Abort(-1, "MEL::OMP::Deep::Unpack : Corrupt chunk table...");
+
+                chunks.resize(numChunks + 1);
+                std::memcpy(&chunks[0], buffer + sizeof(int) + sizeof(head), (numChunks + 1) * sizeof(PackChunk));
+
+                int len;
+                std::memcpy(&len, buffer + sizeof(int) + tableBytes, sizeof(int));
+                if (len < 0 || chunks[0].first != 0 || chunks[numChunks].first != len || chunks[numChunks].offset != size
+                    || chunks[0].offset != (int) (2 * sizeof(int) + tableBytes + len * sizeof(D))) MEL::Abort(-1, "MEL::OMP::Deep::Unpack : Corrupt chunk table...");
+                return true;
+            };
+            /// \endcond
+
+            /**
+             * \ingroup  OMP
+             * Packs a vector of deep objects with the thread team. Each chunk of elements is sized on its own, offsets into the 
+             * buffer come from a prefix sum of the sizes, and the chunks are then packed concurrently. Pointers reached from 
+             * several chunks (through packSharedPtr or std::shared_ptr) are found between the two passes and only packed by 
+             * the first chunk, so after the chunk table the stream is the one MEL::Deep::Pack would produce in depth-first order, 
+             * and MEL::Deep::Unpack / BufferedRecv can read it. DeepCopy must be safe to call for different elements at the same time
+             *
+             * \param[in] obj			The vector to pack
+             * \param[out] packed		The packed message to fill
+             */
+            template<typename D>
+            inline MEL::Deep::enable_if_deep<D> Pack(std::vector<D> &obj, MEL::Deep::PackedMessage &packed) {
+                typedef MEL::Deep::Message<MEL::Deep::NoTransport, ChunkPointerMap>          SizeMessage;
+                typedef MEL::Deep::Message<MEL::Deep::TransportBufferWrite, ChunkPointerMap> PackMessage;
+
+                const int len = (int) obj.size();
+                if (len < GetPackConfig().minElements) {
+                    MEL::Deep::Pack(obj, packed);
+                    return;
+                }
+
+                std::vector<PackChunk> chunks;
+                const int threads = SplitChunks(len, chunks), numChunks = (int) chunks.size() - 1;
+                std::vector<int> sizes(numChunks);
+                std::vector<std::vector<void*>>  ptrs(numChunks);
+                std::vector<std::vector<size_t>> shared(numChunks);
+
+                /// Size every chunk on its own, noting the pointers it tracks
+                #pragma omp parallel for schedule(dynamic) num_threads(threads)
+                for (int c = 0; c < numChunks; ++c) {
+                    SizeMessage msg(0);
+                    VisitChunk(msg, obj, chunks[c], chunks[c + 1]);
+                    sizes[c] = msg.getOffset();
+                    msg.getPointerMap().keys(ptrs[c]);
+                    msg.getSharedAddresses(shared[c]);
+                }
+
+                /// Chunks reaching pointers that an earlier chunk packs skip them, and are sized again
+                const bool crossShared = KeepShared(ptrs) | KeepShared(shared);
+                if (crossShared) {
+                    #pragma omp parallel for schedule(dynamic) num_threads(threads)
+                    for (int c = 0; c < numChunks; ++c) {
+                        if (ptrs[c].empty() && shared[c].empty()) continue;
+                        SizeMessage msg(0);
+                        Seed(msg, ptrs[c], shared[c]);
+                        VisitChunk(msg, obj, chunks[c], chunks[c + 1]);
+                        sizes[c] = msg.getOffset();
+                    }
+                }
+
+                const int tableBytes = ChunkTableBytes(numChunks), elements = 2 * sizeof(int) + tableBytes;
+                chunks[0].offset = (int) (elements + len * sizeof(D));
+                for (int c = 0; c < numChunks; ++c) chunks[c + 1].offset = chunks[c].offset + sizes[c];
+
+                const int head[3] = { -tableBytes, numChunks, crossShared ? 1 : 0 };
+                char *buffer = packed.resize(chunks[numChunks].offset);
+                std::memcpy(buffer, head, sizeof(head));
+                std::memcpy(buffer + sizeof(head), &chunks[0], (numChunks + 1) * sizeof(PackChunk));
+                std::memcpy(buffer + elements - sizeof(int), &len, sizeof(int));
+
+                #pragma omp parallel for schedule(dynamic) num_threads(threads)
+                for (int c = 0; c < numChunks; ++c) {
+                    const int first = chunks[c].first, num = chunks[c + 1].first - first;
+                    std::memcpy(buffer + elements + first * sizeof(D), (const void*) &obj[first], num * sizeof(D));
+
+                    PackMessage msg(buffer + chunks[c].offset, sizes[c]);
+                    Seed(msg, ptrs[c], shared[c]);
+                    VisitChunk(msg, obj, chunks[c], chunks[c + 1]);
+                }
+            };
+
+            /**
+             * \ingroup  OMP
+             * Unpacks a vector of deep objects with the thread team, one chunk per task. Messages packed serially, or whose 
+             * chunks share pointers, are unpacked serially
+             *
+             * \param[out] obj			The vector to fill
+             * \param[in] packed		The packed message to read
+             */
+            template<typename D>
+            inline MEL::Deep::enable_if_deep<D> Unpack(std::vector<D> &obj, MEL::Deep::PackedMessage &packed) {
+                typedef MEL::Deep::Message<MEL::Deep::TransportBufferRead, MEL::Deep::PointerHashMap, ThreadSafeAllocator> UnpackMessage;
+
+                char *buffer = packed.data();
+                std::vector<PackChunk> chunks;
+                int shared;
+                if (!ReadChunks<D>(buffer, packed.getSize(), chunks, shared)) {
+                    MEL::Deep::Unpack(obj, packed);
+                    return;
+                }
+                if (shared || omp_in_parallel()) {
+                    MEL::Deep::Message<MEL::Deep::TransportBufferRead> msg(buffer, packed.getSize());
+                    msg.setBreadthFirst(false);
+                    msg.packRootSTL(obj);
+                    return;
+                }
+
+                const int numChunks = (int) chunks.size() - 1, len = chunks[numChunks].first, elements = 2 * sizeof(int) + ChunkTableBytes(numChunks);
+                obj.resize(len);
+                const int threads = std::max(1, std::min(GetPackConfig().maxThreads, numChunks));
+
+                #pragma omp parallel for schedule(dynamic) num_threads(threads)
+                for (int c = 0; c < numChunks; ++c) {
+                    const int first = chunks[c].first, num = chunks[c + 1].first - first;
+                    for (int i = first; i < first + num; ++i) (&obj[i])->~D();
+                    std::memcpy((void*) &obj[first], buffer + elements + first * sizeof(D), num * sizeof(D));
+
+                    UnpackMessage msg(buffer + chunks[c].offset, chunks[c + 1].offset - chunks[c].offset);
+                    VisitChunk(msg, obj, chunks[c], chunks[c + 1]);
+                }
+            };
+
+            /**
+             * \ingroup  OMP
+             * Packs a vector of deep objects with the thread team and sends it. The receiver may use BufferedRecv from this 
+             * namespace to unpack in parallel, or MEL::Deep::BufferedRecv
+             *
+             * \param[in] obj			The vector to send
+             * \param[in] dst			The rank to send to
+             * \param[in] tag			The tag for the message
+             * \param[in] comm			The comm world the message is sent in
+             */
+            template<typename D>
+            inline MEL::Deep::enable_if_deep<D> BufferedSend(std::vector<D> &obj, const int dst, const int tag, const MEL::Comm &comm) {
+                MEL::Deep::PackedMessage packed;
+                MEL::OMP::Deep::Pack(obj, packed);
+                MEL::Deep::Send(packed, dst, tag, comm);
+            };
+
+            /**
+             * \ingroup  OMP
+             * Receives a vector of deep objects sent with any buffered deep send and unpacks it with the thread team
+             *
+             * \param[out] obj			The vector to receive into
+             * \param[in] src			The rank to receive from
+             * \param[in] tag			The tag for the message
+             * \param[in] comm			The comm world the message is received in
+             */
+            template<typename D>
+            inline MEL::Deep::enable_if_deep<D> BufferedRecv(std::vector<D> &obj, const int src, const int tag, const MEL::Comm &comm) {
+                MEL::Deep::PackedMessage packed;
+                MEL::Deep::Recv(packed, src, tag, comm);
+                MEL::OMP::Deep::Unpack(obj, packed);
+            };
+
+            /**
+             * \ingroup  OMP
+             * Broadcasts a vector of deep objects, packed and unpacked with the thread team on each process
+             *
+             * \param[in,out] obj		The vector to send on root, and to receive into on every other process
+             * \param[in] root			The rank broadcasting
+             * \param[in] comm			The comm world to broadcast across
+             */
+            template<typename D>
+            inline MEL::Deep::enable_if_deep<D> BufferedBcast(std::vector<D> &obj, const int root, const MEL::Comm &comm) {
+                MEL::Deep::PackedMessage packed;
+                if (MEL::CommRank(comm) == root) MEL::OMP::Deep::Pack(obj, packed);
+                MEL::Deep::Bcast(packed, root, comm);
+                if (MEL::CommRank(comm) != root) MEL::OMP::Deep::Unpack(obj, packed);
+            };
+        };
     };
 };
\ No newline at end of file
@@ -0,0 +1,346 @@
+/*
+The MIT License(MIT)
+
+Copyright(c) 2016 Joss Whittle
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "MEL.hpp"
+#include "MEL_deepcopy.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <unordered_map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MEL_SNAPSHOT_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace MEL {
+    namespace Deep {
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Snapshot
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        // A snapshot is a position-independent image of a deep object graph. Every block the graph points to is laid out in
+        // one file and every pointer field holds the file offset of its target (0 for nullptr), so the file can be mapped
+        // and used without unpacking. A relocation table lists the offset of every pointer field, so a private mapping can
+        // also be fixed up into ordinary pointers. Types may use plain members, packVar, packPtr, packSharedPtr and packRootPtr.
+        // STL containers hold heap pointers that cannot be relocated and are rejected at compile time
+
+        struct SnapshotHeader {
+            char               magic[8];
+            unsigned long long fileSize, rootOffset, relocOffset, relocCount;
+        };
+
+        static constexpr size_t SNAPSHOT_ALIGN = 16;
+
+        class SnapshotWriter {
+        private:
+            struct Block {
+                size_t size, offset;
+            };
+
+            /// Members
+            std::vector<char>                   image;
+            std::vector<unsigned long long>     relocs;
+            std::map<size_t, Block>             blocks;
+            std::unordered_map<void*, size_t>   shared;
+            size_t                              rootOffset;
+
+            // Copy len elements of ptr to the end of the image and remember where they came from
+            template<typename T>
+            inline size_t place(const T *ptr, const int len) {
+                const size_t offset = (image.size() + SNAPSHOT_ALIGN - 1) & ~(SNAPSHOT_ALIGN - 1), size = len * sizeof(T);
+                image.resize(offset + size);
+                memcpy(&image[offset], (const void*) ptr, size);
+                Block block;
+                block.size   = size;
+                block.offset = offset;
+                blocks[(size_t) ptr] = block;
+                return offset;
+            };
+
+            // Image offset of a field that lives inside an already placed block
+            inline size_t locate(const void *field) const {
+                const size_t addr = (size_t) field;
+                auto it = blocks.upper_bound(addr);
+                if (it != blocks.begin()) {
+                    --it;
+                    if (addr < (it->first + it->second.size)) return it->second.offset + (addr - it->first);
+                }
+                MEL::Abort(-1, "SnapshotWriter : Pointer field is not inside the object graph...");
+                return 0;
+            };
+
+            template<typename T>
+            inline void patch(T* &field, const size_t target) {
+                const size_t at = locate(&field);
+                const unsigned long long value = target;
+                memcpy(&image[at], &value, sizeof(value));
+                if (target != 0) relocs.push_back(at);
+            };
+
+            template<typename T>
+            inline enable_if_not_deep<T> visit(T *, const int) {};
+
+            template<typename D>
+            inline enable_if_deep<D> visit(D *ptr, const int len) {
+                for (int i = 0; i < len; ++i) ptr[i].DeepCopy(*this);
+            };
+
+        public:
+            SnapshotWriter() : image(sizeof(SnapshotHeader), 0), rootOffset(0) {};
+
+            SnapshotWriter(const SnapshotWriter &)            = delete;
+            SnapshotWriter& operator=(const SnapshotWriter &) = delete;
+
+            inline int getOffset() const {
+                return (int) image.size();
+            };
+
+            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+            // Object
+
+            template<typename D>
+            inline enable_if_deep<D> packVar(D &obj) {
+                obj.DeepCopy(*this);
+            };
+
+            template<typename T>
+            inline enable_if_not_deep<T> packVar(T &) {};
+
+            template<typename T>
+            inline void packRootVar(T &obj) {
+                rootOffset = place(&obj, 1);
+                visit(&obj, 1);
+            };
+
+            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+            // Pointer
+
+            template<typename T>
+            inline void packPtr(T* &ptr, int len = 1) {
+                if (ptr == nullptr || len <= 0) {
+                    patch(ptr, 0);
+                    return;
+                }
+                const size_t offset = place(ptr, len);
+                visit(ptr, len);
+                patch(ptr, offset);
+            };
+
+            template<typename T>
+            inline void packSharedPtr(T* &ptr, int len = 1) {
+                if (ptr == nullptr || len <= 0) {
+                    patch(ptr, 0);
+                    return;
+                }
+                const auto it = shared.find((void*) ptr);
+                if (it != shared.end()) {
+                    patch(ptr, it->second);
+                    return;
+                }
+                const size_t offset = place(ptr, len);
+                shared[(void*) ptr] = offset;
+                visit(ptr, len);
+                patch(ptr, offset);
+            };
+
+            template<typename T>
+            inline void packRootPtr(T* &ptr, int len = 1) {
+                if (ptr == nullptr || len <= 0) return;
+                rootOffset = place(ptr, len);
+                shared[(void*) ptr] = rootOffset;
+                visit(ptr, len);
+            };
+
+            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+            // STL
+
+            // Containers, strings and smart pointers own heap storage the image cannot relocate and are rejected when the
+            // type is compiled. A std::array lives inside its parent, so only its elements are visited
+            template<typename S>
+            inline typename std::enable_if<is_member_stl<S>::value && !is_std_array<S>::value>::type packSTL(S &) {
+                static_assert(!is_member_stl<S>::value, "MEL::Deep::SnapshotWriter STL containers cannot be stored in a snapshot");
+            };
+
+            template<typename S>
+            inline typename std::enable_if<is_std_array<S>::value>::type packSTL(S &obj) {
+                for (auto &e : obj) *this & e;
+            };
+
+            template<typename S>
+            inline typename std::enable_if<is_member_stl<S>::value, SnapshotWriter&>::type operator&(S &obj) {
+                packSTL(obj);
+                return *this;
+            };
+
+            template<typename T>
+            inline typename std::enable_if<!is_member_stl<T>::value, SnapshotWriter&>::type operator&(T &obj) {
+                packVar(obj);
+                return *this;
+            };
+
+            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+            // Finish the image and write it to path
+            inline void write(const std::string &path) {
+                SnapshotHeader header;
+                memcpy(header.magic, "MELSNAP1", 8);
+                header.rootOffset  = rootOffset;
+                header.relocOffset = (image.size() + SNAPSHOT_ALIGN - 1) & ~(SNAPSHOT_ALIGN - 1);
+                header.relocCount  = relocs.size();
+                header.fileSize    = header.relocOffset + relocs.size() * sizeof(unsigned long long);
+
+                image.resize(header.fileSize);
+                memcpy(&image[0], &header, sizeof(header));
+                if (!relocs.empty()) memcpy(&image[header.relocOffset], &relocs[0], relocs.size() * sizeof(unsigned long long));
+
+                std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+                if (!file.is_open()) MEL::Abort(-1, "SnapshotWriter : Could not open snapshot file for writing...");
+                file.write(&image[0], image.size());
+                if (!file.good()) MEL::Abort(-1, "SnapshotWriter : Failed to write snapshot file...");
+            };
+        };
+
+        // A loaded snapshot. The default mapping is read-only and shared, so co-located processes mapping the same file share
+        // its page-cache pages. Pointer fields then hold file offsets and are followed with resolve(). Passing fixup = true maps
+        // the file privately and rewrites the relocated fields into real pointers on first access to root(), after which the
+        // graph can be used like any other. Only the pages that hold pointers are copied
+        class Snapshot {
+        private:
+            /// Members
+            char   *base;
+            size_t  size;
+            bool    mapped, fixup, fixedUp;
+
+            inline const SnapshotHeader& header() const {
+                return *((const SnapshotHeader*) base);
+            };
+
+            inline void applyFixup() {
+                const unsigned long long *relocs = (const unsigned long long*) (base + header().relocOffset);
+                const size_t count = header().relocCount;
+                for (size_t i = 0; i < count; ++i) {
+                    unsigned long long value;
+                    memcpy(&value, base + relocs[i], sizeof(value));
+                    const size_t addr = (size_t) (base + value);
+                    memcpy(base + relocs[i], &addr, sizeof(addr));
+                }
+                fixedUp = true;
+            };
+
+        public:
+            explicit Snapshot(const std::string &path, const bool _fixup = false) : base(nullptr), size(0), mapped(false), fixup(_fixup), fixedUp(false) {
+#ifdef MEL_SNAPSHOT_MMAP
+                const int fd = open(path.c_str(), O_RDONLY);
+                if (fd < 0) MEL::Abort(-1, "Snapshot : Could not open snapshot file...");
+                struct stat st;
+                if (fstat(fd, &st) != 0) MEL::Abort(-1, "Snapshot : Could not stat snapshot file...");
+                size = (size_t) st.st_size;
+
+                void *ptr = mmap(nullptr, size, _fixup ? (PROT_READ | PROT_WRITE) : PROT_READ, _fixup ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+                close(fd);
+                if (ptr == MAP_FAILED) MEL::Abort(-1, "Snapshot : Could not map snapshot file...");
+                base   = (char*) ptr;
+                mapped = true;
+#else
+                std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+                if (!file.is_open()) MEL::Abort(-1, "Snapshot : Could not open snapshot file...");
+                size = (size_t) file.tellg();
+                base = MEL::MemAlloc<char>(size);
+                file.seekg(0);
+                file.read(base, size);
+#endif
+                if (size < sizeof(SnapshotHeader) || memcmp(header().magic, "MELSNAP1", 8) != 0 || header().fileSize != size) {
+                    MEL::Abort(-1, "Snapshot : Not a valid snapshot file...");
+                }
+            };
+
+            ~Snapshot() {
+#ifdef MEL_SNAPSHOT_MMAP
+                if (mapped) munmap(base, size);
+#else
+                MEL::MemFree(base);
+#endif
+            };
+
+            Snapshot(const Snapshot &)            = delete;
+            Snapshot& operator=(const Snapshot &) = delete;
+
+            // The root object. With fixup its pointer members are real pointers, otherwise follow them with resolve()
+            template<typename T>
+            inline T* root() {
+                if (fixup && !fixedUp) applyFixup();
+                return (header().rootOffset != 0) ? (T*) (base + header().rootOffset) : nullptr;
+            };
+
+            // Follow a pointer field of an unfixed snapshot
+            template<typename T>
+            inline T* resolve(T *field) const {
+                if (fixedUp) return field;
+                return (field != nullptr) ? (T*) (base + (size_t) field) : nullptr;
+            };
+
+            inline size_t getSize() const {
+                return size;
+            };
+        };
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Pointer / Length
+
+        template<typename P>
+        inline enable_if_pointer<P> SnapshotWrite(P &ptr, const int len, const std::string &path) {
+            SnapshotWriter msg;
+            msg.packRootPtr(ptr, len);
+            msg.write(path);
+        };
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Pointer
+
+        template<typename P>
+        inline enable_if_pointer<P> SnapshotWrite(P &ptr, const std::string &path) {
+            SnapshotWriter msg;
+            msg.packRootPtr(ptr);
+            msg.write(path);
+        };
+
+        /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Object
+
+        template<typename T>
+        inline enable_if_not_pointer_not_stl<T> SnapshotWrite(T &obj, const std::string &path) {
+            SnapshotWriter msg;
+            msg.packRootVar(obj);
+            msg.write(path);
+        };
+    };
+};
@@ -265,11 +265,7 @@ struct Scene {
         MEL::MemDestruct(rootNode);
     };
 
-    template<typename MSG>
-    inline void DeepCopy(MSG &msg) {
-        msg & mesh & materials;
-        msg.packPtr(rootNode);
-    };
+    MEL_DEEP_FIELDS(mesh, materials, rootNode);
 
     // Ray BVH-Tree(Triangle) intersection
     inline bool intersect(const Ray &ray, Intersection &isect) const {
@@ -968,9 +964,9 @@ int main(int argc, char *argv[]) {
                   bw = std::min(blockSize, w - bx), 
                   bh = std::min(blockSize, h - by);
 
-        /// Helper types for moving data
-        auto typeGlobalBlock = MEL::TypeCreateSubArray2D(MEL::Datatype::UNSIGNED_CHAR, bx * 3, by, bw * 3, bh, wR, h);
-        auto typeLocalBlock  = MEL::TypeCreateContiguous(typeColour, bw * bh);
+        /// Helper types for moving data, shared with any earlier block of the same shape
+        auto typeGlobalBlock = MEL::TypeCacheCreateSubArray2D(MEL::Datatype::UNSIGNED_CHAR, bx * 3, by, bw * 3, bh, wR, h);
+        auto typeLocalBlock  = MEL::TypeCacheCreateContiguous(typeColour, bw * bh);
 
         /// Allocate local image block
         unsigned char *blockPtr = MEL::MemAlloc<unsigned char>(bw * bh * 3);
@@ -992,7 +988,7 @@ int main(int argc, char *argv[]) {
 
         /// Clean up
         MEL::MemFree(blockPtr);
-        MEL::TypeFree(typeGlobalBlock, typeLocalBlock);
+        MEL::TypeCacheRelease(typeGlobalBlock, typeLocalBlock);
     }
     
     MEL::Barrier(comm);
@@ -25,10 +25,21 @@ SOFTWARE.
 /// Run this test suite using mpirun -n 2 ./DeepCopy-TestSuite
 /// It will produce two output files "DeepCopy - Test - Rank <i> of 2.out" and ".err"
 /// for each process.
+///
+/// Test cases tagged [Multi] run on any number of processes. Run them again on a few 
+/// larger, non power of two sizes, e.g. mpirun -n 3 ./DeepCopy-TestSuite [Multi]
+///
+/// Build with OpenMP enabled (e.g. -fopenmp) to include the MEL_omp.hpp test cases
 
 #define  MEL_IMPLEMENTATION
 #include "MEL.hpp"
 #include "MEL_deepcopy.hpp"
+#include "MEL_checkpoint.hpp"
+#include "MEL_snapshot.hpp"
+#include "MEL_localfile.hpp"
+#ifdef _OPENMP
+#include "MEL_omp.hpp"
+#endif
 
 /// This file depends on the "Catch" testing framework
 /// available here https://github.com/philsquared/Catch 
@@ -46,7 +57,7 @@ struct TestObject {
         for (int i = 0; i < size; ++i) arr[i] = i;
     };
 
-    inline bool operator==(TestObject &rhs) const {
+    inline bool operator==(const TestObject &rhs) const {
         if (arr.size() != rhs.arr.size()) return false;
         for (int i = 0; i < arr.size(); ++i) 
             if (arr[i] != rhs.arr[i]) return false;
@@ -945,6 +956,1875 @@ TEST_CASE("STL File", "[STL File]") {
     }
 }
 
+struct InPlaceObject {
+    std::vector<std::string> vec;
+    std::list<std::string>   lst;
+    std::deque<std::string>  deq;
+
+    /// Long enough that every string owns a heap allocation
+    static std::string Element(const int i, const int step) {
+        return std::string(32 + i, (char) ('a' + step));
+    };
+
+    void fill(const int size, const int step) {
+        vec.clear(); lst.clear(); deq.clear();
+        for (int i = 0; i < size; ++i) {
+            vec.push_back(Element(i, step));
+            lst.push_back(Element(i, step));
+            deq.push_back(Element(i, step));
+        }
+    };
+
+    inline bool matches(const int size, const int step) const {
+        if (vec.size() != (size_t) size || lst.size() != (size_t) size || deq.size() != (size_t) size) return false;
+        auto it = lst.begin();
+        for (int i = 0; i < size; ++i, ++it) {
+            if (vec[i] != Element(i, step) || *it != Element(i, step) || deq[i] != Element(i, step)) return false;
+        }
+        return true;
+    };
+
+    template<typename MSG>
+    inline void DeepCopy(MSG &msg) {
+        msg & vec & lst & deq;
+    };
+};
+
+TEST_CASE("In place Recv", "[Recv][InPlace]") {
+
+    MEL::Comm comm = MEL::Comm::WORLD;
+    const int comm_rank = MEL::CommRank(comm),
+              comm_size = MEL::CommSize(comm);
+
+    REQUIRE(comm_size == 2);
+
+    /// Grow, shrink, empty, regrow from empty and empty again
+    const int sizes[] = { 3, 8, 2, 0, 5, 0, 0, 1 };
+    const int steps   = sizeof(sizes) / sizeof(int);
+
+    MEL::Deep::GetTraversalConfig().inPlace = true;
+
+    SECTION("Recv an object in place") {
+        InPlaceObject p;
+        for (int step = 0; step < steps; ++step) {
+            if (comm_rank == 0) {
+                p.fill(sizes[step], step);
+                MEL::Deep::Send(p, 1, 0, comm);
+            }
+            else if (comm_rank == 1) {
+                MEL::Deep::Recv(p, 0, 0, comm);
+                REQUIRE(p.matches(sizes[step], step));
+            }
+        }
+    }
+
+    SECTION("BufferedRecv an object in place") {
+        InPlaceObject p;
+        for (int step = 0; step < steps; ++step) {
+            if (comm_rank == 0) {
+                p.fill(sizes[step], step);
+                MEL::Deep::BufferedSend(p, 1, 0, comm);
+            }
+            else if (comm_rank == 1) {
+                MEL::Deep::BufferedRecv(p, 0, 0, comm);
+                REQUIRE(p.matches(sizes[step], step));
+            }
+        }
+    }
+
+    MEL::Deep::GetTraversalConfig().inPlace = false;
+}
+
+struct DeltaObject {
+    std::vector<int> arr;
+
+    template<typename MSG>
+    inline void DeepCopy(MSG &msg) {
+        msg & arr;
+    };
+};
+
+TEST_CASE("Delta", "[Send][Recv][Bcast][Delta]") {
+
+    MEL::Comm comm = MEL::Comm::WORLD;
+    const int comm_rank = MEL::CommRank(comm),
+              comm_size = MEL::CommSize(comm);
+
+    REQUIRE(comm_size == 2);
+
+    const int sizes[] = { 3, 8, 8, 2, 0, 5, 5, 1 };
+    const int steps   = sizeof(sizes) / sizeof(int);
+
+    SECTION("DeltaSend / DeltaRecv an object") {
+        MEL::Deep::DeltaState state(64);
+        DeltaObject p;
+        p.arr.resize(1024);
+        for (int step = 0; step < steps; ++step) {
+            const int index = (step * 97) % p.arr.size();
+            if (comm_rank == 0) {
+                p.arr[index] = step + 1;
+                MEL::Deep::DeltaSend(p, 1, 0, comm, state);
+            }
+            else if (comm_rank == 1) {
+                const int *before = p.arr.data();
+                MEL::Deep::DeltaRecv(p, 0, 0, comm, state);
+                /// Same length, so the allocation is patched rather than replaced
+                REQUIRE(p.arr.data() == before);
+                REQUIRE(p.arr[index] == step + 1);
+            }
+        }
+        /// Only one chunk changes per step after the first
+        REQUIRE(state.wireBytes < state.rawBytes);
+    }
+
+    SECTION("DeltaSend / DeltaRecv a resized object") {
+        MEL::Deep::DeltaState state(64);
+        InPlaceObject p;
+        for (int step = 0; step < steps; ++step) {
+            if (comm_rank == 0) {
+                p.fill(sizes[step], step);
+                MEL::Deep::DeltaSend(p, 1, 0, comm, state);
+            }
+            else if (comm_rank == 1) {
+                MEL::Deep::DeltaRecv(p, 0, 0, comm, state);
+                REQUIRE(p.matches(sizes[step], step));
+            }
+        }
+    }
+
+    SECTION("DeltaBcast an object") {
+        MEL::Deep::DeltaState state(64);
+        InPlaceObject p;
+        for (int step = 0; step < steps; ++step) {
+            if (comm_rank == 0) p.fill(sizes[step], step);
+            MEL::Deep::DeltaBcast(p, 0, comm, state);
+            REQUIRE(p.matches(sizes[step], step));
+        }
+    }
+}
+
+/// Only id and tag are registered with MEL_TYPE_FIELDS, but a deep copy must still carry len and data between them
+struct RegisteredObject {
+    int id, len;
+    int *data;
+    int tag;
+
+    void fill(const int _id, const int _len) {
+        id = _id; len = _len; tag = -_id;
+        data = MEL::MemAlloc<int>(len);
+        for (int i = 0; i < len; ++i) data[i] = id + i;
+    };
+
+    inline bool matches(const int _id, const int _len) const {
+        if (id != _id || tag != -_id || len != _len || data == nullptr) return false;
+        for (int i = 0; i < len; ++i)
+            if (data[i] != id + i) return false;
+        return true;
+    };
+
+    template<typename MSG>
+    inline void DeepCopy(MSG &msg) {
+        msg.packPtr(data, len);
+    };
+};
+MEL_TYPE_FIELDS(RegisteredObject, id, tag)
+
+TEST_CASE("Registered type with DeepCopy", "[Send][Recv][Bcast]") {
+
+    MEL::Comm comm = MEL::Comm::WORLD;
+    const int comm_rank = MEL::CommRank(comm),
+              comm_size = MEL::CommSize(comm);
+
+    REQUIRE(comm_size == 2);
+
+    SECTION("Send / Recv an object") {
+        RegisteredObject p{};
+        if (comm_rank == 0) {
+            p.fill(7, 13);
+            MEL::Deep::Send(p, 1, 0, comm);
+        }
+        else if (comm_rank == 1) {
+            MEL::Deep::Recv(p, 0, 0, comm);
+        }
+        REQUIRE(p.matches(7, 13));
+        MEL::MemFree(p.data);
+    }
+
+    SECTION("Bcast an object") {
+        RegisteredObject p{};
+        if (comm_rank == 0) p.fill(3, 9);
+        MEL::Deep::Bcast(p, 0, comm);
+        REQUIRE(p.matches(3, 9));
+        MEL::MemFree(p.data);
+    }
+}
+
+/// Sends an object built by fill from rank 0 to rank 1 through each root form, and checks it on every receiver
+template<typename T, typename FILL, typename CHECK>
+void RoundTrip(FILL fill, CHECK check, const MEL::Comm &comm) {
+    const int comm_rank = MEL::CommRank(comm);
+
+    SECTION("Send / Recv") {
+        T p;
+        if (comm_rank == 0) {
+            fill(p);
+            MEL::Deep::Send(p, 1, 0, comm);
+        }
+        else if (comm_rank == 1) {
+            MEL::Deep::Recv(p, 0, 0, comm);
+            REQUIRE(check(p));
+        }
+    }
+
+    SECTION("BufferedSend / BufferedRecv") {
+        T p;
+        if (comm_rank == 0) {
+            fill(p);
+            MEL::Deep::BufferedSend(p, 1, 0, comm);
+        }
+        else if (comm_rank == 1) {
+            MEL::Deep::BufferedRecv(p, 0, 0, comm);
+            REQUIRE(check(p));
+        }
+    }
+
+    SECTION("Bcast") {
+        T p;
+        if (comm_rank == 0) fill(p);
+        MEL::Deep::Bcast(p, 0, comm);
+        REQUIRE(check(p));
+    }
+
+    SECTION("BufferedBcast") {
+        T p;
+        if (comm_rank == 0) fill(p);
+        MEL::Deep::BufferedBcast(p, 0, comm);
+        REQUIRE(check(p));
+    }
+}
+
+/// Restores a global setting when it goes out of scope, so a failed REQUIRE does not leak it into later test cases
+template<typename T>
+struct ScopedSetting {
+    T &setting;
+    T saved;
+
+    ScopedSetting(T &_setting) : setting(_setting), saved(_setting) {};
+    ~ScopedSetting() {
+        setting = saved;
+    };
+};
+
+/// A complete binary tree, every level of which breadth-first order sends as one chunk
+struct BranchNode {
+    int value;
+    BranchNode *left, *right;
+    std::vector<int> data;
+
+    BranchNode() : value(0), left(nullptr), right(nullptr) {};
+
+    template<typename MSG>
+    inline void DeepCopy(MSG &msg) {
+        msg.packPtr(left);
+        msg.packPtr(right);
+        msg & data;
+    };
+};
+
+struct BranchTree {
+    static constexpr int DEPTH = 6;
+    BranchNode root;
+
+    BranchTree() {};
+    ~BranchTree() {
+        release(root.left);
+        release(root.right);
+    };
+
+    static void release(BranchNode *node) {
+        if (node == nullptr) return;
+        release(node->left);
+        release(node->right);
+        node->~BranchNode();
+        MEL::MemFree(node);
+    };
+
+    static void build(BranchNode &node, const int value, const int depth) {
+        node.value = value;
+        node.data  = std::vector<int>(value % 5, value);
+        if (depth == 0) return;
+        node.left  = new (MEL::MemAlloc<BranchNode>(1)) BranchNode();
+        node.right = new (MEL::MemAlloc<BranchNode>(1)) BranchNode();
+        build(*node.left,  value * 2 + 1, depth - 1);
+        build(*node.right, value * 2 + 2, depth - 1);
+    };
+
+    static bool check(const BranchNode &node, const int value, const int depth) {
+        if (node.value != value || node.data != std::vector<int>(value % 5, value)) return false;
+        if (depth == 0) return node.left == nullptr && node.right == nullptr;
+        if (node.left == nullptr || node.right == nullptr) return false;
+        return check(*node.left, value * 2 + 1, depth - 1) && check(*node.right, value * 2 + 2, depth - 1);
+    };
+
+    void fill() {
+        build(root, 0, DEPTH);
+    };
+
+    bool matches() const {
+        return check(root, 0, DEPTH);
+    };
+
+    template<typename MSG>
+    inline void DeepCopy(MSG &msg) {
+        msg & root;
+    };
+};
+
+/// Records the values of the tree nodes in the order they are transported, and how many transports carried them
+struct BranchRecorder {
+    static constexpr bool SOURCE = true;
+
+    std::vector<int> &values;
+    int &chunks;
+
+    BranchRecorder(std::vector<int> &_values, int &_chunks) : values(_values), chunks(_chunks) {};
+
+    template<typename T>
+    inline void transport(T *&ptr, const int len) {
+        record(ptr, len);
+    };
+
+    inline void record(BranchNode *ptr, const int len) {
+        ++chunks;
+        for (int i = 0; i < len; ++i) values.push_back(ptr[i].value);
+    };
+
+    template<typename T>
+    inline void record(T *, const int) {};
+};
+
+TEST_CASE("Breadth-first round trip", "[Send][Recv][Bcast][BreadthFirst]") {
+    REQUIRE(MEL::CommSize(MEL::Comm::WORLD) == 2);
+
+    ScopedSetting<MEL::Deep::TraversalConfig> config(MEL::Deep::GetTraversalConfig());
+    MEL::Deep::GetTraversalConfig().breadthFirst = true;
+
+    SECTION("Level order") {
+        BranchTree tree;
+        tree.fill();
+
+        /// Nodes are numbered in level order, so breadth-first transports them in counting order, one chunk per level
+        std::vector<int> values;
+        int chunks = 0, bytes;
+        {
+            MEL::Deep::Message<BranchRecorder> msg(values, chunks);
+            REQUIRE(msg.isBreadthFirst());
+            msg.packRootVar(tree);
+            bytes = msg.getOffset();
+        }
+        const int depth = BranchTree::DEPTH;
+        REQUIRE(chunks == depth);
+        REQUIRE((int) values.size() == (1 << (depth + 1)) - 2);
+        for (size_t i = 0; i < values.size(); ++i) REQUIRE(values[i] == (int) i + 1);
+
+        /// Depth-first sends the same bytes, one node at a time down the left branch first
+        values.clear();
+        chunks = 0;
+        {
+            MEL::Deep::Message<BranchRecorder> msg(values, chunks);
+            msg.setBreadthFirst(false);
+            msg.packRootVar(tree);
+            REQUIRE(msg.getOffset() == bytes);
+        }
+        REQUIRE(chunks == (int) values.size());
+        REQUIRE(values[0] == 1);
+        REQUIRE(values[1] == 3);
+        REQUIRE(values[2] == 7);
+    }
+
+    SECTION("A tree") {
+        RoundTrip<BranchTree>([](BranchTree &p) { p.fill(); }, [](const BranchTree &p) { return p.matches(); }, MEL::Comm::WORLD);
+    }
+
+    SECTION("A std::map of deep objects") {
+        typedef std::map<int, TestObject> T;
+        auto fill  = [](T &p) { for (int i = 0; i < 10; ++i) p[i] = TestObject(i); };
+        auto check = [](const T &p) {
+            T expected;
+            for (int i = 0; i < 10; ++i) expected[i] = TestObject(i);
+            return p == expected;
+        };
+        RoundTrip<T>(fill, check, MEL::Comm::WORLD);
+    }
+}
+
+TEST_CASE("std::map round trip", "[Send][Recv][Bcast][STL]") {
+    REQUIRE(MEL::CommSize(MEL::Comm::WORLD) == 2);
+
+    typedef std::map<int, TestObject> T;
+    auto fill  = [](T &p) { for (int i = 0; i < 10; ++i) p[i * 3] = TestObject(i); };
+    auto check = [](const T &p) {
+        T expected;
+        for (int i = 0; i < 10; ++i) expected[i * 3] = TestObject(i);
+        return p == expected;
+    };
+    RoundTrip<T>(fill, check, MEL::Comm::WORLD);
+}
+
+TEST_CASE("std::set round trip", "[Send][Recv][Bcast][STL]") {
+    REQUIRE(MEL::CommSize(MEL::Comm::WORLD) == 2);
+
+    typedef std::set<std::string> T;
+    auto fill  = [](T &p) { for (int i = 0; i < 10; ++i) p.insert(std::string(i + 1, (char) ('a' + i))); };
+    auto check = [](const T &p) {
+        T expected;
+        for (int i = 0; i < 10; ++i) expected.insert(std::string(i + 1, (char) ('a' + i)));
+        return p == expected;
+    };
+    RoundTrip<T>(fill, check, MEL::Comm::WORLD);
+}
+
+TEST_CASE("std::unordered_map round trip", "[Send][Recv][Bcast][STL]") {
+    REQUIRE(MEL::CommSize(MEL::Comm::WORLD) == 2);
+
+    typedef std::unordered_map<std::string, std::vector<int>> T;
+    auto fill  = [](T &p) { for (int i = 0; i < 10; ++i) p[std::to_string(i)] = std::vector<int>(i, i); };
+    auto check = [](const T &p) {
+        T expected;
+        for (int i = 0; i < 10; ++i) expected[std::to_string(i)] = std::vector<int>(i, i);
+        return p == expected;
+    };
+    RoundTrip<T>(fill, check, MEL::Comm::WORLD);
+}
+
+TEST_CASE("std::unordered_set round trip", "[Send][Recv][Bcast][STL]") {
+    REQUIRE(MEL::CommSize(MEL::Comm::WORLD) == 2);
+
+    typedef std::unordered_set<int> T;
+    auto fill  = [](T &p) { for (int i = 0; i < 100; ++i) p.insert(i * 7); };
+    auto check = [](const T &p) {
+        T expected;
+        for (int i = 0; i < 100; ++i) expected.insert(i * 7);
+        return p == expected;
+    };
+    RoundTrip<T>(fill, check, MEL::Comm::WORLD);
+}
+
+TEST_CASE("std::deque round trip", "[Send][Recv][Bcast][STL]") {
+    REQUIRE(MEL::CommSize(MEL::Comm::WORLD) == 2);
+
+    typedef std::deque<TestObject> T;
+    auto fill  = [](T &p) { for (int i = 0; i < 10; ++i) p.push_back(TestObject(i)); };
+    auto check = [](const T &p) {
+        T expected;
+        for (int i = 0; i < 10; ++i) expected.push_back(TestObject(i));
+        return p == expected;
+    };
+    RoundTrip<T>(fill, check, MEL::Comm::WORLD);
+}
+
+TEST_CASE("std::array round trip", "[Send][Recv][Bcast][STL]") {
+    REQUIRE(MEL::CommSize(MEL::Comm::WORLD) == 2);
+
+    typedef std::array<TestObject, 4> T;
+    auto fill  = [](T &p) { for (int i = 0; i < 4; ++i) p[i] = TestObject(i + 5); };
+    auto check = [](const T &p) {
+        T expected;
+        for (int i = 0; i < 4; ++i) expected[i] = TestObject(i + 5);
+        return p == expected;
+    };
+    RoundTrip<T>(fill, check, MEL::Comm::WORLD);
+}
+
+struct SmartObject {
+    std::unique_ptr<TestObject> owned, empty;
+    std::shared_ptr<TestObject> first, second;
+
+    template<typename MSG>
+    inline void DeepCopy(MSG &msg) {
+        msg & owned & empty & first & second;
+    };
+};
+
+TEST_CASE("Smart pointer round trip", "[Send][Recv][Bcast][STL]") {
+    REQUIRE(MEL::CommSize(MEL::Comm::WORLD) == 2);
+
+    auto fill  = [](SmartObject &p) {
+        p.owned.reset(new TestObject(7));
+        p.first  = std::make_shared<TestObject>(11);
+        p.second = p.first;
+    };
+    auto check = [](const SmartObject &p) {
+        return p.owned && *p.owned == TestObject(7) && !p.empty 
+            && p.first && *p.first == TestObject(11) && p.second == p.first;
+    };
+    RoundTrip<SmartObject>(fill, check, MEL::Comm::WORLD);
+}
+
+/// A struct whose DeepCopy is generated from its member list, mixing trivially copyable, deep, pointer and STL members
+struct FieldsObject {
+    int id;
+    double weight;
+    int grid[3];
+    TestObject nested;
+    TestObject children[2];
+    TestObject *single, *missing;
+    int *count;
+    std::vector<int> values;
+    std::string name;
+    std::map<int, std::string> tags;
+    std::unique_ptr<TestObject> owned;
+
+    FieldsObject() : id(0), weight(0), grid(), single(nullptr), missing(nullptr), count(nullptr) {};
+    ~FieldsObject() {
+        if (single != nullptr) { single->~TestObject(); MEL::MemFree(single); }
+        MEL::MemFree(count);
+    };
+
+    MEL_DEEP_FIELDS(id, weight, grid, nested, children, single, missing, count, values, name, tags, owned)
+};
+
+TEST_CASE("Generated DeepCopy with MEL_DEEP_FIELDS", "[Send][Recv][Bcast][Fields]") {
+    REQUIRE(MEL::CommSize(MEL::Comm::WORLD) == 2);
+
+    auto fill = [](FieldsObject &p) {
+        p.id      = 42;
+        p.weight  = 0.5;
+        p.grid[0] = 1; p.grid[1] = 2; p.grid[2] = 3;
+        p.nested      = TestObject(5);
+        p.children[0] = TestObject(3);
+        p.children[1] = TestObject(9);
+        p.single  = new (MEL::MemAlloc<TestObject>(1)) TestObject(12);
+        p.count   = MEL::MemAlloc<int>(1);
+        *p.count  = 7;
+        p.values  = { 4, 5, 6, 7 };
+        p.name    = "fields";
+        p.tags    = { { 1, "one" }, { 2, "two" } };
+        p.owned.reset(new TestObject(6));
+    };
+    auto check = [](const FieldsObject &p) {
+        return p.id == 42 && p.weight == 0.5 && p.grid[0] == 1 && p.grid[1] == 2 && p.grid[2] == 3
+            && p.nested == TestObject(5) && p.children[0] == TestObject(3) && p.children[1] == TestObject(9)
+            && p.single != nullptr && *p.single == TestObject(12) && p.missing == nullptr
+            && p.count != nullptr && *p.count == 7
+            && p.values == std::vector<int>({ 4, 5, 6, 7 }) && p.name == "fields"
+            && p.tags == std::map<int, std::string>({ { 1, "one" }, { 2, "two" } })
+            && p.owned && *p.owned == TestObject(6);
+    };
+    RoundTrip<FieldsObject>(fill, check, MEL::Comm::WORLD);
+}
+
+/// The leading ints are chosen to look like a compressed frame header
+struct FrameLikeObject {
+    int head[4];
+    std::vector<float> arr;
+
+    void fill(const int size) {
+        head[0] = 0x5A4C454D; head[1] = 7; head[2] = 1; head[3] = 0;
+        arr.resize(size);
+        for (int i = 0; i < size; ++i) arr[i] = 1000.f + (float) (i / 64);
+    };
+
+    inline bool matches(const int size) const {
+        if (head[0] != 0x5A4C454D || head[1] != 7 || head[2] != 1 || head[3] != 0 || arr.size() != (size_t) size) return false;
+        for (int i = 0; i < size; ++i)
+            if (arr[i] != 1000.f + (float) (i / 64)) return false;
+        return true;
+    };
+
+    template<typename MSG>
+    inline void DeepCopy(MSG &msg) {
+        msg & arr;
+    };
+};
+
+TEST_CASE("Compression", "[Send][Recv][Bcast][Compression]") {
+
+    MEL::Comm comm = MEL::Comm::WORLD;
+    const int comm_rank = MEL::CommRank(comm),
+              comm_size = MEL::CommSize(comm);
+
+    REQUIRE(comm_size == 2);
+
+    ScopedSetting<MEL::Deep::CompressionConfig> guard(MEL::Deep::GetCompressionConfig());
+    MEL::Deep::CompressionConfig &config = MEL::Deep::GetCompressionConfig();
+    MEL::Deep::CompressionStats  &stats  = MEL::Deep::GetCompressionStats();
+    stats = MEL::Deep::CompressionStats();
+
+    const int size = 1 << 14;
+
+    /// Sends and broadcasts one object, then checks it on both sides
+    auto roundTrip = [&]() {
+        FrameLikeObject p;
+        if (comm_rank == 0) {
+            p.fill(size);
+            MEL::Deep::BufferedSend(p, 1, 0, comm);
+        }
+        else if (comm_rank == 1) {
+            MEL::Deep::BufferedRecv(p, 0, 0, comm);
+        }
+        REQUIRE(p.matches(size));
+
+        FrameLikeObject q;
+        if (comm_rank == 0) q.fill(size);
+        MEL::Deep::BufferedBcast(q, 0, comm);
+        REQUIRE(q.matches(size));
+    };
+
+    SECTION("Disabled") {
+        config.enabled = false;
+        roundTrip();
+        REQUIRE(stats.messages == 0);
+    }
+
+    SECTION("Below threshold") {
+        config.enabled   = true;
+        config.threshold = size * (int) sizeof(float) * 2;
+        roundTrip();
+        REQUIRE(stats.messages == 0);
+        REQUIRE(stats.ratio() == 1.0);
+    }
+
+    SECTION("Above threshold") {
+        config.enabled      = true;
+        config.threshold    = 1024;
+        config.shuffleWidth = 0;
+        roundTrip();
+        if (comm_rank == 0) {
+            REQUIRE(stats.messages == 2);
+            REQUIRE(stats.rawBytes > stats.wireBytes);
+            REQUIRE(stats.ratio() > 1.0);
+        }
+    }
+
+    SECTION("Above threshold with shuffle") {
+        config.enabled      = true;
+        config.threshold    = 1024;
+        config.shuffleWidth = sizeof(float);
+        roundTrip();
+        if (comm_rank == 0) {
+            REQUIRE(stats.messages == 2);
+            REQUIRE(stats.ratio() > 1.0);
+        }
+    }
+
+    stats = MEL::Deep::CompressionStats();
+}
+
+TEST_CASE("PackedMessage to several ranks", "[PackedMessage][Multi]") {
+
+    MEL::Comm comm = MEL::Comm::WORLD;
+    const int comm_rank = MEL::CommRank(comm),
+              comm_size = MEL::CommSize(comm);
+
+    REQUIRE(comm_size >= 2);
+
+    /// Every receiver gets the same packing, twice, half of them through the buffered object form
+    auto sendToAll = [&]() {
+        InPlaceObject p;
+        if (comm_rank == 0) {
+            p.fill(6, 2);
+            MEL::Deep::PackedMessage packed;
+            MEL::Deep::Pack(p, packed);
+            for (int round = 0; round < 2; ++round) {
+                for (int dst = 1; dst < comm_size; ++dst) MEL::Deep::Send(packed, dst, round, comm);
+            }
+            REQUIRE(p.matches(6, 2));
+        }
+        else {
+            for (int round = 0; round < 2; ++round) {
+                InPlaceObject q;
+                if ((comm_rank + round) % 2 == 0) {
+                    MEL::Deep::BufferedRecv(q, 0, round, comm);
+                }
+                else {
+                    MEL::Deep::PackedMessage packed;
+                    MEL::Deep::Recv(packed, 0, round, comm);
+                    MEL::Deep::Unpack(q, packed);
+                }
+                REQUIRE(q.matches(6, 2));
+            }
+        }
+    };
+
+    SECTION("Send one packing to every rank") {
+        sendToAll();
+    }
+
+    SECTION("Send one compressed packing to every rank") {
+        ScopedSetting<MEL::Deep::CompressionConfig> guard(MEL::Deep::GetCompressionConfig());
+        MEL::Deep::GetCompressionConfig().enabled   = true;
+        MEL::Deep::GetCompressionConfig().threshold = 0;
+        sendToAll();
+    }
+
+    SECTION("Bcast one packing twice") {
+        MEL::Deep::PackedMessage packed;
+        InPlaceObject p;
+        if (comm_rank == 0) {
+            p.fill(4, 5);
+            MEL::Deep::Pack(p, packed);
+        }
+
+        MEL::Deep::Bcast(packed, 0, comm);
+        if (comm_rank != 0) {
+            MEL::Deep::Unpack(p, packed);
+            REQUIRE(p.matches(4, 5));
+        }
+
+        InPlaceObject q;
+        if (comm_rank == 0) MEL::Deep::Bcast(packed, 0, comm);
+        else                MEL::Deep::BufferedBcast(q, 0, comm);
+        if (comm_rank != 0) { REQUIRE(q.matches(4, 5)); }
+    }
+}
+
+TEST_CASE("Reduce / Allreduce", "[Reduce][Allreduce][Multi]") {
+
+    MEL::Comm comm = MEL::Comm::WORLD;
+    const int comm_rank = MEL::CommRank(comm),
+              comm_size = MEL::CommSize(comm);
+
+    SECTION("Reduce keeps rank order relative to root") {
+        /// Concatenation does not commute, so any reordering of partials shows up in the result
+        auto concat = [](std::vector<int> &into, std::vector<int> &from) { into.insert(into.end(), from.begin(), from.end()); };
+
+        for (int root = 0; root < comm_size; ++root) {
+            std::vector<int> p(comm_rank + 1, comm_rank);
+            MEL::Deep::Reduce(p, concat, root, comm);
+
+            if (comm_rank == root) {
+                std::vector<int> expected;
+                for (int i = 0; i < comm_size; ++i) {
+                    const int r = (root + i) % comm_size;
+                    expected.insert(expected.end(), r + 1, r);
+                }
+                REQUIRE(p == expected);
+            }
+        }
+    }
+
+    SECTION("Reduce a deep object") {
+        auto sum = [](TestObject &into, TestObject &from) {
+            for (size_t i = 0; i < into.arr.size(); ++i) into.arr[i] += from.arr[i];
+        };
+
+        TestObject p(16);
+        MEL::Deep::Reduce(p, sum, 0, comm);
+        if (comm_rank == 0) {
+            for (int i = 0; i < 16; ++i) { REQUIRE(p.arr[i] == i * comm_size); }
+        }
+    }
+
+    SECTION("Allreduce on every rank") {
+        auto join = [](std::set<int> &into, std::set<int> &from) { into.insert(from.begin(), from.end()); };
+
+        std::set<int> p = { comm_rank, comm_rank + 1000 };
+        MEL::Deep::Allreduce(p, join, comm);
+
+        std::set<int> expected;
+        for (int i = 0; i < comm_size; ++i) { expected.insert(i); expected.insert(i + 1000); }
+        REQUIRE(p == expected);
+    }
+
+    SECTION("Allreduce on every sub-communicator size") {
+        auto sum = [](TestObject &into, TestObject &from) {
+            for (size_t i = 0; i < into.arr.size(); ++i) into.arr[i] += from.arr[i];
+        };
+
+        /// Ranks [0, n) of comm for every n, covering the sizes between powers of two
+        for (int n = 1; n <= comm_size; ++n) {
+            MEL::Comm sub = MEL::CommSplit(comm, (comm_rank < n) ? 0 : 1);
+            if (comm_rank < n) {
+                TestObject p(8);
+                for (int i = 0; i < 8; ++i) p.arr[i] += comm_rank;
+                MEL::Deep::Allreduce(p, sum, sub);
+
+                for (int i = 0; i < 8; ++i) { REQUIRE(p.arr[i] == i * n + (n * (n - 1)) / 2); }
+            }
+            MEL::CommFree(sub);
+        }
+    }
+}
+
+/// A reduction that only provides a whole-array kernel, so it cannot be applied element by element
+struct ArrayOnlySum {
+    static int& calls() {
+        static int n = 0;
+        return n;
+    };
+
+    inline void operator()(const int *in, int *inout, const int len) const {
+        ++calls();
+        for (int i = 0; i < len; ++i) inout[i] += in[i];
+    };
+};
+
+template<typename T, typename F>
+void FunctorAllreduce(const MEL::Comm &comm) {
+    const int comm_rank = MEL::CommRank(comm),
+              comm_size = MEL::CommSize(comm);
+
+    /// Not a multiple of any vector width, so the scalar tail runs too
+    const int num = 37;
+    std::vector<T> in(num), out(num);
+    for (int i = 0; i < num; ++i) in[i] = (T) (comm_rank + i);
+
+    MEL::Op op = MEL::OpCreate<T, F>();
+    MEL::Allreduce(&in[0], &out[0], num, op, comm);
+    MEL::OpFree(op);
+
+    F f;
+    for (int i = 0; i < num; ++i) {
+        T expected = (T) i;
+        for (int r = 1; r < comm_size; ++r) expected = f((T) (r + i), expected);
+        REQUIRE(out[i] == expected);
+    }
+}
+
+TEST_CASE("Functor ops", "[Allreduce][Op][Multi]") {
+
+    MEL::Comm comm = MEL::Comm::WORLD;
+    const int comm_rank = MEL::CommRank(comm),
+              comm_size = MEL::CommSize(comm);
+
+    SECTION("Builtin functors") {
+        FunctorAllreduce<float,   MEL::Functor::Sum<float>>(comm);
+        FunctorAllreduce<double,  MEL::Functor::Sum<double>>(comm);
+        FunctorAllreduce<int32_t, MEL::Functor::Sum<int32_t>>(comm);
+        FunctorAllreduce<int64_t, MEL::Functor::Sum<int64_t>>(comm);
+        FunctorAllreduce<double,  MEL::Functor::Prod<double>>(comm);
+        FunctorAllreduce<int32_t, MEL::Functor::Min<int32_t>>(comm);
+        FunctorAllreduce<float,   MEL::Functor::Max<float>>(comm);
+        FunctorAllreduce<int64_t, MEL::Functor::Max<int64_t>>(comm);
+        /// No explicit kernel for this type, it takes the generic loop
+        FunctorAllreduce<int16_t, MEL::Functor::Sum<int16_t>>(comm);
+    }
+
+    SECTION("Lambda") {
+        MEL::Op op = MEL::OpCreate<int>([](const int &a, const int &b) { return a ^ b; });
+
+        std::vector<int> in(37), out(37);
+        for (int i = 0; i < 37; ++i) in[i] = comm_rank * 37 + i;
+        MEL::Allreduce(&in[0], &out[0], 37, op, comm);
+        MEL::OpFree(op);
+
+        for (int i = 0; i < 37; ++i) {
+            int expected = 0;
+            for (int r = 0; r < comm_size; ++r) expected ^= r * 37 + i;
+            REQUIRE(out[i] == expected);
+        }
+    }
+
+    SECTION("Whole-array kernel") {
+        REQUIRE(MEL::Functor::IsArrayKernel<int, ArrayOnlySum>::value);
+        REQUIRE(!MEL::Functor::IsArrayKernel<int, MEL::Functor::Sum<int>>::value);
+
+        ArrayOnlySum::calls() = 0;
+        MEL::Op op = MEL::OpCreate<int, ArrayOnlySum>();
+
+        std::vector<int> in(37), out(37);
+        for (int i = 0; i < 37; ++i) in[i] = comm_rank + i;
+        MEL::Allreduce(&in[0], &out[0], 37, op, comm);
+        MEL::OpFree(op);
+
+        for (int i = 0; i < 37; ++i) REQUIRE(out[i] == i * comm_size + (comm_size * (comm_size - 1)) / 2);
+
+        /// Every rank that combines partials calls the kernel once per partial, on the whole array
+        int calls = ArrayOnlySum::calls(), total = 0;
+        MEL::Allreduce(&calls, &total, 1, MEL::Op::SUM, comm);
+        REQUIRE(total >= comm_size - 1);
+    }
+}
+
+TEST_CASE("RecvAny from several senders", "[Recv][RecvAny][Multi]") {
+
+    MEL::Comm comm = MEL::Comm::WORLD;
+    const int comm_rank = MEL::CommRank(comm),
+              comm_size = MEL::CommSize(comm);
+
+    REQUIRE(comm_size >= 2);
+
+    /// Every sender posts several objects of many envelopes each at once, so unpinned receives would interleave them
+    const int rounds = 4;
+    auto size = [](const int src, const int round) { return 16 + src + round; };
+
+    /// Receives every object in turn and checks it against the sender recv reports
+    auto gather = [&](std::function<int(InPlaceObject&)> recv) {
+        std::vector<int> next(comm_size, 0);
+        for (int i = 0; i < (comm_size - 1) * rounds; ++i) {
+            InPlaceObject q;
+            const int src = recv(q);
+            REQUIRE(src > 0);
+            REQUIRE(src < comm_size);
+            REQUIRE(q.matches(size(src, next[src]), src));
+            ++next[src];
+        }
+        for (int src = 1; src < comm_size; ++src) { REQUIRE(next[src] == rounds); }
+    };
+
+    auto sendAll = [&](const bool buffered) {
+        for (int round = 0; round < rounds; ++round) {
+            InPlaceObject p;
+            p.fill(size(comm_rank, round), comm_rank);
+            if (buffered) MEL::Deep::BufferedSend(p, 0, 0, comm);
+            else          MEL::Deep::Send(p, 0, 0, comm);
+        }
+    };
+
+    SECTION("RecvAny") {
+        if (comm_rank == 0) gather([&](InPlaceObject &q) { return MEL::Deep::RecvAny(q, 0, comm).MPI_SOURCE; });
+        else                sendAll(false);
+    }
+
+    SECTION("Recv from MEL::ANY_SOURCE") {
+        /// Recv has no status, the sender is read back from the contents, which are only consistent if nothing interleaved
+        if (comm_rank == 0) gather([&](InPlaceObject &q) { MEL::Deep::Recv(q, MEL::ANY_SOURCE, 0, comm); return q.vec.empty() ? -1 : q.vec[0][0] - 'a'; });
+        else                sendAll(false);
+    }
+
+    SECTION("BufferedRecvAny") {
+        if (comm_rank == 0) gather([&](InPlaceObject &q) { return MEL::Deep::BufferedRecvAny(q, 0, comm).MPI_SOURCE; });
+        else                sendAll(true);
+    }
+
+    MEL::Barrier(comm);
+}
+
+/// Copied only through a functor, as a type without a DeepCopy method would be
+struct FunctorObject {
+    int len;
+    int *data;
+
+    void fill(const int _len) {
+        len  = _len;
+        data = MEL::MemAlloc<int>(len);
+        for (int i = 0; i < len; ++i) data[i] = i * i;
+    };
+
+    inline bool matches(const int _len) const {
+        if (len != _len || data == nullptr) return false;
+        for (int i = 0; i < len; ++i)
+            if (data[i] != i * i) return false;
+        return true;
+    };
+};
+
+template<typename MSG>
+inline void FunctorObjectCopy(FunctorObject &obj, MSG &msg) {
+    msg.packPtr(obj.data, obj.len);
+};
+
+TEST_CASE("Arena receive with a functor", "[Recv][Bcast][Arena]") {
+
+    using namespace MEL::Deep;
+    typedef PointerHashMap H;
+
+    MEL::Comm comm = MEL::Comm::WORLD;
+    const int comm_rank = MEL::CommRank(comm),
+              comm_size = MEL::CommSize(comm);
+
+    REQUIRE(comm_size == 2);
+
+    Arena arena;
+    FunctorObject p{};
+    if (comm_rank == 0) p.fill(100);
+    const int bufferSize = (comm_rank == 0) ? BufferSize<FunctorObject, H, FunctorObjectCopy<Message<NoTransport, H>>>(p) : 0;
+
+    SECTION("Recv") {
+        if (comm_rank == 0) {
+            Send<FunctorObject, H, FunctorObjectCopy<Message<TransportSend, H>>>(p, 1, 0, comm);
+        }
+        else if (comm_rank == 1) {
+            Recv<FunctorObject, H, FunctorObjectCopy<Message<TransportRecv, H, ArenaAllocator>>>(p, 0, 0, comm, arena);
+            REQUIRE(p.matches(100));
+        }
+    }
+
+    SECTION("BufferedRecv") {
+        if (comm_rank == 0) {
+            BufferedSend<FunctorObject, H, FunctorObjectCopy<Message<TransportBufferWrite, H>>>(p, 1, 0, comm, bufferSize);
+        }
+        else if (comm_rank == 1) {
+            BufferedRecv<FunctorObject, H, FunctorObjectCopy<Message<TransportBufferRead, H, ArenaAllocator>>>(p, 0, 0, comm, arena);
+            REQUIRE(p.matches(100));
+        }
+    }
+
+    SECTION("Bcast") {
+        Bcast<FunctorObject, H, FunctorObjectCopy<Message<TransportBcastRoot, H>>, 
+                                FunctorObjectCopy<Message<TransportBcast, H, ArenaAllocator>>>(p, 0, comm, arena);
+        REQUIRE(p.matches(100));
+    }
+
+    SECTION("BufferedBcast") {
+        BufferedBcast<FunctorObject, H, FunctorObjectCopy<Message<TransportBufferWrite, H>>, 
+                                        FunctorObjectCopy<Message<TransportBufferRead, H, ArenaAllocator>>>(p, 0, comm, bufferSize, arena);
+        REQUIRE(p.matches(100));
+    }
+
+    SECTION("Bcast a pointer") {
+        FunctorObject *q = (comm_rank == 0) ? &p : nullptr;
+        Bcast<FunctorObject*, H, FunctorObjectCopy<Message<TransportBcastRoot, H>>, 
+                                 FunctorObjectCopy<Message<TransportBcast, H, ArenaAllocator>>>(q, 0, comm, arena);
+        REQUIRE(q->matches(100));
+    }
+
+    /// Everything received on rank 1 lives in the arena
+    if (comm_rank == 0) MEL::MemFree(p.data);
+    arena.release();
+}
+
+/// A chain of nodes each owning an array, which an Arena receive allocates entirely from the arena
+struct ArenaNode {
+    int value, len;
+    int *data;
+    ArenaNode *next;
+
+    void fill(const int _value, const int depth) {
+        value = _value;
+        len   = value % 7 + 1;
+        data  = MEL::MemAlloc<int>(len);
+        for (int i = 0; i < len; ++i) data[i] = value * i;
+        next  = nullptr;
+        if (depth > 0) {
+            next = MEL::MemAlloc<ArenaNode>(1);
+            next->fill(value + 1, depth - 1);
+        }
+    };
+
+    void free() {
+        if (next != nullptr) {
+            next->free();
+            MEL::MemFree(next);
+        }
+        MEL::MemFree(data);
+    };
+
+    inline bool matches(const int _value, const int depth) const {
+        if (value != _value || len != value % 7 + 1 || data == nullptr) return false;
+        for (int i = 0; i < len; ++i)
+            if (data[i] != value * i) return false;
+        if (depth == 0) return next == nullptr;
+        return next != nullptr && next->matches(value + 1, depth - 1);
+    };
+
+    /// Bytes the receiver allocates for everything this node points to
+    static size_t bytes(const int _value, const int depth) {
+        const size_t own = (_value % 7 + 1) * sizeof(int);
+        return (depth == 0) ? own : (own + sizeof(ArenaNode) + bytes(_value + 1, depth - 1));
+    };
+
+    template<typename MSG>
+    inline void DeepCopy(MSG &msg) {
+        msg.packPtr(data, len);
+        msg.packPtr(next);
+    };
+};
+
+TEST_CASE("Arena receive", "[Recv][Bcast][Arena]") {
+
+    MEL::Comm comm = MEL::Comm::WORLD;
+    const int comm_rank = MEL::CommRank(comm),
+              comm_size = MEL::CommSize(comm);
+
+    REQUIRE(comm_size == 2);
+
+    const int count = 4, depth = 5;
+
+    /// Blocks much smaller than a graph, so only the buffered reserve keeps it in one block
+    MEL::Deep::Arena arena(64);
+
+    /// count chains, starting at values 0, 10, 20, ...
+    auto chainBytes = [&]() {
+        size_t total = 0;
+        for (int i = 0; i < count; ++i) total += ArenaNode::bytes(i * 10, depth);
+        return total;
+    };
+    auto fillAll = [&](ArenaNode *nodes) {
+        for (int i = 0; i < count; ++i) nodes[i].fill(i * 10, depth);
+    };
+    auto matchesAll = [&](const ArenaNode *nodes) {
+        for (int i = 0; i < count; ++i)
+            if (!nodes[i].matches(i * 10, depth)) return false;
+        return true;
+    };
+    auto freeAll = [&](ArenaNode *nodes) {
+        for (int i = 0; i < count; ++i) nodes[i].free();
+    };
+
+    SECTION("Pointer / length") {
+        ArenaNode *p = nullptr;
+        int len = 0;
+        if (comm_rank == 0) {
+            len = count;
+            p = MEL::MemAlloc<ArenaNode>(count);
+            fillAll(p);
+        }
+        const size_t expected = chainBytes() + count * sizeof(ArenaNode);
+
+        SECTION("Recv") {
+            if (comm_rank == 0) MEL::Deep::Send(p, len, 1, 0, comm);
+            else                MEL::Deep::Recv(p, len, 0, 0, comm, arena);
+            REQUIRE(len == count);
+        }
+
+        SECTION("BufferedRecv with a const length") {
+            const int clen = count;
+            if (comm_rank == 0) MEL::Deep::BufferedSend(p, clen, 1, 0, comm);
+            else                MEL::Deep::BufferedRecv(p, clen, 0, 0, comm, arena);
+            if (comm_rank == 1) { REQUIRE(arena.getNumBlocks() == 1); }
+        }
+
+        SECTION("Bcast") {
+            MEL::Deep::Bcast(p, len, 0, comm, arena);
+            REQUIRE(len == count);
+        }
+
+        SECTION("BufferedBcast with a const length") {
+            const int clen = count;
+            MEL::Deep::BufferedBcast(p, clen, 0, comm, arena);
+            if (comm_rank == 1) { REQUIRE(arena.getNumBlocks() == 1); }
+        }
+
+        REQUIRE(matchesAll(p));
+        if (comm_rank == 0) {
+            freeAll(p);
+            MEL::MemFree(p);
+        }
+        else {
+            REQUIRE(arena.getBytesUsed() == expected);
+        }
+    }
+
+    SECTION("std::vector") {
+        std::vector<ArenaNode> p;
+        if (comm_rank == 0) {
+            p.resize(count);
+            fillAll(p.data());
+        }
+
+        SECTION("Recv") {
+            if (comm_rank == 0) MEL::Deep::Send(p, 1, 0, comm);
+            else                MEL::Deep::Recv(p, 0, 0, comm, arena);
+        }
+
+        SECTION("BufferedRecv") {
+            if (comm_rank == 0) MEL::Deep::BufferedSend(p, 1, 0, comm);
+            else                MEL::Deep::BufferedRecv(p, 0, 0, comm, arena);
+            if (comm_rank == 1) { REQUIRE(arena.getNumBlocks() == 1); }
+        }
+
+        SECTION("Bcast") {
+            MEL::Deep::Bcast(p, 0, comm, arena);
+        }
+
+        SECTION("BufferedBcast") {
+            MEL::Deep::BufferedBcast(p, 0, comm, arena);
+            if (comm_rank == 1) { REQUIRE(arena.getNumBlocks() == 1); }
+        }
+
+        REQUIRE(p.size() == (size_t) count);
+        REQUIRE(matchesAll(p.data()));
+        if (comm_rank == 0) freeAll(p.data());
+        else                { REQUIRE(arena.getBytesUsed() == chainBytes()); }
+    }
+
+    SECTION("Pointer") {
+        ArenaNode *p = nullptr;
+        if (comm_rank == 0) {
+            p = MEL::MemAlloc<ArenaNode>(1);
+            p->fill(3, depth);
+        }
+
+        SECTION("Recv") {
+            if (comm_rank == 0) MEL::Deep::Send(p, 1, 0, comm);
+            else                MEL::Deep::Recv(p, 0, 0, comm, arena);
+            /// Unbuffered receives allocate as they go, one block at a time
+            if (comm_rank == 1) { REQUIRE(arena.getNumBlocks() > 1); }
+        }
+
+        SECTION("BufferedBcast") {
+            MEL::Deep::BufferedBcast(p, 0, comm, arena);
+            if (comm_rank == 1) { REQUIRE(arena.getNumBlocks() == 1); }
+        }
+
+        REQUIRE(p->matches(3, depth));
+        if (comm_rank == 0) {
+            p->free();
+            MEL::MemFree(p);
+        }
+        else {
+            REQUIRE(arena.getBytesUsed() == ArenaNode::bytes(3, depth) + sizeof(ArenaNode));
+        }
+    }
+
+    /// Everything received lives in the arena and goes with one release
+    arena.release();
+    REQUIRE(arena.getBytesUsed() == 0);
+    REQUIRE(arena.getNumBlocks() == 0);
+}
+
+#ifdef _OPENMP
+/// Elements i and j share their common object when i % 3 == j % 3, so most shared pointers cross chunks
+struct ParallelElement {
+    int id;
+    std::vector<int> data;
+    std::shared_ptr<TestObject> common;
+
+    static std::vector<ParallelElement> Make(const int len) {
+        std::shared_ptr<TestObject> commons[3] = { std::make_shared<TestObject>(5), std::make_shared<TestObject>(6), std::make_shared<TestObject>(7) };
+        std::vector<ParallelElement> vec(len);
+        for (int i = 0; i < len; ++i) {
+            vec[i].id     = i;
+            vec[i].data   = std::vector<int>(i % 11, i);
+            vec[i].common = commons[i % 3];
+        }
+        return vec;
+    };
+
+    static bool Matches(const std::vector<ParallelElement> &vec, const int len) {
+        if (vec.size() != (size_t) len) return false;
+        for (int i = 0; i < len; ++i) {
+            if (vec[i].id != i || vec[i].data != std::vector<int>(i % 11, i)) return false;
+            if (!vec[i].common || !(*vec[i].common == TestObject(5 + i % 3))) return false;
+            if (i >= 3 && vec[i].common != vec[i - 3].common) return false;
+        }
+        return len < 3 || (vec[0].common != vec[1].common && vec[1].common != vec[2].common);
+    };
+
+    template<typename MSG>
+    inline void DeepCopy(MSG &msg) {
+        msg & data & common;
+    };
+};
+
+TEST_CASE("OpenMP parallel pack / unpack", "[OMP][PackedMessage]") {
+
+    MEL::Comm comm = MEL::Comm::WORLD;
+    const int comm_rank = MEL::CommRank(comm),
+              comm_size = MEL::CommSize(comm);
+
+    REQUIRE(comm_size == 2);
+
+    ScopedSetting<MEL::OMP::Deep::PackConfig> guard(MEL::OMP::Deep::GetPackConfig());
+    MEL::OMP::Deep::GetPackConfig().minElements = 16;
+    MEL::OMP::Deep::GetPackConfig().maxThreads  = 4;
+
+    const int len = 500;
+    auto isParallel = [](MEL::Deep::PackedMessage &packed) {
+        int head;
+        std::memcpy(&head, packed.data(), sizeof(int));
+        return head < 0;
+    };
+
+    SECTION("Parallel pack, serial unpack") {
+        std::vector<ParallelElement> p = ParallelElement::Make(len), q;
+        MEL::Deep::PackedMessage packed;
+        MEL::OMP::Deep::Pack(p, packed);
+        REQUIRE(isParallel(packed));
+        MEL::Deep::Unpack(q, packed);
+        REQUIRE(ParallelElement::Matches(q, len));
+    }
+
+    SECTION("Serial pack, parallel unpack") {
+        std::vector<ParallelElement> p = ParallelElement::Make(len), q;
+        MEL::Deep::PackedMessage packed;
+        MEL::Deep::Pack(p, packed);
+        REQUIRE(!isParallel(packed));
+        MEL::OMP::Deep::Unpack(q, packed);
+        REQUIRE(ParallelElement::Matches(q, len));
+    }
+
+    SECTION("Parallel pack, parallel unpack") {
+        std::vector<ParallelElement> p = ParallelElement::Make(len), q;
+        MEL::Deep::PackedMessage packed;
+        MEL::OMP::Deep::Pack(p, packed);
+        MEL::OMP::Deep::Unpack(q, packed);
+        REQUIRE(ParallelElement::Matches(q, len));
+
+        /// Without shared pointers the chunks unpack concurrently
+        std::vector<TestObject> r(len), t;
+        for (int i = 0; i < len; ++i) r[i] = TestObject(i % 17);
+        MEL::OMP::Deep::Pack(r, packed);
+        REQUIRE(isParallel(packed));
+        MEL::OMP::Deep::Unpack(t, packed);
+        REQUIRE(t == r);
+    }
+
+    SECTION("Parallel send, serial receive") {
+        std::vector<ParallelElement> p;
+        if (comm_rank == 0) {
+            p = ParallelElement::Make(len);
+            MEL::OMP::Deep::BufferedSend(p, 1, 0, comm);
+        }
+        else if (comm_rank == 1) {
+            MEL::Deep::BufferedRecv(p, 0, 0, comm);
+        }
+        REQUIRE(ParallelElement::Matches(p, len));
+    }
+
+    SECTION("Serial send, parallel receive") {
+        std::vector<ParallelElement> p;
+        if (comm_rank == 0) {
+            p = ParallelElement::Make(len);
+            MEL::Deep::BufferedSend(p, 1, 0, comm);
+        }
+        else if (comm_rank == 1) {
+            MEL::OMP::Deep::BufferedRecv(p, 0, 0, comm);
+        }
+        REQUIRE(ParallelElement::Matches(p, len));
+    }
+
+    SECTION("Parallel broadcast") {
+        std::vector<ParallelElement> p;
+        if (comm_rank == 0) p = ParallelElement::Make(len);
+        MEL::OMP::Deep::BufferedBcast(p, 0, comm);
+        REQUIRE(ParallelElement::Matches(p, len));
+    }
+}
+#endif
+
+TEST_CASE("Collective file", "[File][Multi]") {
+
+    MEL::Comm comm = MEL::Comm::WORLD;
+    const int comm_rank = MEL::CommRank(comm),
+              comm_size = MEL::CommSize(comm);
+
+    /// Piece i holds a distinct object of a distinct size
+    auto piece = [](const int i, const int section) { return TestObject(i * 3 + section + 1); };
+
+    /// Written by ranks [0, n) for every n, read back by those ranks and by the whole of comm
+    for (int n = 1; n <= comm_size; ++n) {
+        MEL::Comm sub = MEL::CommSplit(comm, (comm_rank < n) ? 0 : 1);
+
+        /// Two collective sections back to back, the second at the offset the first returns
+        MEL::Offset second = 0;
+        if (comm_rank < n) {
+            MEL::File file = MEL::FileOpen(sub, "collective.tmp", MEL::FileMode::CREATE | MEL::FileMode::WRONLY);
+            TestObject p = piece(comm_rank, 0), q = piece(comm_rank, 1);
+            second = MEL::Deep::FileWriteAll(p, file, sub);
+            MEL::Deep::FileWriteAll(q, file, sub, second);
+            MEL::FileClose(file);
+        }
+        MEL::Bcast(&second, 1, 0, comm);
+
+        if (comm_rank < n) {
+            TestObject p, q;
+            MEL::File file = MEL::FileOpen(sub, "collective.tmp", MEL::FileMode::RDONLY);
+            MEL::Deep::FileReadAll(p, file, sub);
+            MEL::Deep::FileReadAll(q, file, sub, second);
+            MEL::FileClose(file);
+            REQUIRE(p == piece(comm_rank, 0));
+            REQUIRE(q == piece(comm_rank, 1));
+        }
+
+        /// Every rank of comm reads a contiguous run of the n pieces, some of them none
+        std::vector<TestObject> objs;
+        MEL::File file = MEL::FileOpen(comm, "collective.tmp", MEL::FileMode::DELETE_ON_CLOSE | MEL::FileMode::RDONLY);
+        MEL::Deep::FileReadAll(objs, file, comm, second);
+        MEL::FileClose(file);
+
+        const int begin = (n * comm_rank) / comm_size, end = (n * (comm_rank + 1)) / comm_size;
+        REQUIRE(objs.size() == (size_t) (end - begin));
+        for (int i = begin; i < end; ++i) { REQUIRE(objs[i - begin] == piece(i, 1)); }
+
+        int total = (int) objs.size(), sum = 0;
+        MEL::Allreduce(&total, &sum, 1, MEL::Datatype::INT, MEL::Op::SUM, comm);
+        REQUIRE(sum == n);
+
+        MEL::CommFree(sub);
+    }
+}
+
+TEST_CASE("Checkpointer", "[Checkpoint][File][Multi]") {
+
+    MEL::Comm comm = MEL::Comm::WORLD;
+    const int comm_rank = MEL::CommRank(comm);
+
+    const int numFiles = 3, steps = 5;
+    auto payload = [&](const int step) { return TestObject(comm_rank + step * 10 + 1); };
+
+    {
+        MEL::Deep::Checkpointer checkpointer(comm, "checkpoint.tmp", numFiles);
+        REQUIRE(checkpointer.getLastPath().empty());
+
+        for (int step = 0; step < steps; ++step) {
+            TestObject p = payload(step);
+            checkpointer.write(p);
+            /// Overwriting the object does not change the checkpoint in flight, it was packed by write()
+            p = TestObject(0);
+            REQUIRE(checkpointer.getLastPath() == checkpointer.getPath(step % numFiles));
+        }
+        checkpointer.wait();
+
+        const MEL::Deep::CheckpointStats &stats = checkpointer.getStats();
+        REQUIRE(stats.checkpoints == steps);
+        REQUIRE(stats.bytes > 0);
+
+        TestObject p;
+        MEL::File file = MEL::FileOpen(comm, checkpointer.getLastPath(), MEL::FileMode::RDONLY);
+        MEL::Deep::FileReadAll(p, file, comm);
+        MEL::FileClose(file);
+        REQUIRE(p == payload(steps - 1));
+    }
+
+    /// Every file in the rotation holds the last checkpoint written to it
+    for (int i = 0; i < numFiles; ++i) {
+        int step = steps - 1;
+        while ((step % numFiles) != i) --step;
+
+        TestObject p;
+        MEL::File file = MEL::FileOpen(comm, "checkpoint.tmp." + std::to_string(i), MEL::FileMode::DELETE_ON_CLOSE | MEL::FileMode::RDONLY);
+        MEL::Deep::FileReadAll(p, file, comm);
+        MEL::FileClose(file);
+        REQUIRE(p == payload(step));
+    }
+}
+
+struct SnapshotLeaf {
+    int id, n;
+    int *values;
+
+    SnapshotLeaf() : id(0), n(0), values(nullptr) {};
+
+    template<typename MSG>
+    inline void DeepCopy(MSG &msg) {
+        msg.packPtr(values, n);
+    };
+};
+
+struct SnapshotRoot {
+    int count;
+    SnapshotLeaf *leaves, *sharedA, *sharedB, *missing;
+
+    template<typename MSG>
+    inline void DeepCopy(MSG &msg) {
+        msg.packPtr(leaves, count);
+        msg.packSharedPtr(sharedA);
+        msg.packSharedPtr(sharedB);
+        msg.packPtr(missing);
+    };
+};
+
+TEST_CASE("Snapshot", "[Snapshot][Multi]") {
+
+    MEL::Comm comm = MEL::Comm::WORLD;
+    const int comm_rank = MEL::CommRank(comm);
+    const std::string path = "snapshot.tmp." + std::to_string(comm_rank);
+
+    auto fillLeaf = [&](SnapshotLeaf &leaf, const int id) {
+        leaf.id = id;
+        leaf.n  = id + 2;
+        leaf.values = MEL::MemAlloc<int>(leaf.n);
+        for (int j = 0; j < leaf.n; ++j) leaf.values[j] = comm_rank + id * 100 + j;
+    };
+
+    auto checkLeaf = [&](const SnapshotLeaf &leaf, const int *values, const int id) {
+        REQUIRE(leaf.id == id);
+        REQUIRE(leaf.n == id + 2);
+        REQUIRE(values != nullptr);
+        for (int j = 0; j < leaf.n; ++j) REQUIRE(values[j] == comm_rank + id * 100 + j);
+    };
+
+    SnapshotRoot root;
+    root.count  = 4;
+    root.leaves = MEL::MemAlloc<SnapshotLeaf>(root.count);
+    for (int i = 0; i < root.count; ++i) fillLeaf(root.leaves[i], i);
+    SnapshotLeaf *common = MEL::MemConstruct<SnapshotLeaf>();
+    fillLeaf(*common, 7);
+    root.sharedA = common;
+    root.sharedB = common;
+    root.missing = nullptr;
+
+    MEL::Deep::SnapshotWrite(root, path);
+
+    /// Writing the image leaves the source graph untouched
+    REQUIRE(root.sharedA == common);
+    REQUIRE(root.leaves[0].values[0] == comm_rank);
+
+    SECTION("Offsets") {
+        MEL::Deep::Snapshot snapshot(path);
+        const SnapshotRoot *r = snapshot.root<SnapshotRoot>();
+        REQUIRE(r != nullptr);
+        REQUIRE(r->count == root.count);
+
+        /// Pointer fields hold file offsets until they are resolved
+        REQUIRE(r->leaves != nullptr);
+        REQUIRE((size_t) r->leaves < snapshot.getSize());
+
+        const SnapshotLeaf *leaves = snapshot.resolve(r->leaves);
+        for (int i = 0; i < root.count; ++i) checkLeaf(leaves[i], snapshot.resolve(leaves[i].values), i);
+
+        /// Both shared fields resolve to the single stored copy
+        REQUIRE(r->sharedA == r->sharedB);
+        const SnapshotLeaf *shared = snapshot.resolve(r->sharedA);
+        checkLeaf(*shared, snapshot.resolve(shared->values), 7);
+
+        REQUIRE(r->missing == nullptr);
+        REQUIRE(snapshot.resolve(r->missing) == nullptr);
+    }
+
+    SECTION("Fixup") {
+        MEL::Deep::Snapshot snapshot(path, true);
+        SnapshotRoot *r = snapshot.root<SnapshotRoot>();
+        REQUIRE(r != nullptr);
+        REQUIRE(r->count == root.count);
+
+        /// Fixed up fields are real pointers into the mapping, and resolve() passes them through
+        REQUIRE(snapshot.resolve(r->leaves) == r->leaves);
+        REQUIRE(r->leaves != root.leaves);
+        for (int i = 0; i < root.count; ++i) checkLeaf(r->leaves[i], r->leaves[i].values, i);
+
+        REQUIRE(r->sharedA == r->sharedB);
+        REQUIRE(r->sharedA != common);
+        checkLeaf(*r->sharedA, r->sharedA->values, 7);
+
+        REQUIRE(r->missing == nullptr);
+
+        /// The mapping is private, so the graph can be modified in place
+        r->leaves[0].values[0] = -1;
+        REQUIRE(r->leaves[0].values[0] == -1);
+        REQUIRE(root.leaves[0].values[0] == comm_rank);
+    }
+
+    /// A second private mapping starts from the unmodified file
+    {
+        MEL::Deep::Snapshot snapshot(path, true);
+        SnapshotRoot *r = snapshot.root<SnapshotRoot>();
+        checkLeaf(r->leaves[0], r->leaves[0].values, 0);
+    }
+    std::remove(path.c_str());
+
+    for (int i = 0; i < root.count; ++i) MEL::MemFree(root.leaves[i].values);
+    MEL::MemFree(root.leaves);
+    MEL::MemFree(common->values);
+    MEL::MemDestruct(common);
+}
+
+TEST_CASE("Local file", "[LocalFile][File][Multi]") {
+
+    MEL::Comm comm = MEL::Comm::WORLD;
+    const int comm_rank = MEL::CommRank(comm);
+    const std::string path = "localfile.tmp." + std::to_string(comm_rank);
+
+    /// Small blocks so the payload straddles block boundaries and wraps the ring many times
+    ScopedSetting<MEL::Deep::LocalFileConfig> config(MEL::Deep::GetLocalFileConfig());
+    MEL::Deep::GetLocalFileConfig().blockSize  = 4096;
+    MEL::Deep::GetLocalFileConfig().queueDepth = 3;
+    MEL::Deep::GetLocalFileConfig().alignment  = 4096;
+
+    auto fileSize = [&]() -> long long {
+        struct stat st;
+        REQUIRE(stat(path.c_str(), &st) == 0);
+        return (long long) st.st_size;
+    };
+
+    /// Object sizes chosen so that no message is a multiple of the block size
+    const int numObjects = 24, half = numObjects / 2;
+    auto payload = [&](const int i) { return TestObject(comm_rank + i * 97 + 1); };
+
+    auto roundTrip = [&]() {
+        bool direct;
+        {
+            MEL::Deep::LocalFile file(path, MEL::Deep::LocalFile::Mode::WRITE);
+            direct = file.isDirect();
+            INFO("direct " << direct);
+
+            for (int i = 0; i < half; ++i) {
+                TestObject p = payload(i);
+                MEL::Deep::FileWrite(p, file);
+            }
+
+            /// sync() leaves a complete, exactly sized file while the partial block stays open for writing
+            file.sync();
+            const long long synced = file.getPosition();
+            REQUIRE((synced % 4096) != 0);
+            REQUIRE(fileSize() == synced);
+            {
+                MEL::Deep::LocalFile reader(path, MEL::Deep::LocalFile::Mode::READ);
+                for (int i = 0; i < half; ++i) {
+                    TestObject p;
+                    MEL::Deep::FileRead(p, reader);
+                    REQUIRE(p == payload(i));
+                }
+                char byte;
+                REQUIRE(reader.read(&byte, 1) == 0);
+            }
+
+            for (int i = half; i < numObjects; ++i) {
+                TestObject p = payload(i);
+                MEL::Deep::FileWrite(p, file);
+            }
+
+            /// Raw writes smaller than, equal to and larger than a block
+            std::vector<char> raw(3 * 4096 + 123);
+            for (size_t j = 0; j < raw.size(); ++j) raw[j] = (char) (j * 31 + comm_rank);
+            file.write(&raw[0], 1);
+            file.write(&raw[1], 4096);
+            file.write(&raw[4097], (long long) raw.size() - 4097);
+            file.close();
+        }
+        INFO("direct " << direct);
+
+        MEL::Deep::LocalFile file(path, MEL::Deep::LocalFile::Mode::READ);
+        for (int i = 0; i < numObjects; ++i) {
+            TestObject p;
+            MEL::Deep::FileRead(p, file);
+            REQUIRE(p == payload(i));
+        }
+
+        /// Odd sized reads across the read-ahead window, the last one cut short by the end of the file
+        std::vector<char> raw(3 * 4096 + 123);
+        REQUIRE(file.read(&raw[0], 5000) == 5000);
+        REQUIRE(file.read(&raw[5000], 7) == 7);
+        REQUIRE(file.read(&raw[5007], (long long) raw.size()) == (long long) raw.size() - 5007);
+        for (size_t j = 0; j < raw.size(); ++j) REQUIRE(raw[j] == (char) (j * 31 + comm_rank));
+        REQUIRE(file.read(&raw[0], 1) == 0);
+
+        /// Direct writes pad the last block, close() truncates it away again
+        REQUIRE(fileSize() == file.getPosition());
+        file.close();
+        std::remove(path.c_str());
+    };
+
+    SECTION("Direct") {
+        MEL::Deep::GetLocalFileConfig().direct = true;
+        roundTrip();
+    }
+
+    SECTION("Buffered") {
+        MEL::Deep::GetLocalFileConfig().direct = false;
+        roundTrip();
+    }
+}
+
+TEST_CASE("Hierarchical collectives", "[Bcast][Allreduce][Gather][Hierarchical][Multi]") {
+
+    MEL::Comm world = MEL::Comm::WORLD;
+    const int world_rank = MEL::CommRank(world);
+
+    /// One machine is a single node, so modelled layouts are set to reach the node and leader paths on 3 or more processes
+    MEL::Comm comm;
+    bool modelled = true;
+    SECTION("Shared memory nodes") {
+        modelled = false;
+        comm = MEL::CommDuplicate(world);
+    }
+    SECTION("Blocked nodes") {
+        comm = MEL::CommDuplicate(world);
+        MEL::CommSetHierarchy(comm, MEL::CommSplit(comm, MEL::CommRank(comm) / 2));
+    }
+    SECTION("Interleaved nodes") {
+        comm = MEL::CommDuplicate(world);
+        MEL::CommSetHierarchy(comm, MEL::CommSplit(comm, MEL::CommRank(comm) % 2));
+    }
+    SECTION("Sub-communicator") {
+        /// Ranks in the sub-communicator differ from ranks in world
+        comm = MEL::CommSplit(world, world_rank % 2);
+        MEL::CommSetHierarchy(comm, MEL::CommSplit(comm, MEL::CommRank(comm) % 2));
+    }
+
+    const int comm_rank = MEL::CommRank(comm),
+              comm_size = MEL::CommSize(comm);
+    const MEL::CommHierarchy &hierarchy = MEL::CommGetHierarchy(comm);
+    REQUIRE((int) hierarchy.nodeOf.size() == comm_size);
+    if (modelled && comm_size >= 3) REQUIRE(!hierarchy.flat());
+
+    for (int root = 0; root < comm_size; ++root) {
+        INFO("root " << root << " of " << comm_size << ", " << hierarchy.numNodes << " nodes");
+
+        {
+            int values[5];
+            for (int j = 0; j < 5; ++j) values[j] = (comm_rank == root) ? (root * 10 + j) : -1;
+            MEL::HierarchicalBcast(values, 5, root, comm);
+            for (int j = 0; j < 5; ++j) REQUIRE(values[j] == root * 10 + j);
+        }
+
+        {
+            std::vector<int> sent(3), gathered((comm_rank == root) ? (3 * comm_size) : 1, -1);
+            for (int j = 0; j < 3; ++j) sent[j] = comm_rank * 10 + j;
+            MEL::HierarchicalGather(&sent[0], 3, &gathered[0], 3, root, comm);
+            if (comm_rank == root) {
+                for (int i = 0; i < comm_size; ++i) 
+                    for (int j = 0; j < 3; ++j) REQUIRE(gathered[3 * i + j] == i * 10 + j);
+            }
+        }
+
+        {
+            TestObject p;
+            if (comm_rank == root) p = TestObject(root + 3);
+            MEL::Deep::HierarchicalBcast(p, root, comm);
+            REQUIRE(p == TestObject(root + 3));
+        }
+
+        {
+            int *p = nullptr, len = 0;
+            if (comm_rank == root) {
+                len = root + 2;
+                p = MEL::MemAlloc<int>(len);
+                for (int i = 0; i < len; ++i) p[i] = root + i;
+            }
+            MEL::Deep::HierarchicalBcast(p, len, root, comm);
+            REQUIRE(len == root + 2);
+            REQUIRE(p != nullptr);
+            for (int i = 0; i < len; ++i) REQUIRE(p[i] == root + i);
+            MEL::MemFree(p);
+        }
+
+        {
+            std::vector<TestObject> p;
+            if (comm_rank == root) p.assign(4, TestObject(100 + root));
+            MEL::Deep::BufferedHierarchicalBcast(p, root, comm);
+            REQUIRE(p.size() == 4);
+            for (size_t i = 0; i < p.size(); ++i) REQUIRE(p[i] == TestObject(100 + root));
+        }
+    }
+
+    {
+        int value = comm_rank + 1, sum = 0;
+        MEL::HierarchicalAllreduce(&value, &sum, 1, MEL::Datatype::INT, MEL::Op::SUM, comm);
+        REQUIRE(sum == comm_size * (comm_size + 1) / 2);
+
+        int inPlace[2] = { comm_rank, 1 };
+        MEL::HierarchicalAllreduce(MPI_IN_PLACE, inPlace, 2, MEL::Datatype::INT, MEL::Op::SUM, comm);
+        REQUIRE(inPlace[0] == comm_size * (comm_size - 1) / 2);
+        REQUIRE(inPlace[1] == comm_size);
+    }
+
+    MEL::CommFree(comm);
+}
+
+TEST_CASE("Datatype cache", "[TypeCache][Multi]") {
+
+    /// Restores the default capacity, even if a REQUIRE fails part way through
+    struct CapacityGuard {
+        ~CapacityGuard() {
+            MEL::TypeCacheSetCapacity(256);
+        };
+    } guard;
+
+    MEL::TypeCacheClear();
+    auto stats = [](const MEL::TypeCacheStats &before) {
+        const MEL::TypeCacheStats now = MEL::TypeCacheGetStats();
+        MEL::TypeCacheStats delta;
+        delta.hits      = now.hits      - before.hits;
+        delta.misses    = now.misses    - before.misses;
+        delta.evictions = now.evictions - before.evictions;
+        return delta;
+    };
+
+    SECTION("Hits and reference counts") {
+        const MEL::TypeCacheStats before = MEL::TypeCacheGetStats();
+
+        MEL::Datatype a = MEL::TypeCacheCreateContiguous(MEL::Datatype::INT, 4),
+                      b = MEL::TypeCacheCreateContiguous(MEL::Datatype::INT, 4),
+                      c = MEL::TypeCacheCreateContiguous(MEL::Datatype::INT, 5);
+        REQUIRE(a == b);
+        REQUIRE(!(a == c));
+        REQUIRE(MEL::TypeSize(a) == 4 * (int) sizeof(int));
+        REQUIRE(stats(before).hits == 1);
+        REQUIRE(stats(before).misses == 2);
+
+        /// The type stays owned until every handle returned for it is released
+        const MEL::Datatype handle = a;
+        MEL::TypeCacheRelease(a);
+        REQUIRE(a == MEL::Datatype::DATATYPE_NULL);
+        REQUIRE(MEL::TypeCacheOwns(handle));
+        MEL::TypeCacheRelease(b);
+        REQUIRE(!MEL::TypeCacheOwns(handle));
+
+        /// Released types stay cached until evicted
+        MEL::Datatype d = MEL::TypeCacheCreateContiguous(MEL::Datatype::INT, 4);
+        REQUIRE(d == handle);
+        REQUIRE(stats(before).hits == 2);
+        MEL::TypeCacheRelease(d, c);
+
+        MEL::TypeCacheClear();
+        REQUIRE(stats(before).evictions == 2);
+        REQUIRE(!MEL::TypeCacheOwns(handle));
+    }
+
+    SECTION("Least recently used eviction") {
+        MEL::TypeCacheSetCapacity(2);
+        const MEL::TypeCacheStats before = MEL::TypeCacheGetStats();
+
+        auto touch = [](const int length) {
+            MEL::Datatype t = MEL::TypeCacheCreateContiguous(MEL::Datatype::INT, length);
+            REQUIRE(MEL::TypeSize(t) == length * (int) sizeof(int));
+            MEL::TypeCacheRelease(t);
+        };
+
+        touch(1);
+        touch(2);
+        touch(3);
+        REQUIRE(stats(before).misses == 3);
+        REQUIRE(stats(before).evictions == 1);
+
+        /// 1 was evicted. Using 2 makes 3 the least recently used, so bringing 1 back evicts 3
+        touch(2);
+        REQUIRE(stats(before).hits == 1);
+        touch(1);
+        REQUIRE(stats(before).misses == 4);
+        REQUIRE(stats(before).evictions == 2);
+        touch(2);
+        REQUIRE(stats(before).hits == 2);
+        touch(3);
+        REQUIRE(stats(before).misses == 5);
+    }
+
+    SECTION("Types in use are never evicted") {
+        MEL::TypeCacheSetCapacity(0);
+        const MEL::TypeCacheStats before = MEL::TypeCacheGetStats();
+
+        MEL::Datatype held = MEL::TypeCacheCreateVector(MEL::Datatype::DOUBLE, 3, 1, 2);
+        const MEL::Datatype handle = held;
+        MEL::TypeCacheClear();
+        REQUIRE(MEL::TypeCacheOwns(handle));
+        REQUIRE(stats(before).evictions == 0);
+
+        /// A cached type built on a cached base holds the base until it is evicted itself
+        MEL::Datatype outer = MEL::TypeCacheCreateContiguous(held, 2);
+        REQUIRE(MEL::TypeSize(outer) == 6 * (int) sizeof(double));
+        MEL::TypeCacheRelease(held);
+        REQUIRE(stats(before).evictions == 0);
+
+        MEL::TypeCacheRelease(outer);
+        REQUIRE(stats(before).evictions == 2);
+        REQUIRE(!MEL::TypeCacheOwns(handle));
+    }
+
+    SECTION("Types the cache did not create") {
+        const MEL::TypeCacheStats before = MEL::TypeCacheGetStats();
+
+        REQUIRE(!MEL::TypeCacheOwns(MEL::Datatype::INT));
+
+        MEL::Datatype user = MEL::TypeCreateContiguous(MEL::Datatype::INT, 4);
+        REQUIRE(!MEL::TypeCacheOwns(user));
+
+        /// Uncached bases are matched by contents, so an equal type built separately hits
+        MEL::Datatype a = MEL::TypeCacheCreateContiguous(user, 2);
+        MEL::Datatype other = MEL::TypeCreateContiguous(MEL::Datatype::INT, 4);
+        MEL::Datatype b = MEL::TypeCacheCreateContiguous(other, 2);
+        REQUIRE(a == b);
+        REQUIRE(stats(before).hits == 1);
+        REQUIRE(MEL::TypeCacheOwns(a));
+        REQUIRE(!MEL::TypeCacheOwns(user));
+        MEL::TypeCacheRelease(a, b);
+        MEL::TypeFree(user, other);
+
+        /// A freed handle reused for a different type does not return the stale entry
+        MEL::Datatype reused = MEL::TypeCreateContiguous(MEL::Datatype::INT, 6);
+        MEL::Datatype c = MEL::TypeCacheCreateContiguous(reused, 2);
+        REQUIRE(MEL::TypeSize(c) == 12 * (int) sizeof(int));
+        REQUIRE(stats(before).misses == 2);
+        MEL::TypeCacheRelease(c);
+        MEL::TypeFree(reused);
+    }
+
+    MEL::TypeCacheClear();
+}
+
 std::ofstream localOut, localErr;
 
 std::ostream& Catch::cout() {
@@ -953,6 +2833,11 @@ std::ostream& Catch::cout() {
 std::ostream& Catch::cerr() {
     return localErr;
 };
+#if defined(CATCH_VERSION_MAJOR) && CATCH_VERSION_MAJOR >= 2
+std::ostream& Catch::clog() {
+    return localErr;
+};
+#endif
 
 int main(int argc, char *argv[]) {
     MEL::Init(argc, argv);
@@ -0,0 +1,511 @@
+/*
+The MIT License(MIT)
+
+Copyright(c) 2016 Joss Whittle
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/// Micro-benchmarks of MEL against the raw MPI calls it wraps, and of the deep-copy paths against each other.
+///
+/// Build with  mpicxx -std=c++11 -O3 -I.. MEL-Benchmark.cpp -o MEL-Benchmark
+/// Run using   mpirun -n 4 ./MEL-Benchmark [max log2 bytes = 20] [iterations = 50] > bench.csv
+///
+/// Rank 0 writes one CSV row per measurement to stdout. Times are the mean time per iteration
+/// on the slowest rank, in microseconds.
+
+#define  MEL_IMPLEMENTATION
+#include "MEL.hpp"
+#include "MEL_deepcopy.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <algorithm>
+#include <unordered_map>
+#include <map>
+
+/// Synthetic deep structures
+
+struct ListNode {
+    int value;
+    ListNode *next;
+
+    ListNode() : value(0), next(nullptr) {};
+
+    template<typename MSG>
+    inline void DeepCopy(MSG &msg) {
+        msg.packPtr(next);
+    };
+};
+
+struct TreeNode {
+    int value;
+    TreeNode *left, *right;
+
+    TreeNode() : value(0), left(nullptr), right(nullptr) {};
+
+    template<typename MSG>
+    inline void DeepCopy(MSG &msg) {
+        msg.packPtr(left);
+        msg.packPtr(right);
+    };
+};
+
+struct DAGNode {
+    int value;
+    std::vector<DAGNode*> edges;
+
+    DAGNode() : value(0) {};
+
+    template<typename MSG>
+    inline void DeepCopy(MSG &msg) {
+        msg & edges;
+        for (auto &e : edges) msg.packSharedPtr(e);
+    };
+};
+
+struct WideElement {
+    std::vector<float> data;
+
+    template<typename MSG>
+    inline void DeepCopy(MSG &msg) {
+        msg & data;
+    };
+};
+
+inline ListNode* MakeList(const int numNodes) {
+    ListNode *head = nullptr;
+    for (int i = 0; i < numNodes; ++i) {
+        ListNode *node = MEL::MemConstruct<ListNode>();
+        node->value = i;
+        node->next  = head;
+        head = node;
+    }
+    return head;
+};
+
+inline void DestructList(ListNode *&head) {
+    while (head != nullptr) {
+        ListNode *next = head->next;
+        MEL::MemDestruct(head);
+        head = next;
+    }
+};
+
+inline TreeNode* MakeTree(const int numNodes) {
+    if (numNodes <= 0) return nullptr;
+    TreeNode *node = MEL::MemConstruct<TreeNode>();
+    node->value = numNodes;
+    node->left  = MakeTree((numNodes - 1) / 2);
+    node->right = MakeTree((numNodes - 1) - ((numNodes - 1) / 2));
+    return node;
+};
+
+inline void DestructTree(TreeNode *&node) {
+    if (node == nullptr) return;
+    DestructTree(node->left);
+    DestructTree(node->right);
+    MEL::MemDestruct(node);
+};
+
+/// A layered DAG where every node links to two nodes of the next layer, so most nodes are shared
+inline DAGNode* MakeDAG(const int numNodes) {
+    std::vector<DAGNode*> nodes(numNodes);
+    for (int i = 0; i < numNodes; ++i) {
+        nodes[i] = MEL::MemConstruct<DAGNode>();
+        nodes[i]->value = i;
+    }
+    for (int i = 0; i < numNodes; ++i) {
+        const int a = 2 * i + 1, b = 2 * i + 2;
+        if (a < numNodes) nodes[i]->edges.push_back(nodes[a]);
+        if (b < numNodes) nodes[i]->edges.push_back(nodes[b]);
+        if (a < numNodes && (i + 1) < numNodes) nodes[i + 1]->edges.push_back(nodes[a]);
+    }
+    return (numNodes > 0) ? nodes[0] : nullptr;
+};
+
+inline void CollectDAG(DAGNode *node, std::vector<DAGNode*> &visited, std::unordered_map<DAGNode*, bool> &seen) {
+    std::vector<DAGNode*> stack(1, node);
+    while (!stack.empty()) {
+        DAGNode *n = stack.back();
+        stack.pop_back();
+        if (n == nullptr || seen.count(n)) continue;
+        seen[n] = true;
+        visited.push_back(n);
+        for (auto e : n->edges) stack.push_back(e);
+    }
+};
+
+inline void DestructDAG(DAGNode *&root) {
+    std::vector<DAGNode*> nodes;
+    std::unordered_map<DAGNode*, bool> seen;
+    CollectDAG(root, nodes, seen);
+    for (auto n : nodes) MEL::MemDestruct(n);
+    root = nullptr;
+};
+
+inline std::vector<WideElement> MakeWide(const int numNodes) {
+    std::vector<WideElement> vec(numNodes);
+    for (int i = 0; i < numNodes; ++i) vec[i].data.assign(4, (float) i);
+    return vec;
+};
+
+/// Timing helpers
+
+struct Bench {
+    MEL::Comm comm;
+    int rank, size, iters;
+
+    /// Mean time per call of func on the slowest rank, after one untimed warm up call
+    template<typename F>
+    inline double time(F func) const {
+        MEL::Barrier(comm);
+        func();
+        MEL::Barrier(comm);
+
+        const double start = MEL::Wtime();
+        for (int i = 0; i < iters; ++i) func();
+        double local = (MEL::Wtime() - start) / (double) iters, global = 0.;
+
+        MEL::Allreduce(&local, &global, 1, MEL::Op::MAX, comm);
+        return global;
+    };
+
+    inline void row(const std::string &group, const std::string &name, const std::string &impl, const long long bytes, const int nodes, const double seconds) const {
+        if (rank != 0) return;
+        const double mbps = (seconds > 0.) ? ((double) bytes / (1024. * 1024.)) / seconds : 0.;
+        printf("%s,%s,%s,%d,%lld,%d,%d,%.3f,%.3f\n", group.c_str(), name.c_str(), impl.c_str(), size, bytes, nodes, iters, seconds * 1e6, mbps);
+        fflush(stdout);
+    };
+};
+
+/// Element-wise sum through a user defined op, so the OpCreate path is measured rather than MPI_SUM
+template<typename T>
+T BenchSum(T &a, T &b) {
+    return a + b;
+};
+
+/// Point-2-Point, ping-pong between ranks 0 and 1
+
+inline void BenchP2P(const Bench &b, const int maxLog) {
+    if (b.size < 2) return;
+    for (int lg = 0; lg <= maxLog; ++lg) {
+        const int bytes = 1 << lg;
+        std::vector<char> buf(bytes);
+
+        const double mel = b.time([&]() {
+            if (b.rank == 0) {
+                MEL::Send(&buf[0], bytes, 1, 0, b.comm);
+                MEL::Recv(&buf[0], bytes, 1, 0, b.comm);
+            }
+            else if (b.rank == 1) {
+                MEL::Recv(&buf[0], bytes, 0, 0, b.comm);
+                MEL::Send(&buf[0], bytes, 0, 0, b.comm);
+            }
+        });
+        b.row("p2p", "pingpong", "MEL", 2LL * bytes, 0, mel);
+
+        const double mpi = b.time([&]() {
+            if (b.rank == 0) {
+                MPI_Send(&buf[0], bytes, MPI_CHAR, 1, 0, (MPI_Comm) b.comm);
+                MPI_Recv(&buf[0], bytes, MPI_CHAR, 1, 0, (MPI_Comm) b.comm, MPI_STATUS_IGNORE);
+            }
+            else if (b.rank == 1) {
+                MPI_Recv(&buf[0], bytes, MPI_CHAR, 0, 0, (MPI_Comm) b.comm, MPI_STATUS_IGNORE);
+                MPI_Send(&buf[0], bytes, MPI_CHAR, 0, 0, (MPI_Comm) b.comm);
+            }
+        });
+        b.row("p2p", "pingpong", "MPI", 2LL * bytes, 0, mpi);
+    }
+};
+
+/// Collectives
+
+inline void BenchCollectives(const Bench &b, const int maxLog) {
+    MEL::Op customSum = MEL::OpCreate<float, BenchSum<float>>();
+
+    for (int lg = 2; lg <= maxLog; ++lg) {
+        const int bytes = 1 << lg, num = bytes / (int) sizeof(float);
+        std::vector<char>  buf(bytes);
+        std::vector<float> src(num, 1.f), dst(num);
+
+        b.row("collective", "bcast", "MEL", bytes, 0, b.time([&]() { MEL::Bcast(&buf[0], bytes, 0, b.comm); }));
+        b.row("collective", "bcast", "MPI", bytes, 0, b.time([&]() { MPI_Bcast(&buf[0], bytes, MPI_CHAR, 0, (MPI_Comm) b.comm); }));
+
+        b.row("collective", "allreduce", "MEL-SUM", bytes, 0, b.time([&]() { MEL::Allreduce(&src[0], &dst[0], num, MEL::Op::SUM, b.comm); }));
+        b.row("collective", "allreduce", "MEL-OpCreate", bytes, 0, b.time([&]() { MEL::Allreduce(&src[0], &dst[0], num, customSum, b.comm); }));
+        b.row("collective", "allreduce", "MPI-SUM", bytes, 0, b.time([&]() { MPI_Allreduce(&src[0], &dst[0], num, MPI_FLOAT, MPI_SUM, (MPI_Comm) b.comm); }));
+    }
+
+    MEL::OpFree(customSum);
+};
+
+/// Derived datatypes, building the same 2D sub array type each iteration with and without the datatype cache
+
+inline void BenchDatatypes(const Bench &b) {
+    b.row("datatype", "subarray2d", "MEL-Create", 0, 0, b.time([&]() {
+        MEL::Datatype dt = MEL::TypeCreateSubArray2D(MEL::Datatype::UNSIGNED_CHAR, 48, 16, 96, 32, 1024, 768);
+        MEL::TypeFree(dt);
+    }));
+    b.row("datatype", "subarray2d", "MEL-Cache", 0, 0, b.time([&]() {
+        MEL::Datatype dt = MEL::TypeCacheCreateSubArray2D(MEL::Datatype::UNSIGNED_CHAR, 48, 16, 96, 32, 1024, 768);
+        MEL::TypeCacheRelease(dt);
+    }));
+};
+
+/// RMA, every rank puts / gets to its right hand neighbour under a fence epoch
+
+inline void BenchRMA(const Bench &b, const int maxLog) {
+    const int maxBytes = 1 << maxLog;
+    char *winMem = MEL::MemAlloc<char>(maxBytes);
+    std::vector<char> buf(maxBytes);
+    MEL::Win win = MEL::WinCreate(winMem, maxBytes, b.comm);
+    const int target = (b.rank + 1) % b.size;
+
+    for (int lg = 0; lg <= maxLog; ++lg) {
+        const int bytes = 1 << lg;
+
+        b.row("rma", "put", "MEL", bytes, 0, b.time([&]() {
+            MEL::WinFence(win);
+            MEL::Put(&buf[0], bytes, MEL::Datatype::CHAR, 0, bytes, MEL::Datatype::CHAR, target, win);
+            MEL::WinFence(win);
+        }));
+        b.row("rma", "put", "MPI", bytes, 0, b.time([&]() {
+            MPI_Win_fence(0, (MPI_Win) win);
+            MPI_Put(&buf[0], bytes, MPI_CHAR, target, 0, bytes, MPI_CHAR, (MPI_Win) win);
+            MPI_Win_fence(0, (MPI_Win) win);
+        }));
+        b.row("rma", "get", "MEL", bytes, 0, b.time([&]() {
+            MEL::WinFence(win);
+            MEL::Get(&buf[0], bytes, MEL::Datatype::CHAR, 0, bytes, MEL::Datatype::CHAR, target, win);
+            MEL::WinFence(win);
+        }));
+        b.row("rma", "get", "MPI", bytes, 0, b.time([&]() {
+            MPI_Win_fence(0, (MPI_Win) win);
+            MPI_Get(&buf[0], bytes, MPI_CHAR, target, 0, bytes, MPI_CHAR, (MPI_Win) win);
+            MPI_Win_fence(0, (MPI_Win) win);
+        }));
+    }
+
+    MEL::WinFree(win);
+    MEL::MemFree(winMem);
+};
+
+/// Mutex / Shared array lock contention, every rank repeatedly takes the same lock
+
+inline void BenchLocks(const Bench &b, const int maxLog) {
+    MEL::Mutex mutex = MEL::MutexCreate(0, b.comm);
+    b.row("lock", "mutex", "MEL", 0, 0, b.time([&]() {
+        MEL::MutexLock(mutex);
+        MEL::MutexUnlock(mutex);
+    }));
+    MEL::MutexFree(mutex);
+
+    for (int lg = 2; lg <= maxLog; lg += 2) {
+        const int bytes = 1 << lg, num = bytes / (int) sizeof(int);
+        MEL::Shared<int> shared = MEL::SharedCreate<int>(num, 0, b.comm);
+        b.row("lock", "shared", "MEL", bytes, 0, b.time([&]() {
+            MEL::SharedLock(shared);
+            shared[0] += 1;
+            MEL::SharedUnlock(shared);
+        }));
+        MEL::SharedFree(shared);
+    }
+};
+
+/// Deep copy, Send vs BufferedSend (rank 0 to rank 1) and Bcast vs BufferedBcast, for each structure
+
+template<typename P, typename MAKE, typename FREE>
+inline void BenchDeepPtr(const Bench &b, const std::string &name, const int numNodes, MAKE make, FREE destruct) {
+    P root = (b.rank == 0) ? make(numNodes) : nullptr;
+    long long bytes = (b.rank == 0) ? MEL::Deep::BufferSize(root) : 0;
+    MEL::Bcast(&bytes, 1, 0, b.comm);
+
+    std::vector<P> received;
+    if (b.size > 1) {
+        b.row("deep", name, "Send", bytes, numNodes, b.time([&]() {
+            if (b.rank == 0) MEL::Deep::Send(root, 1, 0, b.comm);
+            else if (b.rank == 1) {
+                P ptr = nullptr;
+                MEL::Deep::Recv(ptr, 0, 0, b.comm);
+                received.push_back(ptr);
+            }
+        }));
+        b.row("deep", name, "BufferedSend", bytes, numNodes, b.time([&]() {
+            if (b.rank == 0) MEL::Deep::BufferedSend(root, 1, 0, b.comm);
+            else if (b.rank == 1) {
+                P ptr = nullptr;
+                MEL::Deep::BufferedRecv(ptr, 0, 0, b.comm);
+                received.push_back(ptr);
+            }
+        }));
+
+        /// Same transfer from bytes packed once, outside of the timed region
+        MEL::Deep::PackedMessage packed;
+        if (b.rank == 0) MEL::Deep::Pack(root, packed);
+        b.row("deep", name, "PackedSend", bytes, numNodes, b.time([&]() {
+            if (b.rank == 0) MEL::Deep::Send(packed, 1, 0, b.comm);
+            else if (b.rank == 1) {
+                P ptr = nullptr;
+                MEL::Deep::BufferedRecv(ptr, 0, 0, b.comm);
+                received.push_back(ptr);
+            }
+        }));
+
+        /// Same transfer with pointers visited level by level, one chunk per type and level
+        MEL::Deep::GetTraversalConfig().breadthFirst = true;
+        b.row("deep", name, "Send-BreadthFirst", bytes, numNodes, b.time([&]() {
+            if (b.rank == 0) MEL::Deep::Send(root, 1, 0, b.comm);
+            else if (b.rank == 1) {
+                P ptr = nullptr;
+                MEL::Deep::Recv(ptr, 0, 0, b.comm);
+                received.push_back(ptr);
+            }
+        }));
+        MEL::Deep::GetTraversalConfig().breadthFirst = false;
+
+        /// Same transfer driven from an explicit worklist instead of recursion
+        MEL::Deep::GetTraversalConfig().iterative = true;
+        b.row("deep", name, "Send-Iterative", bytes, numNodes, b.time([&]() {
+            if (b.rank == 0) MEL::Deep::Send(root, 1, 0, b.comm);
+            else if (b.rank == 1) {
+                P ptr = nullptr;
+                MEL::Deep::Recv(ptr, 0, 0, b.comm);
+                received.push_back(ptr);
+            }
+        }));
+        MEL::Deep::GetTraversalConfig().iterative = false;
+    }
+    b.row("deep", name, "Bcast", bytes, numNodes, b.time([&]() {
+        P ptr = root;
+        MEL::Deep::Bcast(ptr, 0, b.comm);
+        if (b.rank != 0) received.push_back(ptr);
+    }));
+    b.row("deep", name, "BufferedBcast", bytes, numNodes, b.time([&]() {
+        P ptr = root;
+        MEL::Deep::BufferedBcast(ptr, 0, b.comm);
+        if (b.rank != 0) received.push_back(ptr);
+    }));
+
+    /// Received copies are freed outside of the timed region
+    for (auto &ptr : received) destruct(ptr);
+    if (b.rank == 0) destruct(root);
+};
+
+inline void BenchDeepWide(const Bench &b, const int numNodes) {
+    std::vector<WideElement> vec;
+    if (b.rank == 0) vec = MakeWide(numNodes);
+    long long bytes = (b.rank == 0) ? MEL::Deep::BufferSize(vec) : 0;
+    MEL::Bcast(&bytes, 1, 0, b.comm);
+
+    if (b.size > 1) {
+        b.row("deep", "wide", "Send", bytes, numNodes, b.time([&]() {
+            if (b.rank == 0) MEL::Deep::Send(vec, 1, 0, b.comm);
+            else if (b.rank == 1) MEL::Deep::Recv(vec, 0, 0, b.comm);
+        }));
+        b.row("deep", "wide", "BufferedSend", bytes, numNodes, b.time([&]() {
+            if (b.rank == 0) MEL::Deep::BufferedSend(vec, 1, 0, b.comm);
+            else if (b.rank == 1) MEL::Deep::BufferedRecv(vec, 0, 0, b.comm);
+        }));
+
+        /// Same transfer received over the previous iteration's vector and element buffers
+        MEL::Deep::GetTraversalConfig().inPlace = true;
+        b.row("deep", "wide", "Send-InPlace", bytes, numNodes, b.time([&]() {
+            if (b.rank == 0) MEL::Deep::Send(vec, 1, 0, b.comm);
+            else if (b.rank == 1) MEL::Deep::Recv(vec, 0, 0, b.comm);
+        }));
+        MEL::Deep::GetTraversalConfig().inPlace = false;
+    }
+    b.row("deep", "wide", "Bcast", bytes, numNodes, b.time([&]() { MEL::Deep::Bcast(vec, 0, b.comm); }));
+    b.row("deep", "wide", "BufferedBcast", bytes, numNodes, b.time([&]() { MEL::Deep::BufferedBcast(vec, 0, b.comm); }));
+
+    /// Every other rank returns its copy at once, received by rank 0 in completion order as a task farm would
+    if (b.size > 1) {
+        b.row("deep", "wide", "Gather-RecvAny", bytes * (b.size - 1), numNodes, b.time([&]() {
+            if (b.rank == 0) {
+                std::vector<WideElement> result;
+                for (int i = 1; i < b.size; ++i) MEL::Deep::RecvAny(result, 0, b.comm);
+            }
+            else MEL::Deep::Send(vec, 0, 0, b.comm);
+        }));
+    }
+};
+
+/// Associative containers travel as key and value arrays and are rebuilt by hinted insertion
+
+template<typename M>
+inline void BenchDeepMap(const Bench &b, const std::string &name, const int numNodes) {
+    M map;
+    if (b.rank == 0) for (int i = 0; i < numNodes; ++i) map[i] = (double) i;
+    long long bytes = (b.rank == 0) ? MEL::Deep::BufferSize(map) : 0;
+    MEL::Bcast(&bytes, 1, 0, b.comm);
+
+    if (b.size > 1) {
+        b.row("deep", name, "Send", bytes, numNodes, b.time([&]() {
+            if (b.rank == 0) MEL::Deep::Send(map, 1, 0, b.comm);
+            else if (b.rank == 1) MEL::Deep::Recv(map, 0, 0, b.comm);
+        }));
+    }
+    b.row("deep", name, "Bcast", bytes, numNodes, b.time([&]() { MEL::Deep::Bcast(map, 0, b.comm); }));
+    b.row("deep", name, "BufferedBcast", bytes, numNodes, b.time([&]() { MEL::Deep::BufferedBcast(map, 0, b.comm); }));
+
+    /// Every rank holds the same keys, so the merged map keeps its size from one iteration to the next
+    b.row("deep", name, "Allreduce", bytes, numNodes, b.time([&]() {
+        MEL::Deep::Allreduce(map, [](M &into, M &from) { for (auto &e : from) into[e.first] += e.second; }, b.comm);
+    }));
+};
+
+inline void BenchDeep(const Bench &b, const int maxLog) {
+    /// Node counts are kept below the byte sweep as each node is several bytes and lists recurse once per node
+    const int maxNodesLog = std::min(maxLog - 4, 14);
+    for (int lg = 4; lg <= maxNodesLog; lg += 2) {
+        const int numNodes = 1 << lg;
+        BenchDeepPtr<ListNode*>(b, "list", numNodes, MakeList, DestructList);
+        BenchDeepPtr<TreeNode*>(b, "tree", numNodes, MakeTree, DestructTree);
+        BenchDeepPtr<DAGNode*>(b, "dag", numNodes, MakeDAG, DestructDAG);
+        BenchDeepWide(b, numNodes);
+        BenchDeepMap<std::map<int, double>>(b, "map", numNodes);
+        BenchDeepMap<std::unordered_map<int, double>>(b, "unordered_map", numNodes);
+    }
+};
+
+int main(int argc, char *argv[]) {
+    MEL::Init(argc, argv);
+
+    Bench b;
+    b.comm  = MEL::Comm::WORLD;
+    b.rank  = MEL::CommRank(b.comm);
+    b.size  = MEL::CommSize(b.comm);
+    b.iters = (argc > 2) ? std::stoi(argv[2]) : 50;
+    const int maxLog = (argc > 1) ? std::stoi(argv[1]) : 20;
+
+    if (b.rank == 0) printf("group,benchmark,impl,ranks,bytes,nodes,iterations,time_us,MB_per_s\n");
+
+    BenchP2P(b, maxLog);
+    BenchCollectives(b, maxLog);
+    BenchDatatypes(b);
+    BenchRMA(b, maxLog);
+    BenchLocks(b, maxLog);
+    BenchDeep(b, maxLog);
+
+    MEL::Finalize();
+    return 0;
+}